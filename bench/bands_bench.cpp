@@ -0,0 +1,40 @@
+// Volume and price band calculators over consolidated views with the
+// services' default bands. Arguments: depth per exchange, exchange count.
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "hermeneutic/price_bands/price_bands_publisher.hpp"
+#include "hermeneutic/volume_bands/volume_bands_publisher.hpp"
+#include "synthetic_books.hpp"
+
+namespace {
+
+namespace bench = hermeneutic::bench;
+
+const auto kDepthsByExchanges = std::vector<std::vector<std::int64_t>>{{10, 100, 1000}, {1, 3, 8}};
+
+void BM_VolumeBands(benchmark::State& state) {
+  const auto view =
+      bench::makeView(static_cast<std::size_t>(state.range(1)), static_cast<std::size_t>(state.range(0)));
+  const hermeneutic::volume_bands::VolumeBandsCalculator calculator(hermeneutic::volume_bands::defaultThresholds());
+  for (auto _ : state) {
+    auto quotes = calculator.compute(view);
+    benchmark::DoNotOptimize(quotes.data());
+  }
+}
+BENCHMARK(BM_VolumeBands)->ArgsProduct(kDepthsByExchanges);
+
+void BM_PriceBands(benchmark::State& state) {
+  const auto view =
+      bench::makeView(static_cast<std::size_t>(state.range(1)), static_cast<std::size_t>(state.range(0)));
+  const hermeneutic::price_bands::PriceBandsCalculator calculator(hermeneutic::price_bands::defaultOffsets());
+  for (auto _ : state) {
+    auto quotes = calculator.compute(view);
+    benchmark::DoNotOptimize(quotes.data());
+  }
+}
+BENCHMARK(BM_PriceBands)->ArgsProduct(kDepthsByExchanges);
+
+}  // namespace
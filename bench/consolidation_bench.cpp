@@ -0,0 +1,76 @@
+// Cross-exchange consolidation: folding level deltas into ConsolidatedBook,
+// materialising and uncrossing the ladder (the work behind each published
+// AggregationEngine view), and virtualUncross on its own.
+// Arguments: depth per exchange, exchange count.
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "hermeneutic/aggregator/consolidated_book.hpp"
+#include "synthetic_books.hpp"
+
+namespace {
+
+namespace bench = hermeneutic::bench;
+using hermeneutic::common::PriceLevel;
+
+const auto kDepthsByExchanges = std::vector<std::vector<std::int64_t>>{{10, 100, 1000}, {1, 3, 8}};
+
+// One level of one exchange changes and changes back.
+void BM_ConsolidatedBookApply(benchmark::State& state) {
+  const auto depth = static_cast<std::size_t>(state.range(0));
+  const auto exchanges = static_cast<std::size_t>(state.range(1));
+  auto consolidated = bench::makeConsolidated(exchanges, depth);
+  hermeneutic::lob::LevelDelta up{hermeneutic::common::Side::Bid, bench::ticks(bench::kMidTicks - 1),
+                                  hermeneutic::common::Decimal::fromInteger(1),
+                                  hermeneutic::common::Decimal::fromInteger(2)};
+  auto down = up;
+  std::swap(down.previous_quantity, down.quantity);
+  for (auto _ : state) {
+    consolidated.apply(up);
+    consolidated.apply(down);
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_ConsolidatedBookApply)->ArgsProduct(kDepthsByExchanges);
+
+void BM_Consolidate(benchmark::State& state) {
+  const auto depth = static_cast<std::size_t>(state.range(0));
+  const auto exchanges = static_cast<std::size_t>(state.range(1));
+  const auto consolidated = bench::makeConsolidated(exchanges, depth);
+  std::vector<PriceLevel> bids;
+  std::vector<PriceLevel> asks;
+  for (auto _ : state) {
+    consolidated.materialize(bids, asks);
+    hermeneutic::aggregator::virtualUncross(bids, asks);
+    benchmark::DoNotOptimize(bids.data());
+    benchmark::DoNotOptimize(asks.data());
+  }
+  state.counters["levels"] = static_cast<double>(bids.size() + asks.size());
+}
+BENCHMARK(BM_Consolidate)->ArgsProduct(kDepthsByExchanges);
+
+// Exchanges three ticks apart, so each neighbour crosses the last by a few
+// levels. The ladders are recopied outside the timed region every time.
+void BM_VirtualUncross(benchmark::State& state) {
+  const auto depth = static_cast<std::size_t>(state.range(0));
+  const auto exchanges = static_cast<std::size_t>(state.range(1));
+  const auto consolidated = bench::makeConsolidated(exchanges, depth, 3);
+  std::vector<PriceLevel> source_bids;
+  std::vector<PriceLevel> source_asks;
+  consolidated.materialize(source_bids, source_asks);
+  std::vector<PriceLevel> bids;
+  std::vector<PriceLevel> asks;
+  for (auto _ : state) {
+    state.PauseTiming();
+    bids = source_bids;
+    asks = source_asks;
+    state.ResumeTiming();
+    hermeneutic::aggregator::virtualUncross(bids, asks);
+    benchmark::DoNotOptimize(bids.data());
+  }
+}
+BENCHMARK(BM_VirtualUncross)->ArgsProduct(kDepthsByExchanges);
+
+}  // namespace
@@ -0,0 +1,68 @@
+// Decimal parsing, formatting and arithmetic for each backend. All three
+// backends are templates, so one binary covers them whichever one the
+// build selected as the default.
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <string_view>
+
+#include "hermeneutic/common/decimal.hpp"
+
+namespace {
+
+using hermeneutic::common::DecimalDouble;
+using hermeneutic::common::DecimalInt128;
+using hermeneutic::common::DecimalWide;
+
+constexpr std::string_view kPrice = "67234.12345678";
+constexpr std::string_view kQuantity = "0.00421337";
+
+template <typename D>
+void BM_DecimalFromString(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(D::fromString(kPrice));
+  }
+}
+
+template <typename D>
+void BM_DecimalToString(benchmark::State& state) {
+  const auto value = D::fromString(kPrice);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(value.toString(8));
+  }
+}
+
+template <typename D>
+void BM_DecimalMultiply(benchmark::State& state) {
+  auto price = D::fromString(kPrice);
+  const auto quantity = D::fromString(kQuantity);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(price);
+    benchmark::DoNotOptimize(price * quantity);
+  }
+}
+
+template <typename D>
+void BM_DecimalDivide(benchmark::State& state) {
+  auto notional = D::fromString("250000.5");
+  const auto price = D::fromString(kPrice);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(notional);
+    benchmark::DoNotOptimize(notional / price);
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_DecimalFromString, DecimalInt128);
+BENCHMARK_TEMPLATE(BM_DecimalFromString, DecimalWide);
+BENCHMARK_TEMPLATE(BM_DecimalFromString, DecimalDouble);
+BENCHMARK_TEMPLATE(BM_DecimalToString, DecimalInt128);
+BENCHMARK_TEMPLATE(BM_DecimalToString, DecimalWide);
+BENCHMARK_TEMPLATE(BM_DecimalToString, DecimalDouble);
+BENCHMARK_TEMPLATE(BM_DecimalMultiply, DecimalInt128);
+BENCHMARK_TEMPLATE(BM_DecimalMultiply, DecimalWide);
+BENCHMARK_TEMPLATE(BM_DecimalMultiply, DecimalDouble);
+BENCHMARK_TEMPLATE(BM_DecimalDivide, DecimalInt128);
+BENCHMARK_TEMPLATE(BM_DecimalDivide, DecimalWide);
+BENCHMARK_TEMPLATE(BM_DecimalDivide, DecimalDouble);
+
+}  // namespace
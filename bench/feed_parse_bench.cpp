@@ -0,0 +1,77 @@
+// Single-core throughput of the cex_type1 feed parser over data/*.ndjson.
+//
+//   feed_parse_bench [iterations] [data_dir]
+//
+// Every message is copied once into its own padded buffer up front, the way
+// frames sit in the feed's receive buffer, so the timed loop measures only
+// FeedParser::parse.
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "hermeneutic/cex_type1/feed_parser.hpp"
+
+namespace {
+
+struct Message {
+  std::vector<char> buffer;
+  std::size_t length{0};
+};
+
+std::vector<Message> loadMessages(const std::filesystem::path& dir) {
+  std::vector<Message> messages;
+  for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+    if (entry.path().extension() != ".ndjson") {
+      continue;
+    }
+    std::ifstream input(entry.path());
+    std::string line;
+    while (std::getline(input, line)) {
+      if (line.empty()) {
+        continue;
+      }
+      Message message;
+      message.length = line.size();
+      message.buffer.assign(line.begin(), line.end());
+      message.buffer.resize(line.size() + hermeneutic::cex_type1::FeedParser::kPadding, '\0');
+      messages.push_back(std::move(message));
+    }
+  }
+  return messages;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int iterations = argc > 1 ? std::atoi(argv[1]) : 2000;
+  const std::filesystem::path dir = argc > 2 ? argv[2] : std::filesystem::path(PROJECT_SOURCE_DIR) / "data";
+
+  const auto messages = loadMessages(dir);
+  if (messages.empty()) {
+    std::cerr << "no .ndjson messages under " << dir << std::endl;
+    return 1;
+  }
+
+  hermeneutic::cex_type1::FeedParser parser("bench");
+  hermeneutic::common::BookEvent event;
+  std::uint64_t parsed = 0;
+  std::uint64_t bytes = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    for (const auto& message : messages) {
+      parsed += parser.parse(message.buffer.data(), message.length, 0, event) ? 1 : 0;
+      bytes += message.length;
+    }
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  std::cout << "messages: " << parsed << " in " << elapsed.count() << " s\n"
+            << "messages/sec/core: " << static_cast<double>(parsed) / elapsed.count() << "\n"
+            << "MB/sec/core: " << static_cast<double>(bytes) / elapsed.count() / 1e6 << std::endl;
+  return 0;
+}
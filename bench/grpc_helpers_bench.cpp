@@ -0,0 +1,40 @@
+// Book (de)serialisation between AggregatedBookView and the proto messages
+// for both wire encodings. Arguments: depth per exchange, encoding
+// (0 = decimal strings, 1 = fixed point); three exchanges throughout.
+#include <benchmark/benchmark.h>
+
+#include "services/common/grpc_helpers.hpp"
+#include "synthetic_books.hpp"
+
+namespace {
+
+namespace bench = hermeneutic::bench;
+namespace helpers = hermeneutic::services::grpc_helpers;
+
+hermeneutic::grpc::BookEncoding encodingFor(const benchmark::State& state) {
+  return state.range(1) == 0 ? hermeneutic::grpc::BOOK_ENCODING_DECIMAL_STRING
+                             : hermeneutic::grpc::BOOK_ENCODING_FIXED_POINT;
+}
+
+void BM_FromDomain(benchmark::State& state) {
+  const auto view = bench::makeView(3, static_cast<std::size_t>(state.range(0)));
+  const auto encoding = encodingFor(state);
+  for (auto _ : state) {
+    auto message = helpers::FromDomain(view, encoding);
+    benchmark::DoNotOptimize(message);
+  }
+  state.counters["bytes"] = static_cast<double>(helpers::FromDomain(view, encoding).ByteSizeLong());
+}
+BENCHMARK(BM_FromDomain)->ArgsProduct({{10, 100, 1000}, {0, 1}});
+
+void BM_ToDomain(benchmark::State& state) {
+  const auto message =
+      helpers::FromDomain(bench::makeView(3, static_cast<std::size_t>(state.range(0))), encodingFor(state));
+  for (auto _ : state) {
+    auto view = helpers::ToDomain(message);
+    benchmark::DoNotOptimize(view.bid_levels.data());
+  }
+}
+BENCHMARK(BM_ToDomain)->ArgsProduct({{10, 100, 1000}, {0, 1}});
+
+}  // namespace
@@ -0,0 +1,200 @@
+// Replays a binary event journal (hermeneutic::journal) into an
+// AggregationEngine, for deterministic regression runs and backtests.
+//
+//   journal_replay <journal dir|segment> [--pace max|recorded] [--speed x]
+//                  [--config aggregator.json] [--max-batch n]
+//
+// `max` pushes events as fast as the engine accepts them and reports
+// events per second from the first push until the last event has been
+// applied. `recorded` sleeps to reproduce the gaps between the events'
+// local receive times, divided by --speed. --config gives the engine the
+// aggregator service's expected exchanges, book options, queue and publish
+// settings; otherwise it runs on a bounded lock-free queue with no
+// publish interval. Each symbol's final book is printed at the end.
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <spdlog/spdlog.h>
+#include <vector>
+
+#include "hermeneutic/aggregator/aggregator.hpp"
+#include "hermeneutic/aggregator/config.hpp"
+#include "hermeneutic/journal/reader.hpp"
+
+namespace {
+
+using hermeneutic::common::BookEvent;
+using Clock = std::chrono::steady_clock;
+
+// Applied after every journaled event; its publish marks the end of the run.
+// It carries one level so its top of book changes even when the engine only
+// publishes on BBO changes.
+constexpr const char* kEndMarker = "__journal_replay_end";
+
+struct Options {
+  std::string journal;
+  bool recorded{false};
+  double speed{1.0};
+  std::string config;
+  std::optional<std::size_t> max_batch;
+};
+
+void usage() {
+  std::cerr << "usage: journal_replay <journal dir|segment> [--pace max|recorded] [--speed x]\n"
+               "                      [--config aggregator.json] [--max-batch n]\n";
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+  if (argc < 2 || (argc - 2) % 2 != 0) {
+    return false;
+  }
+  options.journal = argv[1];
+  for (int i = 2; i + 1 < argc; i += 2) {
+    const std::string key = argv[i];
+    const std::string value = argv[i + 1];
+    if (key == "--pace" && (value == "max" || value == "recorded")) {
+      options.recorded = value == "recorded";
+    } else if (key == "--speed") {
+      options.speed = std::stod(value);
+    } else if (key == "--config") {
+      options.config = value;
+    } else if (key == "--max-batch") {
+      options.max_batch = std::stoul(value);
+    } else {
+      std::cerr << "bad option " << key << ' ' << value << std::endl;
+      return false;
+    }
+  }
+  return options.speed > 0 && options.max_batch.value_or(1) > 0;
+}
+
+std::unique_ptr<hermeneutic::aggregator::AggregationEngine> makeEngine(const Options& options) {
+  using hermeneutic::aggregator::AggregationEngine;
+  hermeneutic::aggregator::PublishOptions publish{.max_batch = 64};
+  std::unique_ptr<AggregationEngine> engine;
+  if (options.config.empty()) {
+    engine = std::make_unique<AggregationEngine>(
+        hermeneutic::common::QueueOptions{.kind = hermeneutic::common::QueueKind::LockFree});
+  } else {
+    const auto config = hermeneutic::aggregator::loadAggregatorConfig(options.config);
+    engine = std::make_unique<AggregationEngine>(config.queue);
+    for (const auto& symbol : config.symbols()) {
+      std::vector<std::string> expected;
+      for (const auto& feed : config.feeds) {
+        if (feed.symbol == symbol) {
+          expected.push_back(feed.name);
+          engine->setBookOptions(symbol, feed.name, feed.book);
+        }
+      }
+      engine->setExpectedExchanges(symbol, std::move(expected));
+    }
+    publish = {
+        .interval = config.publish_interval,
+        .bbo_changes_only = config.publish_on_bbo_change,
+        .max_batch = config.max_batch_events,
+    };
+  }
+  if (options.max_batch) {
+    publish.max_batch = *options.max_batch;
+  }
+  engine->setPublishOptions(publish);
+  return engine;
+}
+
+std::int64_t eventTime(const BookEvent& event) {
+  return event.local_timestamp_ns != 0 ? event.local_timestamp_ns : event.feed_timestamp_ns;
+}
+
+int run(const Options& options) {
+  hermeneutic::journal::JournalReader reader(options.journal);
+  auto engine = makeEngine(options);
+
+  std::mutex mutex;
+  std::condition_variable done;
+  bool finished = false;
+  engine->subscribe(kEndMarker, [&](const hermeneutic::aggregator::BookSnapshot&) {
+    std::lock_guard<std::mutex> lock(mutex);
+    finished = true;
+    done.notify_all();
+  });
+  std::atomic<std::uint64_t> publishes{0};
+  std::size_t subscribed = 0;
+  engine->start();
+
+  BookEvent event;
+  std::int64_t first_time = 0;
+  const auto start = Clock::now();
+  while (reader.next(event)) {
+    // Subscribe as symbols appear, so the run pays for building and
+    // publishing views like the service does.
+    for (; subscribed < reader.symbols().size(); ++subscribed) {
+      engine->subscribe(reader.symbols()[subscribed], [&](const hermeneutic::aggregator::BookSnapshot&) {
+        publishes.fetch_add(1, std::memory_order_relaxed);
+      });
+    }
+    if (options.recorded) {
+      if (first_time == 0) {
+        first_time = eventTime(event);
+      }
+      const auto offset = static_cast<double>(eventTime(event) - first_time) / options.speed;
+      std::this_thread::sleep_until(start + std::chrono::nanoseconds(static_cast<std::int64_t>(offset)));
+    }
+    engine->push(event);
+  }
+
+  BookEvent marker;
+  marker.exchange = kEndMarker;
+  marker.symbol = kEndMarker;
+  marker.kind = hermeneutic::common::BookEventKind::Snapshot;
+  marker.snapshot.bids.push_back(
+      {hermeneutic::common::Decimal::fromInteger(1), hermeneutic::common::Decimal::fromInteger(1)});
+  engine->push(std::move(marker));
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] { return finished; });
+  }
+  const auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  engine->stop();
+
+  const auto events = reader.eventsRead();
+  std::printf("%llu events from %zu segment(s) in %.3f s = %.2f M events/s (%s pace), %llu publishes\n",
+              static_cast<unsigned long long>(events), reader.segments().size(), elapsed,
+              static_cast<double>(events) / elapsed / 1e6, options.recorded ? "recorded" : "max",
+              static_cast<unsigned long long>(publishes.load()));
+  for (const auto& symbol : reader.symbols()) {
+    const auto view = engine->latest(symbol);
+    std::printf("%s: %zu exchanges, %zu bid / %zu ask levels, best bid %s x %s, best ask %s x %s\n",
+                symbol.empty() ? "(default)" : symbol.c_str(), view.exchange_count, view.bid_levels.size(),
+                view.ask_levels.size(), view.best_bid.price.toString(8).c_str(),
+                view.best_bid.quantity.toString(8).c_str(), view.best_ask.price.toString(8).c_str(),
+                view.best_ask.quantity.toString(8).c_str());
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  try {
+    if (!parseOptions(argc, argv, options)) {
+      usage();
+      return 1;
+    }
+    // Debug-assert builds trace every book event through spdlog, which
+    // would swamp both the timing and the report.
+    spdlog::set_level(spdlog::level::off);
+    return run(options);
+  } catch (const std::exception& ex) {
+    std::cerr << "journal_replay failed: " << ex.what() << std::endl;
+    return 1;
+  }
+}
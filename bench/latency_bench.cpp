@@ -0,0 +1,451 @@
+// End-to-end latency of the feed -> aggregator -> subscriber pipeline.
+//
+//   latency_bench inproc [--rate msgs/s] [--exchanges n] [--duration s] [--warmup s]
+//                        [--publish-interval-ms ms] [--max-batch n] [--feed-threads n]
+//                        [--symbol s] [--json path]
+//   latency_bench client --endpoint host:port [--token t] [--symbol s]
+//                        [--duration s] [--warmup s] [--json path]
+//
+// `inproc` runs everything in this process over real sockets: a WebSocket
+// mock per exchange streaming a snapshot and then new/cancel flow at the
+// requested aggregate rate, the cex_type1 feeds, an AggregationEngine, the
+// gRPC service and a BookStreamClient. `client` only subscribes, against an
+// aggregator_service fed by `cex_type1_service --stamp` (see
+// scripts/run_latency_stack.sh).
+//
+// Every book whose newest feed timestamp moved is split into stages using
+// the timestamps the pipeline already carries, all on the system clock:
+//   feed->receive     local receipt - exchange send stamp (wire + parse)
+//   receive->publish  snapshot build - local receipt (queue, apply, consolidate)
+//   publish->client   subscriber callback - snapshot build (fanout, gRPC, mirror)
+//   end-to-end        subscriber callback - exchange send stamp
+// Feeds without a send stamp fall back to the receipt time, which makes
+// feed->receive read zero.
+#include <Poco/Net/HTTPRequestHandler.h>
+#include <Poco/Net/HTTPRequestHandlerFactory.h>
+#include <Poco/Net/HTTPServer.h>
+#include <Poco/Net/HTTPServerParams.h>
+#include <Poco/Net/HTTPServerRequest.h>
+#include <Poco/Net/HTTPServerResponse.h>
+#include <Poco/Net/ServerSocket.h>
+#include <Poco/Net/SocketAddress.h>
+#include <Poco/Net/WebSocket.h>
+#include <Poco/Timespan.h>
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+
+#include "common/book_stream_client.hpp"
+#include "hermeneutic/aggregator/aggregator.hpp"
+#include "hermeneutic/aggregator/grpc_service.hpp"
+#include "hermeneutic/cex_type1/feed.hpp"
+#include "hermeneutic/cex_type1/feed_reactor.hpp"
+#include "latency_histogram.hpp"
+#include "services/cex_type1_service/replay.hpp"
+
+namespace {
+
+using hermeneutic::bench::LatencyHistogram;
+using Clock = std::chrono::steady_clock;
+
+constexpr const char* kMockToken = "latency-token";
+
+std::int64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+struct Options {
+  std::string mode;
+  double rate{10'000.0};
+  std::size_t exchanges{3};
+  double duration_s{10.0};
+  double warmup_s{2.0};
+  int publish_interval_ms{0};
+  std::size_t max_batch{64};
+  std::size_t feed_threads{0};
+  std::string symbol{"BTCUSDT"};
+  std::string endpoint;
+  std::string token;
+  std::string json_path;
+};
+
+void usage() {
+  std::cerr << "usage: latency_bench inproc [--rate msgs/s] [--exchanges n] [--duration s] [--warmup s]\n"
+               "                            [--publish-interval-ms ms] [--max-batch n] [--feed-threads n]\n"
+               "                            [--symbol s] [--json path]\n"
+               "       latency_bench client --endpoint host:port [--token t] [--symbol s]\n"
+               "                            [--duration s] [--warmup s] [--json path]\n";
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+  if (argc < 2) {
+    return false;
+  }
+  options.mode = argv[1];
+  if (options.mode != "inproc" && options.mode != "client") {
+    return false;
+  }
+  for (int i = 2; i < argc; i += 2) {
+    const std::string key = argv[i];
+    if (i + 1 >= argc) {
+      std::cerr << "missing value for " << key << std::endl;
+      return false;
+    }
+    const std::string value = argv[i + 1];
+    if (key == "--rate") {
+      options.rate = std::stod(value);
+    } else if (key == "--exchanges") {
+      options.exchanges = std::stoul(value);
+    } else if (key == "--duration") {
+      options.duration_s = std::stod(value);
+    } else if (key == "--warmup") {
+      options.warmup_s = std::stod(value);
+    } else if (key == "--publish-interval-ms") {
+      options.publish_interval_ms = std::stoi(value);
+    } else if (key == "--max-batch") {
+      options.max_batch = std::stoul(value);
+    } else if (key == "--feed-threads") {
+      options.feed_threads = std::stoul(value);
+    } else if (key == "--symbol") {
+      options.symbol = value;
+    } else if (key == "--endpoint") {
+      options.endpoint = value;
+    } else if (key == "--token") {
+      options.token = value;
+    } else if (key == "--json") {
+      options.json_path = value;
+    } else {
+      std::cerr << "unknown option " << key << std::endl;
+      return false;
+    }
+  }
+  if (options.mode == "client" && options.endpoint.empty()) {
+    std::cerr << "client mode needs --endpoint" << std::endl;
+    return false;
+  }
+  if (options.rate <= 0 || options.exchanges == 0 || options.max_batch == 0 || options.duration_s <= 0) {
+    std::cerr << "--rate, --exchanges, --max-batch and --duration must be positive" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// Order flow for one mock exchange: a snapshot, then new orders a few ticks
+// either side of 100.00 with every other message cancelling the oldest
+// resting order, so each message moves the consolidated book.
+class FlowGenerator {
+ public:
+  std::string snapshot() {
+    std::string frame = R"({"type":"snapshot","sequence":)" + std::to_string(++sequence_) + R"(,"bids":[)";
+    for (int level = 1; level <= 10; ++level) {
+      frame += (level == 1 ? "" : ",");
+      frame += R"({"price":")" + price(kMid - level * kLevelGap) + R"(","quantity":"10"})";
+    }
+    frame += R"(],"asks":[)";
+    for (int level = 1; level <= 10; ++level) {
+      frame += (level == 1 ? "" : ",");
+      frame += R"({"price":")" + price(kMid + level * kLevelGap) + R"(","quantity":"10"})";
+    }
+    return frame + "]}";
+  }
+
+  std::string next() {
+    ++sequence_;
+    if (!resting_.empty() && (sequence_ % 2 == 0 || resting_.size() >= 64)) {
+      const auto id = resting_.front();
+      resting_.pop_front();
+      return R"({"type":"cancel_order","sequence":)" + std::to_string(sequence_) + R"(,"order_id":)" +
+             std::to_string(id) + "}";
+    }
+    const auto id = next_id_++;
+    resting_.push_back(id);
+    const bool bid = id % 2 == 0;
+    const auto offset = static_cast<int>(id % 5) + 1;
+    return R"({"type":"new_order","sequence":)" + std::to_string(sequence_) + R"(,"order_id":)" +
+           std::to_string(id) + R"(,"side":")" + (bid ? "bid" : "ask") + R"(","price":")" +
+           price(bid ? kMid - offset : kMid + offset) + R"(","quantity":"1"})";
+  }
+
+ private:
+  static constexpr int kMid = 10'000;  // 100.00 on the 0.01 grid
+  static constexpr int kLevelGap = 10;
+
+  static std::string price(int ticks) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%d.%02d", ticks / 100, ticks % 100);
+    return buffer;
+  }
+
+  std::uint64_t sequence_{0};
+  std::uint64_t next_id_{1};
+  std::deque<std::uint64_t> resting_;
+};
+
+// Stamps the send time the same way `cex_type1_service --stamp` does.
+void stampAndSend(Poco::Net::WebSocket& ws, std::string frame) {
+  hermeneutic::services::cex_type1_service::appendSendTimestamp(frame);
+  ws.sendFrame(frame.data(), static_cast<int>(frame.size()), Poco::Net::WebSocket::FRAME_TEXT);
+}
+
+class MockExchangeHandler : public Poco::Net::HTTPRequestHandler {
+ public:
+  MockExchangeHandler(const std::atomic<bool>& running, std::chrono::nanoseconds period)
+      : running_(running), period_(period) {}
+
+  void handleRequest(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response) override {
+    if (request.get("Authorization", "") != std::string("Bearer ") + kMockToken) {
+      response.setStatus(Poco::Net::HTTPResponse::HTTP_UNAUTHORIZED);
+      response.send() << "unauthorized";
+      return;
+    }
+    try {
+      Poco::Net::WebSocket ws(request, response);
+      ws.setSendTimeout(Poco::Timespan(1, 0));
+      FlowGenerator flow;
+      stampAndSend(ws, flow.snapshot());
+      // Fixed schedule rather than sleep-after-send, so a slow send does not
+      // lower the offered rate.
+      auto due = Clock::now();
+      while (running_.load(std::memory_order_relaxed)) {
+        due += period_;
+        hermeneutic::services::cex_type1_service::waitUntil(due);
+        stampAndSend(ws, flow.next());
+      }
+    } catch (const Poco::Exception&) {
+      // The feed hung up.
+    }
+  }
+
+ private:
+  const std::atomic<bool>& running_;
+  std::chrono::nanoseconds period_;
+};
+
+class MockExchangeFactory : public Poco::Net::HTTPRequestHandlerFactory {
+ public:
+  MockExchangeFactory(const std::atomic<bool>& running, std::chrono::nanoseconds period)
+      : running_(running), period_(period) {}
+
+  Poco::Net::HTTPRequestHandler* createRequestHandler(const Poco::Net::HTTPServerRequest&) override {
+    return new MockExchangeHandler(running_, period_);
+  }
+
+ private:
+  const std::atomic<bool>& running_;
+  std::chrono::nanoseconds period_;
+};
+
+// Fed from the BookStreamClient thread only.
+class LatencyRecorder {
+ public:
+  void start() { recording_.store(true); }
+  void stop() { recording_.store(false); }
+
+  void onBook(const hermeneutic::common::AggregatedBookView& view) {
+    const auto received_ns = nowNs();
+    if (view.last_feed_timestamp_ns == 0 || view.last_feed_timestamp_ns == last_feed_ns_) {
+      return;  // a republish of a book this recorder already timed
+    }
+    last_feed_ns_ = view.last_feed_timestamp_ns;
+    if (!recording_.load(std::memory_order_relaxed)) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    stages_["feed_to_receive"].record(view.last_local_timestamp_ns - view.last_feed_timestamp_ns);
+    stages_["receive_to_publish"].record(view.publish_timestamp_ns - view.last_local_timestamp_ns);
+    stages_["publish_to_client"].record(received_ns - view.publish_timestamp_ns);
+    stages_["end_to_end"].record(received_ns - view.last_feed_timestamp_ns);
+  }
+
+  std::map<std::string, LatencyHistogram> stages() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stages_;
+  }
+
+ private:
+  std::atomic<bool> recording_{false};
+  std::int64_t last_feed_ns_{0};
+  mutable std::mutex mutex_;
+  std::map<std::string, LatencyHistogram> stages_;
+};
+
+constexpr const char* kStageOrder[] = {"feed_to_receive", "receive_to_publish", "publish_to_client", "end_to_end"};
+
+void report(const Options& options, const std::map<std::string, LatencyHistogram>& stages) {
+  std::printf("%-20s %10s %10s %10s %10s %10s %10s\n", "stage (us)", "count", "p50", "p99", "p99.9", "max",
+              "mean");
+  for (const auto* name : kStageOrder) {
+    const auto it = stages.find(name);
+    if (it == stages.end()) {
+      continue;
+    }
+    const auto& h = it->second;
+    std::printf("%-20s %10llu %10.1f %10.1f %10.1f %10.1f %10.1f\n", name,
+                static_cast<unsigned long long>(h.count()), h.percentile(50.0) / 1e3, h.percentile(99.0) / 1e3,
+                h.percentile(99.9) / 1e3, h.max() / 1e3, h.mean() / 1e3);
+  }
+  if (options.json_path.empty()) {
+    return;
+  }
+  std::ofstream out(options.json_path);
+  out << "{\n  \"mode\": \"" << options.mode << "\",\n";
+  if (options.mode == "inproc") {
+    out << "  \"rate\": " << options.rate << ",\n  \"exchanges\": " << options.exchanges
+        << ",\n  \"publish_interval_ms\": " << options.publish_interval_ms
+        << ",\n  \"max_batch\": " << options.max_batch << ",\n";
+  }
+  out << "  \"duration_s\": " << options.duration_s << ",\n  \"stages\": {";
+  bool first = true;
+  for (const auto* name : kStageOrder) {
+    const auto it = stages.find(name);
+    if (it == stages.end()) {
+      continue;
+    }
+    const auto& h = it->second;
+    out << (first ? "\n" : ",\n") << "    \"" << name << "\": {\"count\": " << h.count()
+        << ", \"p50_ns\": " << h.percentile(50.0) << ", \"p99_ns\": " << h.percentile(99.0)
+        << ", \"p999_ns\": " << h.percentile(99.9) << ", \"max_ns\": " << h.max()
+        << ", \"mean_ns\": " << static_cast<std::uint64_t>(h.mean()) << "}";
+    first = false;
+  }
+  out << "\n  }\n}\n";
+  std::cout << "wrote " << options.json_path << std::endl;
+}
+
+std::chrono::nanoseconds seconds(double value) {
+  return std::chrono::nanoseconds(static_cast<std::int64_t>(value * 1e9));
+}
+
+void measure(const Options& options, hermeneutic::services::BookStreamClient& client, LatencyRecorder& recorder) {
+  client.start();
+  std::this_thread::sleep_for(seconds(options.warmup_s));
+  recorder.start();
+  std::this_thread::sleep_for(seconds(options.duration_s));
+  recorder.stop();
+  client.stop();
+}
+
+int runClient(const Options& options) {
+  LatencyRecorder recorder;
+  hermeneutic::services::BookStreamClient client(
+      options.endpoint, options.token, options.symbol,
+      [&](const hermeneutic::common::AggregatedBookView& view) { recorder.onBook(view); });
+  measure(options, client, recorder);
+  report(options, recorder.stages());
+  return 0;
+}
+
+int runInProcess(const Options& options) {
+  std::atomic<bool> running{true};
+  Poco::Net::ServerSocket socket(Poco::Net::SocketAddress("127.0.0.1", 0));
+  const auto port = socket.address().port();
+  Poco::Net::HTTPServerParams::Ptr params = new Poco::Net::HTTPServerParams;
+  params->setMaxThreads(static_cast<int>(options.exchanges) + 1);
+  const auto period = std::chrono::nanoseconds(
+      static_cast<std::int64_t>(1e9 * static_cast<double>(options.exchanges) / options.rate));
+  Poco::Net::HTTPServer mock(new MockExchangeFactory(running, period), socket, params);
+  mock.start();
+
+  std::vector<std::string> names;
+  for (std::size_t i = 0; i < options.exchanges; ++i) {
+    names.push_back("mock" + std::to_string(i));
+  }
+  hermeneutic::aggregator::AggregationEngine engine;
+  engine.setExpectedExchanges(names);
+  engine.setPublishOptions({
+      .interval = std::chrono::milliseconds(options.publish_interval_ms),
+      .max_batch = options.max_batch,
+  });
+  engine.start();
+
+  hermeneutic::aggregator::AggregatorGrpcService service(engine, kMockToken, options.symbol);
+  int grpc_port = 0;
+  grpc::ServerBuilder builder;
+  builder.AddListeningPort("127.0.0.1:0", grpc::InsecureServerCredentials(), &grpc_port);
+  builder.RegisterService(&service);
+  auto server = builder.BuildAndStart();
+  if (!server || grpc_port == 0) {
+    std::cerr << "could not start the gRPC server" << std::endl;
+    return 1;
+  }
+
+  // Declared before the feeds so it outlives them.
+  std::unique_ptr<hermeneutic::cex_type1::FeedReactor> reactor;
+  if (options.feed_threads > 0) {
+    reactor = std::make_unique<hermeneutic::cex_type1::FeedReactor>(options.feed_threads);
+  }
+  std::vector<std::unique_ptr<hermeneutic::cex_type1::ExchangeFeed>> feeds;
+  for (const auto& name : names) {
+    hermeneutic::cex_type1::FeedOptions feed_options{
+        .exchange = name,
+        .url = "ws://127.0.0.1:" + std::to_string(port) + "/" + name,
+        .auth_token = kMockToken,
+        .interval = std::chrono::milliseconds(50),
+    };
+    auto callback = [&engine](const hermeneutic::common::BookEvent& event) { engine.push(event); };
+    feeds.push_back(reactor ? reactor->makeFeed(feed_options, callback)
+                            : hermeneutic::cex_type1::makeWebSocketFeed(feed_options, callback));
+  }
+
+  LatencyRecorder recorder;
+  hermeneutic::services::BookStreamClient client(
+      "127.0.0.1:" + std::to_string(grpc_port), kMockToken, options.symbol,
+      [&](const hermeneutic::common::AggregatedBookView& view) { recorder.onBook(view); });
+  for (auto& feed : feeds) {
+    feed->start();
+  }
+  measure(options, client, recorder);
+
+  running.store(false);
+  for (auto& feed : feeds) {
+    feed->stop();
+  }
+  mock.stop();
+  server->Shutdown();
+  engine.stop();
+
+  std::printf("%zu exchanges at %.0f msgs/s total, publish interval %d ms, max batch %zu\n", options.exchanges,
+              options.rate, options.publish_interval_ms, options.max_batch);
+  report(options, recorder.stages());
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  try {
+    if (!parseOptions(argc, argv, options)) {
+      usage();
+      return 1;
+    }
+  } catch (const std::exception& ex) {
+    std::cerr << "bad option value: " << ex.what() << std::endl;
+    usage();
+    return 1;
+  }
+  std::signal(SIGPIPE, SIG_IGN);
+  try {
+    return options.mode == "client" ? runClient(options) : runInProcess(options);
+  } catch (const std::exception& ex) {
+    std::cerr << "latency_bench failed: " << ex.what() << std::endl;
+    return 1;
+  }
+}
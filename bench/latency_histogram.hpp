@@ -0,0 +1,99 @@
+#pragma once
+
+// Log-linear latency histogram in the style of HdrHistogram: values below
+// 2^kSubBucketBits are counted exactly and every power of two above that
+// is split into 2^(kSubBucketBits - 1) equal buckets, so any recorded value
+// is reported within 1/64 (~1.6%) of its true value from 1 ns to hours with
+// a fixed 30 KiB of counters. Recording is a few shifts and one increment.
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace hermeneutic::bench {
+
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 7;
+  static constexpr std::uint64_t kSubBuckets = std::uint64_t{1} << kSubBucketBits;
+  static constexpr std::uint64_t kHalf = kSubBuckets / 2;
+
+  LatencyHistogram() : counts_(kSubBuckets + (64 - kSubBucketBits + 1) * kHalf, 0) {}
+
+  // Negative samples (clock skew between stamps) are counted as zero.
+  void record(std::int64_t value) {
+    const auto v = static_cast<std::uint64_t>(std::max<std::int64_t>(value, 0));
+    ++counts_[indexOf(v)];
+    ++count_;
+    sum_ += static_cast<double>(v);
+    min_ = std::min(min_, v);
+    max_ = std::max(max_, v);
+  }
+
+  void merge(const LatencyHistogram& other) {
+    for (std::size_t i = 0; i < counts_.size(); ++i) {
+      counts_[i] += other.counts_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+  }
+
+  // Smallest recorded value such that `percent` of samples are at or below
+  // it, rounded up to the top of its bucket (but never above max()).
+  std::uint64_t percentile(double percent) const {
+    if (count_ == 0) {
+      return 0;
+    }
+    const auto rank = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(std::ceil(percent / 100.0 * static_cast<double>(count_))));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < counts_.size(); ++i) {
+      seen += counts_[i];
+      if (seen >= rank) {
+        return std::min(highestIn(i), max_);
+      }
+    }
+    return max_;
+  }
+
+  std::uint64_t count() const { return count_; }
+  std::uint64_t min() const { return count_ == 0 ? 0 : min_; }
+  std::uint64_t max() const { return max_; }
+  double mean() const { return count_ == 0 ? 0.0 : sum_ / static_cast<double>(count_); }
+
+ private:
+  static std::size_t indexOf(std::uint64_t v) {
+    if (v < kSubBuckets) {
+      return static_cast<std::size_t>(v);
+    }
+    // Keep the top kSubBucketBits bits: `shift` is the magnitude above the
+    // exact range and `sub` lands in [kHalf, kSubBuckets).
+    const auto shift = static_cast<std::uint64_t>(std::bit_width(v)) - kSubBucketBits;
+    const auto sub = v >> shift;
+    return static_cast<std::size_t>(kSubBuckets + (shift - 1) * kHalf + (sub - kHalf));
+  }
+
+  static std::uint64_t highestIn(std::size_t index) {
+    if (index < kSubBuckets) {
+      return index;
+    }
+    const auto offset = index - kSubBuckets;
+    const auto shift = offset / kHalf + 1;
+    const auto sub = offset % kHalf + kHalf;
+    return ((sub + 1) << shift) - 1;
+  }
+
+  std::vector<std::uint64_t> counts_;
+  std::uint64_t count_{0};
+  double sum_{0.0};
+  std::uint64_t min_{std::numeric_limits<std::uint64_t>::max()};
+  std::uint64_t max_{0};
+};
+
+}  // namespace hermeneutic::bench
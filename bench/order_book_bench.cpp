@@ -0,0 +1,80 @@
+// LimitOrderBook::apply under new/cancel flow and full snapshots, for both
+// ladder backends. Arguments: book depth, ladder (0 = map, 1 = flat).
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include "hermeneutic/lob/order_book.hpp"
+#include "synthetic_books.hpp"
+
+namespace {
+
+using hermeneutic::common::BookEvent;
+using hermeneutic::common::BookEventKind;
+using hermeneutic::common::Side;
+namespace bench = hermeneutic::bench;
+
+hermeneutic::lob::BookOptions optionsFor(const benchmark::State& state) {
+  hermeneutic::lob::BookOptions options;
+  options.ladder = state.range(1) == 0 ? hermeneutic::lob::LadderKind::Map : hermeneutic::lob::LadderKind::Flat;
+  return options;
+}
+
+// Adds an order inside the book, then cancels it: each pair touches an
+// existing level twice, like most of a live feed.
+void BM_OrderBookNewCancel(benchmark::State& state) {
+  const auto depth = static_cast<std::size_t>(state.range(0));
+  hermeneutic::lob::LimitOrderBook book(optionsFor(state));
+  book.apply(bench::makeSnapshot(0, depth));
+  hermeneutic::lob::LevelDeltas deltas;
+
+  BookEvent add;
+  add.exchange_id = bench::exchangeId(0);
+  add.kind = BookEventKind::NewOrder;
+  add.feed_timestamp_ns = 1;
+  add.local_timestamp_ns = 1;
+  add.order.quantity = hermeneutic::common::Decimal::fromInteger(1);
+  BookEvent cancel = add;
+  cancel.kind = BookEventKind::CancelOrder;
+
+  std::uint64_t order_id = 1'000'000;
+  std::int64_t level = 0;
+  for (auto _ : state) {
+    const bool bid = (order_id & 1) == 0;
+    const auto offset = 1 + level;
+    add.order.order_id = ++order_id;
+    add.order.side = bid ? Side::Bid : Side::Ask;
+    add.order.price = bench::ticks(bid ? bench::kMidTicks - offset : bench::kMidTicks + offset);
+    cancel.order = add.order;
+    deltas.clear();
+    book.apply(add, deltas);
+    book.apply(cancel, deltas);
+    benchmark::DoNotOptimize(deltas.data());
+    level = (level + 1) % static_cast<std::int64_t>(depth);
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_OrderBookNewCancel)->ArgsProduct({{10, 100, 1000}, {0, 1}});
+
+void BM_OrderBookSnapshot(benchmark::State& state) {
+  const auto depth = static_cast<std::size_t>(state.range(0));
+  hermeneutic::lob::LimitOrderBook book(optionsFor(state));
+  // Alternate two bid ladders so every snapshot changes half the levels.
+  const auto base = bench::makeSnapshot(0, depth);
+  auto bumped = base;
+  for (auto& level : bumped.snapshot.bids) {
+    level.quantity += hermeneutic::common::Decimal::fromInteger(1);
+  }
+  hermeneutic::lob::LevelDeltas deltas;
+  bool flip = false;
+  for (auto _ : state) {
+    deltas.clear();
+    book.apply(flip ? bumped : base, deltas);
+    benchmark::DoNotOptimize(deltas.data());
+    flip = !flip;
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(2 * depth));
+}
+BENCHMARK(BM_OrderBookSnapshot)->ArgsProduct({{10, 100, 1000}, {0, 1}});
+
+}  // namespace
@@ -0,0 +1,52 @@
+// OrderFlowGenerator on its own and driving LimitOrderBook::apply.
+// Arguments: depth, then for the book case the ladder (0 = map, 1 = flat).
+#include <benchmark/benchmark.h>
+
+#include "hermeneutic/lob/order_book.hpp"
+#include "hermeneutic/order_flow/generator.hpp"
+
+namespace {
+
+using hermeneutic::common::BookEvent;
+using hermeneutic::order_flow::FlowOptions;
+using hermeneutic::order_flow::OrderFlowGenerator;
+
+FlowOptions flowFor(const benchmark::State& state) {
+  FlowOptions options;
+  options.exchange = "bench-flow";
+  options.depth = static_cast<std::size_t>(state.range(0));
+  options.max_resting = 10'000;
+  return options;
+}
+
+void BM_OrderFlowGenerate(benchmark::State& state) {
+  OrderFlowGenerator generator(flowFor(state));
+  BookEvent event;
+  for (auto _ : state) {
+    generator.next(event);
+    benchmark::DoNotOptimize(event.order.order_id);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OrderFlowGenerate)->Arg(20)->Arg(1000);
+
+void BM_OrderFlowIntoBook(benchmark::State& state) {
+  OrderFlowGenerator generator(flowFor(state));
+  hermeneutic::lob::BookOptions options;
+  options.ladder = state.range(1) == 0 ? hermeneutic::lob::LadderKind::Map : hermeneutic::lob::LadderKind::Flat;
+  hermeneutic::lob::LimitOrderBook book(options);
+  hermeneutic::lob::LevelDeltas deltas;
+  BookEvent event;
+  generator.snapshot(event);
+  book.apply(event, deltas);
+  for (auto _ : state) {
+    generator.next(event);
+    deltas.clear();
+    book.apply(event, deltas);
+    benchmark::DoNotOptimize(deltas.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OrderFlowIntoBook)->ArgsProduct({{20, 1000}, {0, 1}});
+
+}  // namespace
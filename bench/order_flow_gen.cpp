@@ -0,0 +1,222 @@
+// Synthetic order flow from hermeneutic::order_flow, in memory.
+//
+//   order_flow_gen ndjson [--events n] [flow options]
+//       One snapshot then n events as cex_type1 NDJSON on stdout, e.g.
+//       cex_type1_service x <(order_flow_gen ndjson --events 1000000) 9001 t 0 --rate 500000
+//   order_flow_gen book [--events n] [--ladder map|flat] [flow options]
+//       Events per second through the generator and one LimitOrderBook.
+//   order_flow_gen engine [--events n] [--exchanges k] [--max-batch n] [flow options]
+//       Events per second through AggregationEngine, from push until the
+//       last event has been consolidated and published.
+//
+// Flow options: --depth n --cancel-ratio p --walk p --cross p --max-quantity n
+//               --max-resting n --seed n
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <vector>
+
+#include "hermeneutic/aggregator/aggregator.hpp"
+#include "hermeneutic/lob/order_book.hpp"
+#include "hermeneutic/order_flow/generator.hpp"
+
+namespace {
+
+using hermeneutic::common::BookEvent;
+using hermeneutic::order_flow::FlowOptions;
+using hermeneutic::order_flow::OrderFlowGenerator;
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+  std::string mode;
+  std::uint64_t events{10'000'000};
+  std::size_t exchanges{3};
+  std::size_t max_batch{64};
+  bool flat_ladder{false};
+  FlowOptions flow;
+};
+
+void usage() {
+  std::cerr << "usage: order_flow_gen ndjson|book|engine [--events n] [--exchanges k] [--max-batch n]\n"
+               "                      [--ladder map|flat] [--depth n] [--cancel-ratio p] [--walk p]\n"
+               "                      [--cross p] [--max-quantity n] [--max-resting n] [--seed n]\n";
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+  if (argc < 2) {
+    return false;
+  }
+  options.mode = argv[1];
+  if (options.mode != "ndjson" && options.mode != "book" && options.mode != "engine") {
+    return false;
+  }
+  for (int i = 2; i + 1 < argc; i += 2) {
+    const std::string key = argv[i];
+    const std::string value = argv[i + 1];
+    if (key == "--events") {
+      options.events = std::stoull(value);
+    } else if (key == "--exchanges") {
+      options.exchanges = std::stoul(value);
+    } else if (key == "--max-batch") {
+      options.max_batch = std::stoul(value);
+    } else if (key == "--ladder") {
+      options.flat_ladder = value == "flat";
+    } else if (key == "--depth") {
+      options.flow.depth = std::stoul(value);
+    } else if (key == "--cancel-ratio") {
+      options.flow.cancel_ratio = std::stod(value);
+    } else if (key == "--walk") {
+      options.flow.walk_probability = std::stod(value);
+    } else if (key == "--cross") {
+      options.flow.cross_probability = std::stod(value);
+    } else if (key == "--max-quantity") {
+      options.flow.max_quantity = std::stoll(value);
+    } else if (key == "--max-resting") {
+      options.flow.max_resting = std::stoul(value);
+    } else if (key == "--seed") {
+      options.flow.seed = std::stoull(value);
+    } else {
+      std::cerr << "unknown option " << key << std::endl;
+      return false;
+    }
+  }
+  if ((argc - 2) % 2 != 0) {
+    std::cerr << "missing value for " << argv[argc - 1] << std::endl;
+    return false;
+  }
+  return options.exchanges > 0 && options.max_batch > 0;
+}
+
+void report(const char* what, std::uint64_t events, Clock::duration elapsed) {
+  const auto seconds = std::chrono::duration<double>(elapsed).count();
+  std::printf("%s: %llu events in %.3f s = %.2f M events/s\n", what, static_cast<unsigned long long>(events),
+              seconds, static_cast<double>(events) / seconds / 1e6);
+}
+
+int runNdjson(const Options& options) {
+  OrderFlowGenerator generator(options.flow);
+  BookEvent event;
+  std::string buffer;
+  buffer.reserve(1 << 20);
+  generator.snapshot(event);
+  hermeneutic::order_flow::appendNdjson(event, options.flow.price_digits, buffer);
+  for (std::uint64_t i = 0; i < options.events; ++i) {
+    generator.next(event);
+    hermeneutic::order_flow::appendNdjson(event, options.flow.price_digits, buffer);
+    if (buffer.size() >= (1 << 20) - 512) {
+      std::fwrite(buffer.data(), 1, buffer.size(), stdout);
+      buffer.clear();
+    }
+  }
+  std::fwrite(buffer.data(), 1, buffer.size(), stdout);
+  return 0;
+}
+
+int runBook(const Options& options) {
+  OrderFlowGenerator generator(options.flow);
+  hermeneutic::lob::BookOptions book_options;
+  book_options.ladder = options.flat_ladder ? hermeneutic::lob::LadderKind::Flat : hermeneutic::lob::LadderKind::Map;
+  hermeneutic::lob::LimitOrderBook book(book_options);
+  hermeneutic::lob::LevelDeltas deltas;
+  BookEvent event;
+  generator.snapshot(event);
+  book.apply(event, deltas);
+
+  const auto start = Clock::now();
+  for (std::uint64_t i = 0; i < options.events; ++i) {
+    generator.next(event);
+    deltas.clear();
+    book.apply(event, deltas);
+  }
+  report("generator + LimitOrderBook", options.events, Clock::now() - start);
+  const auto stats = book.stats();
+  std::printf("book: %zu bid levels, %zu ask levels, %zu resting orders\n", stats.bid_levels, stats.ask_levels,
+              stats.resting_orders);
+  return 0;
+}
+
+int runEngine(const Options& options) {
+  std::vector<OrderFlowGenerator> generators;
+  std::vector<std::string> names;
+  for (std::size_t i = 0; i < options.exchanges; ++i) {
+    auto flow = options.flow;
+    flow.exchange = "flow" + std::to_string(i);
+    flow.seed = options.flow.seed + i;
+    names.push_back(flow.exchange);
+    generators.emplace_back(std::move(flow));
+  }
+
+  // The bounded ring applies back-pressure, so the producer cannot queue
+  // millions of events ahead of the worker.
+  hermeneutic::aggregator::AggregationEngine engine(
+      hermeneutic::common::QueueOptions{.kind = hermeneutic::common::QueueKind::LockFree});
+  engine.setExpectedExchanges(names);
+  engine.setPublishOptions({.max_batch = options.max_batch});
+  // Each event carries its running count as the local timestamp, so the
+  // published view's newest local timestamp says how far the engine got.
+  std::mutex mutex;
+  std::condition_variable done;
+  std::int64_t applied = 0;
+  std::uint64_t publishes = 0;
+  engine.subscribe([&](const hermeneutic::aggregator::BookSnapshot& view) {
+    std::lock_guard<std::mutex> lock(mutex);
+    applied = view->last_local_timestamp_ns;
+    ++publishes;
+    done.notify_all();
+  });
+  engine.start();
+
+  BookEvent event;
+  std::int64_t pushed = 0;
+  for (auto& generator : generators) {
+    generator.snapshot(event);
+    event.local_timestamp_ns = ++pushed;
+    engine.push(event);
+  }
+  event.snapshot = {};  // push() copies the event
+  const auto total = pushed + static_cast<std::int64_t>(options.events);
+  const auto start = Clock::now();
+  while (pushed < total) {
+    auto& generator = generators[static_cast<std::size_t>(pushed) % generators.size()];
+    generator.next(event);
+    event.local_timestamp_ns = ++pushed;
+    engine.push(event);
+  }
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] { return applied >= total; });
+  }
+  const auto elapsed = Clock::now() - start;
+  engine.stop();
+  report("generator + AggregationEngine", options.events, elapsed);
+  std::printf("%zu exchanges, max batch %zu, %llu publishes\n", options.exchanges, options.max_batch,
+              static_cast<unsigned long long>(publishes));
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  try {
+    if (!parseOptions(argc, argv, options)) {
+      usage();
+      return 1;
+    }
+    if (options.mode == "ndjson") {
+      return runNdjson(options);
+    }
+    // Debug-assert builds trace every book event through spdlog, which
+    // would swamp both the timing and the report.
+    spdlog::set_level(spdlog::level::off);
+    return options.mode == "book" ? runBook(options) : runEngine(options);
+  } catch (const std::exception& ex) {
+    std::cerr << "order_flow_gen failed: " << ex.what() << std::endl;
+    return 1;
+  }
+}
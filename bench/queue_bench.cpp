@@ -0,0 +1,129 @@
+// Enqueue-to-apply latency through the engine's event queue: paced
+// producers stamp each event as they push it, and one consumer pops it,
+// applies it to that producer's LimitOrderBook and records the delay.
+// Arguments: queue (0 = mutex ConcurrentQueue, 1 = lock-free ring with
+// hybrid waiting, 2 = lock-free ring with blocking waiting), then producer
+// count. Reported as p50_ns/p99_ns/p999_ns counters, so the mutex
+// rows are the baseline for the lock-free ones.
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hermeneutic/common/event_queue.hpp"
+#include "hermeneutic/lob/order_book.hpp"
+#include "hermeneutic/order_flow/generator.hpp"
+#include "latency_histogram.hpp"
+
+namespace {
+
+using hermeneutic::common::BookEvent;
+using hermeneutic::common::EventQueue;
+using hermeneutic::common::QueueKind;
+using hermeneutic::common::QueueOptions;
+using hermeneutic::order_flow::FlowOptions;
+using hermeneutic::order_flow::OrderFlowGenerator;
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kEventsPerProducer = 1000;
+// Each producer offers 50k events/s, a busy exchange feed, which leaves
+// the consumer headroom so the delay is the hand-off rather than a backlog.
+constexpr auto kSpacing = std::chrono::microseconds(20);
+
+std::int64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+void BM_EnqueueToApply(benchmark::State& state) {
+  // Debug-assert builds trace every applied event through spdlog, which
+  // would measure the logger instead of the queue.
+  const auto log_level = spdlog::get_level();
+  spdlog::set_level(spdlog::level::off);
+  QueueOptions options;
+  options.kind = state.range(0) == 0 ? QueueKind::Mutex : QueueKind::LockFree;
+  if (state.range(0) == 2) {
+    options.wait = hermeneutic::common::WaitStrategy::Blocking;
+  }
+  const auto producers = static_cast<std::size_t>(state.range(1));
+  EventQueue<BookEvent> queue(options);
+
+  std::vector<std::unique_ptr<OrderFlowGenerator>> generators;
+  std::vector<std::unique_ptr<hermeneutic::lob::LimitOrderBook>> books;
+  for (std::size_t p = 0; p < producers; ++p) {
+    FlowOptions flow;
+    flow.exchange = "bench-queue-" + std::to_string(p);
+    flow.seed = p + 1;
+    flow.max_resting = 10'000;
+    generators.push_back(std::make_unique<OrderFlowGenerator>(flow));
+    books.push_back(std::make_unique<hermeneutic::lob::LimitOrderBook>());
+    BookEvent event;
+    generators.back()->snapshot(event);
+    books.back()->apply(event);
+  }
+  // Books are looked up by exchange id, which the generators interned.
+  std::vector<hermeneutic::lob::LimitOrderBook*> book_by_exchange;
+  for (std::size_t p = 0; p < producers; ++p) {
+    const auto id = generators[p]->exchangeId();
+    if (id >= book_by_exchange.size()) {
+      book_by_exchange.resize(id + 1u, nullptr);
+    }
+    book_by_exchange[id] = books[p].get();
+  }
+
+  hermeneutic::bench::LatencyHistogram latency;
+  std::atomic<std::uint64_t> applied{0};
+  std::thread consumer([&] {
+    hermeneutic::lob::LevelDeltas deltas;
+    BookEvent event;
+    while (queue.wait_pop(event)) {
+      deltas.clear();
+      book_by_exchange[event.exchange_id]->apply(event, deltas);
+      latency.record(nowNs() - event.local_timestamp_ns);
+      applied.fetch_add(1, std::memory_order_release);
+    }
+  });
+
+  std::uint64_t pushed = 0;
+  for (auto _ : state) {
+    std::vector<std::thread> threads;
+    for (std::size_t p = 0; p < producers; ++p) {
+      threads.emplace_back([&, p] {
+        BookEvent event;
+        auto next = Clock::now();
+        for (std::size_t i = 0; i < kEventsPerProducer; ++i) {
+          generators[p]->next(event);
+          next += kSpacing;
+          // Sleep like a feed thread waiting on its socket, so producers
+          // never take the consumer's core.
+          std::this_thread::sleep_until(next);
+          event.local_timestamp_ns = nowNs();
+          queue.push(event);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    pushed += producers * kEventsPerProducer;
+    while (applied.load(std::memory_order_acquire) < pushed) {
+      std::this_thread::yield();
+    }
+  }
+  queue.close();
+  consumer.join();
+  spdlog::set_level(log_level);
+
+  state.SetItemsProcessed(static_cast<std::int64_t>(pushed));
+  state.counters["p50_ns"] = static_cast<double>(latency.percentile(50.0));
+  state.counters["p99_ns"] = static_cast<double>(latency.percentile(99.0));
+  state.counters["p999_ns"] = static_cast<double>(latency.percentile(99.9));
+}
+BENCHMARK(BM_EnqueueToApply)->ArgsProduct({{0, 1, 2}, {1, 3}})->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,79 @@
+#pragma once
+
+// Deterministic books for hermeneutic_bench. Prices sit on a 0.01 grid
+// around 100.00 and exchange i's ladder is shifted up by i * `step` ticks,
+// so the consolidated book mixes shared and exchange-unique levels. Steps
+// of two or more cross neighbouring exchanges, which exercises the
+// virtual uncross.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "hermeneutic/aggregator/consolidated_book.hpp"
+#include "hermeneutic/common/events.hpp"
+#include "hermeneutic/common/exchange_registry.hpp"
+#include "hermeneutic/lob/order_book.hpp"
+
+namespace hermeneutic::bench {
+
+inline constexpr std::int64_t kMidTicks = 10'000;  // 100.00 on the 0.01 grid
+
+inline common::Decimal ticks(std::int64_t count) {
+  return common::Decimal::fromScaled(count, 2);
+}
+
+inline common::ExchangeId exchangeId(std::size_t index) {
+  return common::ExchangeRegistry::instance().intern("bench" + std::to_string(index));
+}
+
+// Snapshot for exchange `index`: `depth` levels per side, one tick apart,
+// with quantities 1..depth.
+inline common::BookEvent makeSnapshot(std::size_t index, std::size_t depth, std::int64_t step = 1) {
+  common::BookEvent event;
+  event.exchange_id = exchangeId(index);
+  event.kind = common::BookEventKind::Snapshot;
+  event.feed_timestamp_ns = 1;
+  event.local_timestamp_ns = 1;
+  const auto shift = static_cast<std::int64_t>(index) * step;
+  for (std::size_t level = 0; level < depth; ++level) {
+    const auto offset = static_cast<std::int64_t>(level) + 1;
+    const auto quantity = common::Decimal::fromInteger(static_cast<std::int64_t>(level) + 1);
+    event.snapshot.bids.push_back({ticks(kMidTicks - offset + shift), quantity});
+    event.snapshot.asks.push_back({ticks(kMidTicks + offset + shift), quantity});
+  }
+  return event;
+}
+
+// Consolidated ladder of `exchanges` books `depth` levels deep.
+inline aggregator::ConsolidatedBook makeConsolidated(std::size_t exchanges,
+                                                     std::size_t depth,
+                                                     std::int64_t step = 1) {
+  aggregator::ConsolidatedBook consolidated;
+  lob::LevelDeltas deltas;
+  for (std::size_t i = 0; i < exchanges; ++i) {
+    lob::LimitOrderBook book;
+    deltas.clear();
+    book.apply(makeSnapshot(i, depth, step), deltas);
+    consolidated.apply(deltas);
+  }
+  return consolidated;
+}
+
+// What AggregationEngine publishes for the same books, minus timestamps.
+inline common::AggregatedBookView makeView(std::size_t exchanges, std::size_t depth) {
+  common::AggregatedBookView view;
+  makeConsolidated(exchanges, depth).materialize(view.bid_levels, view.ask_levels);
+  aggregator::virtualUncross(view.bid_levels, view.ask_levels);
+  if (!view.bid_levels.empty()) {
+    view.best_bid = {view.bid_levels.front().price, view.bid_levels.front().quantity};
+  }
+  if (!view.ask_levels.empty()) {
+    view.best_ask = {view.ask_levels.front().price, view.ask_levels.front().quantity};
+  }
+  view.exchange_count = exchanges;
+  return view;
+}
+
+}  // namespace hermeneutic::bench
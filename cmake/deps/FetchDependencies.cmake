@@ -72,9 +72,25 @@ FetchContent_Declare(
   GIT_TAG ${POCO_VERSION}
 )
 
+set(_hermeneutic_fetch_deps spdlog simdjson grpc poco)
+if(HERMENEUTIC_BUILD_BENCH)
+  set(BENCHMARK_VERSION v1.8.3 CACHE STRING "google benchmark version")
+  set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL "" FORCE)
+  set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL "" FORCE)
+  set(BENCHMARK_ENABLE_INSTALL OFF CACHE BOOL "" FORCE)
+  _hermeneutic_prepare_fetchcontent(benchmark)
+  FetchContent_Declare(
+    benchmark
+    GIT_REPOSITORY https://github.com/google/benchmark.git
+    GIT_TAG ${BENCHMARK_VERSION}
+    FIND_PACKAGE_ARGS CONFIG
+  )
+  list(APPEND _hermeneutic_fetch_deps benchmark)
+endif()
+
 set(_hermeneutic_saved_build_testing ${BUILD_TESTING})
 set(BUILD_TESTING OFF CACHE BOOL "" FORCE)
-FetchContent_MakeAvailable(spdlog simdjson grpc poco)
+FetchContent_MakeAvailable(${_hermeneutic_fetch_deps})
 set(BUILD_TESTING ${_hermeneutic_saved_build_testing} CACHE BOOL "" FORCE)
 unset(_hermeneutic_saved_build_testing)
 
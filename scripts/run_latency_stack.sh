@@ -0,0 +1,91 @@
+#!/usr/bin/env bash
+# Measure end-to-end latency across the real processes: three
+# cex_type1_service mocks stamping send times (--stamp), the aggregator
+# service, and `latency_bench client` subscribed to it. Prints per-stage
+# p50/p99/p99.9/max and writes JSON to $OUTPUT_JSON.
+#
+# The aggregator's publish_interval_ms (50 in config/aggregator.json) shows
+# up in the receive->publish stage; point CONFIG_PATH at a copy with 0 to
+# measure the pipeline without conflation. INTERVAL_MS sets the mock feeds'
+# per-message delay.
+
+set -euo pipefail
+
+ROOT_DIR=$(CDPATH= cd -- "$(dirname "$0")/.." && pwd)
+BUILD_DIR=${BUILD_DIR:-"$ROOT_DIR/build"}
+BUILD_TYPE=${BUILD_TYPE:-"RelWithDebInfo"}
+PARALLEL=${BUILD_PARALLEL:-"8"}
+CONFIG_PATH=${CONFIG_PATH:-"$ROOT_DIR/config/aggregator.json"}
+SYMBOL=${SYMBOL:-"BTCUSDT"}
+AGG_ENDPOINT=${AGG_ENDPOINT:-"127.0.0.1:50051"}
+AGG_TOKEN=${AGG_TOKEN:-"agg-local-token"}
+INTERVAL_MS=${INTERVAL_MS:-"1"}
+DURATION_S=${DURATION_S:-"10"}
+WARMUP_S=${WARMUP_S:-"2"}
+OUTPUT_JSON=${OUTPUT_JSON:-"$BUILD_DIR/latency.json"}
+# The feeds are local, so there are no hostnames to wait for.
+export HERMENEUTIC_WAIT_FOR_FEEDS=${HERMENEUTIC_WAIT_FOR_FEEDS:-0}
+
+if [ ! -f "$CONFIG_PATH" ]; then
+  echo "[latency] missing config file: $CONFIG_PATH" >&2
+  exit 1
+fi
+
+if [ ! -f "$BUILD_DIR/CMakeCache.txt" ]; then
+  echo "[latency] configuring CMake build directory at $BUILD_DIR"
+  cmake -S "$ROOT_DIR" -B "$BUILD_DIR" -DCMAKE_BUILD_TYPE="$BUILD_TYPE" -DHERMENEUTIC_BUILD_BENCH=ON
+fi
+
+TARGETS=(cex_type1_service aggregator_service latency_bench)
+build_cmd=(cmake --build "$BUILD_DIR" --target "${TARGETS[@]}")
+if [ -n "$PARALLEL" ]; then
+  build_cmd+=(--parallel "$PARALLEL")
+fi
+echo "[latency] building ${TARGETS[*]}"
+"${build_cmd[@]}"
+
+cex_bin="$BUILD_DIR/services/cex_type1_service/cex_type1_service"
+agg_bin="$BUILD_DIR/services/aggregator_service/aggregator_service"
+bench_bin="$BUILD_DIR/bench/latency_bench"
+for binary in "$cex_bin" "$agg_bin" "$bench_bin"; do
+  if [ ! -x "$binary" ]; then
+    echo "[latency] expected binary not found: $binary (configure with -DHERMENEUTIC_BUILD_BENCH=ON)" >&2
+    exit 1
+  fi
+done
+
+declare -a PIDS=()
+
+cleanup() {
+  for pid in "${PIDS[@]}"; do
+    kill "$pid" >/dev/null 2>&1 || true
+  done
+  for pid in "${PIDS[@]}"; do
+    wait "$pid" 2>/dev/null || true
+  done
+  PIDS=()
+}
+trap 'cleanup' EXIT
+trap 'echo "[latency] interrupt received"; exit 0' INT TERM
+
+start_service() {
+  local label="$1"
+  shift
+  echo "[latency] starting $label: $*"
+  "$@" &
+  PIDS+=("$!")
+}
+
+start_service "cex-notbinance" "$cex_bin" \
+  notbinance "$ROOT_DIR/data/notbinance.ndjson" 9001 notbinance-token "$INTERVAL_MS" 0 --stamp
+start_service "cex-notcoinbase" "$cex_bin" \
+  notcoinbase "$ROOT_DIR/data/notcoinbase.ndjson" 9002 notcoinbase-token "$INTERVAL_MS" 0 --stamp
+start_service "cex-notkraken" "$cex_bin" \
+  notkraken "$ROOT_DIR/data/notkraken.ndjson" 9003 notkraken-token "$INTERVAL_MS" 0 --stamp
+
+sleep 1
+start_service "aggregator" "$agg_bin" "$CONFIG_PATH"
+sleep 1
+
+"$bench_bin" client --endpoint "$AGG_ENDPOINT" --token "$AGG_TOKEN" --symbol "$SYMBOL" \
+  --duration "$DURATION_S" --warmup "$WARMUP_S" --json "$OUTPUT_JSON"
@@ -21,12 +21,17 @@
 #include "hermeneutic/aggregator/aggregator.hpp"
 #include "hermeneutic/aggregator/config.hpp"
 #include "hermeneutic/aggregator/grpc_service.hpp"
+#include "hermeneutic/aggregator/sharded_aggregator.hpp"
 #include "hermeneutic/cex_type1/feed.hpp"
+#include "hermeneutic/cex_type1/feed_reactor.hpp"
 #include "hermeneutic/common/events.hpp"
+#include "hermeneutic/journal/writer.hpp"
 #include "services/aggregator_service/feed_wait.hpp"
+#include "services/aggregator_service/stats_report.hpp"
 
 namespace {
 std::atomic<bool> g_running{true};
+constexpr auto kStatsInterval = std::chrono::seconds(10);
 
 void handleSignal(int) {
   g_running = false;
@@ -66,16 +71,29 @@ int main(int argc, char** argv) {
       }
     }
 
-    hermeneutic::aggregator::AggregationEngine engine;
-    std::vector<std::string> expected;
-    expected.reserve(config.feeds.size());
-    for (const auto& feed : config.feeds) {
-      expected.push_back(feed.name);
+    hermeneutic::aggregator::ShardedAggregator aggregator(config.shards, config.queue);
+    const auto symbols = config.symbols();
+    for (const auto& symbol : symbols) {
+      auto& engine = aggregator.engineFor(symbol);
+      std::vector<std::string> expected;
+      for (const auto& feed : config.feeds) {
+        if (feed.symbol == symbol) {
+          expected.push_back(feed.name);
+          engine.setBookOptions(symbol, feed.name, feed.book);
+        }
+      }
+      engine.setExpectedExchanges(symbol, std::move(expected));
     }
-    engine.setExpectedExchanges(expected);
-    engine.start();
-
-    hermeneutic::aggregator::AggregatorGrpcService service(engine, config.grpc.auth_token, config.symbol);
+    aggregator.setPublishOptions({
+        .interval = config.publish_interval,
+        .bbo_changes_only = config.publish_on_bbo_change,
+        .max_batch = config.max_batch_events,
+    });
+    aggregator.start();
+    spdlog::info("Aggregating {} symbol(s) on {} shard(s)", symbols.size(), aggregator.shardCount());
+
+    hermeneutic::aggregator::AggregatorGrpcService service(aggregator, config.grpc.auth_token, symbols,
+                                                          config.grpc.stream);
     const std::string server_address = config.grpc.listen_address + ":" + std::to_string(config.grpc.port);
     grpc::ServerBuilder builder;
     builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
@@ -89,16 +107,37 @@ int main(int argc, char** argv) {
 
     std::thread server_thread([&] { server->Wait(); });
 
+    // Declared before the feeds so both outlive them.
+    std::unique_ptr<hermeneutic::journal::JournalWriter> journal;
+    if (!config.journal.directory.empty()) {
+      journal = std::make_unique<hermeneutic::journal::JournalWriter>(hermeneutic::journal::JournalOptions{
+          .directory = config.journal.directory,
+          .segment_bytes = config.journal.segment_bytes,
+      });
+    }
+    std::unique_ptr<hermeneutic::cex_type1::FeedReactor> reactor;
+    if (config.feed_threads > 0) {
+      reactor = std::make_unique<hermeneutic::cex_type1::FeedReactor>(config.feed_threads);
+      spdlog::info("Multiplexing {} feeds over {} event loop thread(s)", config.feeds.size(), config.feed_threads);
+    }
     std::vector<std::unique_ptr<hermeneutic::cex_type1::ExchangeFeed>> feeds;
     feeds.reserve(config.feeds.size());
     for (const auto& feed_config : config.feeds) {
       hermeneutic::cex_type1::FeedOptions options{
           .exchange = feed_config.name,
+          .symbol = feed_config.symbol,
           .url = feed_config.url,
           .auth_token = feed_config.auth_token,
       };
-      auto feed = hermeneutic::cex_type1::makeWebSocketFeed(
-          options, [&engine](hermeneutic::common::BookEvent event) { engine.push(std::move(event)); });
+      // The feed stamps the symbol id, so events go through untouched.
+      auto callback = [&aggregator, &journal](const hermeneutic::common::BookEvent& event) {
+        if (journal) {
+          journal->append(event);
+        }
+        aggregator.push(event);
+      };
+      auto feed = reactor ? reactor->makeFeed(options, callback)
+                          : hermeneutic::cex_type1::makeWebSocketFeed(options, callback);
       feeds.push_back(std::move(feed));
     }
 
@@ -106,19 +145,33 @@ int main(int argc, char** argv) {
       feed->start();
     }
 
+    hermeneutic::services::aggregator_service::StatsReporter reporter;
+    auto next_report = std::chrono::steady_clock::now() + kStatsInterval;
     while (g_running.load()) {
       std::this_thread::sleep_for(std::chrono::milliseconds(200));
+      if (std::chrono::steady_clock::now() >= next_report) {
+        next_report += kStatsInterval;
+        for (const auto& symbol : symbols) {
+          reporter.reportBooks(symbol, aggregator.engineFor(symbol).bookStats(symbol));
+        }
+        reporter.reportSubscribers(service.subscriberStats());
+      }
     }
 
     for (auto& feed : feeds) {
       feed->stop();
     }
+    if (journal) {
+      const auto stats = journal->stats();
+      spdlog::info("Journaled {} events ({} bytes) in {} segment(s), {} dropped", stats.events, stats.bytes,
+                   stats.segments, stats.dropped);
+    }
 
     server->Shutdown();
     if (server_thread.joinable()) {
       server_thread.join();
     }
-    engine.stop();
+    aggregator.stop();
     spdlog::info("Aggregator service stopped");
   } catch (const std::exception& ex) {
     spdlog::error("Aggregator service failed: {}", ex.what());
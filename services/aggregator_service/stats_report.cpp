@@ -0,0 +1,47 @@
+#include "services/aggregator_service/stats_report.hpp"
+
+#include <spdlog/spdlog.h>
+#include <utility>
+
+namespace hermeneutic::services::aggregator_service {
+
+std::size_t StatsReporter::reportBooks(const std::string& symbol,
+                                       const std::unordered_map<std::string, lob::BookStats>& books) {
+  std::size_t lines = 0;
+  for (const auto& [exchange, stats] : books) {
+    auto& previous = books_[symbol + '/' + exchange];
+    const bool moved = stats.sequence_gaps != previous.sequence_gaps || stats.resyncs != previous.resyncs ||
+                       stats.dropped_events != previous.dropped_events;
+    if (moved || stats.stale) {
+      spdlog::warn(
+          "Book {}/{}: {} sequence gaps, {} resyncs (last {} us, max {} us), {} dropped events, {} buffered{}",
+          symbol, exchange, stats.sequence_gaps, stats.resyncs, stats.last_resync_ns / 1000,
+          stats.max_resync_ns / 1000, stats.dropped_events, stats.buffered_events, stats.stale ? ", stale" : "");
+      ++lines;
+    }
+    previous = stats;
+  }
+  return lines;
+}
+
+std::size_t StatsReporter::reportSubscribers(const std::vector<aggregator::SubscriberStats>& subscribers) {
+  std::size_t lines = 0;
+  std::unordered_map<std::string, aggregator::StreamStats> streams;
+  for (const auto& subscriber : subscribers) {
+    const auto key = subscriber.peer + ' ' + subscriber.method + ' ' + subscriber.symbol;
+    const auto found = streams_.find(key);
+    const auto previous = found != streams_.end() ? found->second : aggregator::StreamStats{};
+    const auto& stats = subscriber.stream;
+    if (stats.dropped != previous.dropped || stats.resyncs != previous.resyncs || stats.max_lag > previous.max_lag) {
+      spdlog::warn("Subscriber {} {}{}: lag {} (max {}), {} sent, {} dropped, {} snapshot resyncs", subscriber.peer,
+                   subscriber.method, subscriber.symbol.empty() ? "" : " " + subscriber.symbol, stats.lag,
+                   stats.max_lag, stats.sent, stats.dropped, stats.resyncs);
+      ++lines;
+    }
+    streams.emplace(key, stats);
+  }
+  streams_ = std::move(streams);
+  return lines;
+}
+
+}  // namespace hermeneutic::services::aggregator_service
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "hermeneutic/aggregator/grpc_service.hpp"
+#include "hermeneutic/lob/order_book.hpp"
+
+namespace hermeneutic::services::aggregator_service {
+
+// Periodic health lines for the service log. Each call logs only what moved
+// since the previous one, so a quiet healthy service stays quiet.
+class StatsReporter {
+ public:
+  // Logs every exchange book of `symbol` whose sequence gap, resync or drop
+  // counters changed, or that is still stale. Returns the lines logged.
+  std::size_t reportBooks(const std::string& symbol,
+                          const std::unordered_map<std::string, lob::BookStats>& books);
+  // Logs every open gRPC stream whose dropped or resync counters moved, or
+  // whose peak lag rose. Closed streams are forgotten. Returns the lines
+  // logged.
+  std::size_t reportSubscribers(const std::vector<aggregator::SubscriberStats>& subscribers);
+
+ private:
+  std::unordered_map<std::string, lob::BookStats> books_;
+  std::unordered_map<std::string, aggregator::StreamStats> streams_;
+};
+
+}  // namespace hermeneutic::services::aggregator_service
@@ -84,6 +84,8 @@ int main(int argc, char** argv) {
         csv.flush();
         spdlog::info(publisher.format(view));
       });
+  // Only the top of book is published.
+  client.setLevelFilter(1, 0);
   client.start();
   spdlog::info("BBO client streaming from {}", endpoint);
 
@@ -0,0 +1,113 @@
+#include "services/cex_type1_service/broadcast.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace hermeneutic::services::cex_type1_service {
+
+FrameBroadcaster::FrameBroadcaster(const PayloadLog& log, PacingOptions pacing, bool stamp, std::size_t capacity)
+    : log_(log), pacing_(pacing), stamp_(stamp), ring_(capacity) {
+  if (capacity == 0) {
+    throw std::invalid_argument("broadcast ring capacity must be positive");
+  }
+}
+
+FrameBroadcaster::~FrameBroadcaster() {
+  stop();
+}
+
+void FrameBroadcaster::start() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (running_) {
+    return;
+  }
+  running_ = true;
+  producer_ = std::thread([this] { run(); });
+}
+
+void FrameBroadcaster::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  produced_.notify_all();
+  subscribed_.notify_all();
+  if (producer_.joinable()) {
+    producer_.join();
+  }
+}
+
+std::uint64_t FrameBroadcaster::subscribe() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++subscribers_;
+  subscribed_.notify_all();
+  return head_;
+}
+
+void FrameBroadcaster::unsubscribe() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (subscribers_ > 0) {
+    --subscribers_;
+  }
+}
+
+FrameBroadcaster::Frame FrameBroadcaster::next(std::uint64_t& cursor, std::uint64_t& skipped) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (running_ && cursor >= head_) {
+    ++waiting_;
+    produced_.wait(lock, [&] { return !running_ || cursor < head_; });
+    --waiting_;
+  }
+  if (!running_) {
+    return {};
+  }
+  const auto oldest = head_ > ring_.size() ? head_ - ring_.size() : 0;
+  if (cursor < oldest) {
+    skipped += oldest - cursor;
+    cursor = oldest;
+  }
+  return ring_[cursor++ % ring_.size()];
+}
+
+void FrameBroadcaster::run() {
+  LogCursor cursor(log_);
+  std::unique_ptr<Pacer> pacer;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (subscribers_ == 0) {
+        // Restart the schedule afterwards rather than catching up on the
+        // frames an idle feed never sent.
+        pacer.reset();
+        subscribed_.wait(lock, [&] { return !running_ || subscribers_ > 0; });
+      }
+      if (!running_) {
+        return;
+      }
+    }
+    if (!pacer) {
+      pacer = std::make_unique<Pacer>(pacing_);
+    }
+    const auto index = cursor.next();
+    pacer->wait(log_.timestampNs(index));
+    Frame frame{log_.line(index), nullptr};
+    if (stamp_) {
+      auto stamped = std::make_shared<std::string>(frame.payload);
+      appendSendTimestamp(*stamped);
+      frame.payload = *stamped;
+      frame.stamped = std::move(stamped);
+    }
+    bool wake = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ring_[head_ % ring_.size()] = std::move(frame);
+      ++head_;
+      wake = waiting_ > 0;
+    }
+    if (wake) {
+      produced_.notify_all();
+    }
+  }
+}
+
+}  // namespace hermeneutic::services::cex_type1_service
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "services/cex_type1_service/replay.hpp"
+
+namespace hermeneutic::services::cex_type1_service {
+
+// Replays a PayloadLog once for every connected client: a single producer
+// thread paces the log and appends each frame to a ring that every
+// subscriber reads at its own pace. All clients therefore see the same
+// sequence. Unstamped frames are views into the log itself; a stamped
+// frame is built once into a shared buffer however many sockets it goes to.
+//
+// The producer idles while nobody is subscribed. A subscriber that falls a
+// full ring behind skips to the oldest retained frame.
+class FrameBroadcaster {
+ public:
+  // Valid while the log lives; `stamped` owns the bytes when the frame was
+  // stamped and is null otherwise.
+  struct Frame {
+    std::string_view payload;
+    std::shared_ptr<const std::string> stamped;
+
+    explicit operator bool() const { return payload.data() != nullptr; }
+  };
+
+  FrameBroadcaster(const PayloadLog& log, PacingOptions pacing, bool stamp, std::size_t capacity = 65536);
+  ~FrameBroadcaster();
+
+  FrameBroadcaster(const FrameBroadcaster&) = delete;
+  FrameBroadcaster& operator=(const FrameBroadcaster&) = delete;
+
+  void start();
+  // Wakes every waiting subscriber; next() then returns null.
+  void stop();
+
+  // Position of the next frame to be produced; pass it to next().
+  std::uint64_t subscribe();
+  void unsubscribe();
+
+  // Blocks until the frame at `cursor` exists, returns it and advances the
+  // cursor. Frames lost to lag are added to `skipped`. Returns an empty
+  // frame once stopped.
+  Frame next(std::uint64_t& cursor, std::uint64_t& skipped);
+
+ private:
+  void run();
+
+  const PayloadLog& log_;
+  PacingOptions pacing_;
+  bool stamp_;
+  std::vector<Frame> ring_;
+  std::mutex mutex_;
+  std::condition_variable produced_;
+  std::condition_variable subscribed_;
+  std::uint64_t head_{0};
+  std::size_t subscribers_{0};
+  // Subscribers blocked in next(); the producer skips the wakeup when
+  // everyone is still busy sending.
+  std::size_t waiting_{0};
+  bool running_{false};
+  std::thread producer_;
+};
+
+}  // namespace hermeneutic::services::cex_type1_service
@@ -7,115 +7,55 @@
 #include <Poco/Net/HTTPServerResponse.h>
 #include <Poco/Net/ServerSocket.h>
 #include <Poco/Net/WebSocket.h>
+#include <Poco/ThreadPool.h>
 #include <Poco/Timespan.h>
 #include <Poco/Util/ServerApplication.h>
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
-#include <cctype>
 #include <csignal>
 #include <cstdint>
 #include <cstdlib>
-#include <fstream>
 #include <memory>
-#include <mutex>
 #include <spdlog/spdlog.h>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <vector>
+
+#include "services/cex_type1_service/broadcast.hpp"
+#include "services/cex_type1_service/replay.hpp"
 
 namespace {
+using hermeneutic::services::cex_type1_service::appendSendTimestamp;
+using hermeneutic::services::cex_type1_service::FrameBroadcaster;
+using hermeneutic::services::cex_type1_service::LogCursor;
+using hermeneutic::services::cex_type1_service::Pacer;
+using hermeneutic::services::cex_type1_service::PacingOptions;
+using hermeneutic::services::cex_type1_service::PayloadLog;
+
 std::atomic<bool> g_running{true};
 
 void handleSignal(int) {
   g_running = false;
 }
 
-class PayloadCycler {
- public:
-  PayloadCycler(std::string path, std::uint64_t skip_until)
-      : path_(std::move(path)), skip_until_(skip_until), past_threshold_(skip_until == 0) {
-    reopen();
-  }
-
-  std::string next() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (;;) {
-      std::string line;
-      if (!std::getline(stream_, line)) {
-        reopen();
-        continue;
-      }
-      if (line.empty()) {
-        continue;
-      }
-      if (!past_threshold_) {
-        if (!sequenceAllows(line)) {
-          continue;
-        }
-        past_threshold_ = true;
-      }
-      return line;
-    }
-  }
-
- private:
-  void reopen() {
-    stream_.close();
-    stream_.clear();
-    stream_.open(path_);
-    if (!stream_.is_open()) {
-      throw std::runtime_error("could not open feed file: " + path_);
-    }
-  }
-
-  bool sequenceAllows(const std::string& line) const {
-    if (skip_until_ == 0) {
-      return true;
-    }
-    auto sequence = extractSequence(line);
-    return sequence >= skip_until_;
-  }
-
-  std::uint64_t extractSequence(const std::string& line) const {
-    auto pos = line.find("\"sequence\"");
-    if (pos == std::string::npos) {
-      return 0;
-    }
-    pos = line.find(':', pos);
-    if (pos == std::string::npos) {
-      return 0;
-    }
-    ++pos;
-    while (pos < line.size() && std::isspace(static_cast<unsigned char>(line[pos]))) {
-      ++pos;
-    }
-    std::size_t start = pos;
-    while (pos < line.size() && std::isdigit(static_cast<unsigned char>(line[pos]))) {
-      ++pos;
-    }
-    if (start == pos) {
-      return 0;
-    }
-    return std::strtoull(line.c_str() + start, nullptr, 10);
-  }
+struct FeedSource {
+  PayloadLog log;
+  PacingOptions pacing;
+  bool stamp{false};
+  // Set in broadcast mode; otherwise every connection replays on its own.
+  std::unique_ptr<FrameBroadcaster> broadcaster;
 
-  std::string path_;
-  std::ifstream stream_;
-  std::uint64_t skip_until_;
-  bool past_threshold_;
-  std::mutex mutex_;
+  FeedSource(PayloadLog payloads, PacingOptions pacing_options, bool stamp_frames)
+      : log(std::move(payloads)), pacing(pacing_options), stamp(stamp_frames) {}
 };
 
 class FeedRequestHandler : public Poco::Net::HTTPRequestHandler {
  public:
-  FeedRequestHandler(std::string exchange,
-                     std::string token,
-                     std::shared_ptr<PayloadCycler> payloads,
-                     std::chrono::milliseconds interval)
-      : exchange_(std::move(exchange)),
-        token_(std::move(token)),
-        payloads_(std::move(payloads)),
-        interval_(interval) {}
+  FeedRequestHandler(std::string exchange, std::string token, std::shared_ptr<FeedSource> source)
+      : exchange_(std::move(exchange)), token_(std::move(token)), source_(std::move(source)) {}
 
   void handleRequest(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response) override {
     const auto auth = request.get("Authorization", "");
@@ -130,10 +70,10 @@ class FeedRequestHandler : public Poco::Net::HTTPRequestHandler {
       ws.setSendTimeout(Poco::Timespan(5, 0));
       ws.setReceiveTimeout(Poco::Timespan(5, 0));
       spdlog::info("{} client connected", exchange_);
-      while (g_running.load()) {
-        auto payload = payloads_->next();
-        ws.sendFrame(payload.data(), static_cast<int>(payload.size()), Poco::Net::WebSocket::FRAME_TEXT);
-        std::this_thread::sleep_for(interval_);
+      if (source_->broadcaster) {
+        serveBroadcast(ws);
+      } else {
+        serveOwnReplay(ws);
       }
     } catch (const std::exception& ex) {
       spdlog::warn("{} WebSocket error: {}", exchange_, ex.what());
@@ -141,82 +81,187 @@ class FeedRequestHandler : public Poco::Net::HTTPRequestHandler {
   }
 
  private:
+  // A cursor and schedule of its own: the client sees the whole log from
+  // the start sequence, whoever else is connected.
+  void serveOwnReplay(Poco::Net::WebSocket& ws) {
+    LogCursor cursor(source_->log);
+    Pacer pacer(source_->pacing);
+    std::string stamped;
+    while (g_running.load(std::memory_order_relaxed)) {
+      const auto index = cursor.next();
+      pacer.wait(source_->log.timestampNs(index));
+      auto payload = source_->log.line(index);
+      if (source_->stamp) {
+        stamped.assign(payload);
+        appendSendTimestamp(stamped);
+        payload = stamped;
+      }
+      ws.sendFrame(payload.data(), static_cast<int>(payload.size()), Poco::Net::WebSocket::FRAME_TEXT);
+    }
+  }
+
+  // Joins the shared stream at its current position.
+  void serveBroadcast(Poco::Net::WebSocket& ws) {
+    auto& broadcaster = *source_->broadcaster;
+    auto cursor = broadcaster.subscribe();
+    std::uint64_t skipped = 0;
+    std::uint64_t reported = 0;
+    try {
+      while (g_running.load(std::memory_order_relaxed)) {
+        const auto frame = broadcaster.next(cursor, skipped);
+        if (!frame) {
+          break;
+        }
+        if (skipped != reported) {
+          spdlog::warn("{} client fell behind; skipped {} frames so far", exchange_, skipped);
+          reported = skipped;
+        }
+        ws.sendFrame(frame.payload.data(), static_cast<int>(frame.payload.size()), Poco::Net::WebSocket::FRAME_TEXT);
+      }
+    } catch (...) {
+      broadcaster.unsubscribe();
+      throw;
+    }
+    broadcaster.unsubscribe();
+  }
+
   std::string exchange_;
   std::string token_;
-  std::shared_ptr<PayloadCycler> payloads_;
-  std::chrono::milliseconds interval_;
+  std::shared_ptr<FeedSource> source_;
 };
 
 class FeedRequestFactory : public Poco::Net::HTTPRequestHandlerFactory {
  public:
-  FeedRequestFactory(std::string exchange,
-                     std::string token,
-                     std::shared_ptr<PayloadCycler> payloads,
-                     std::chrono::milliseconds interval)
-      : exchange_(std::move(exchange)),
-        token_(std::move(token)),
-        payloads_(std::move(payloads)),
-        interval_(interval) {}
+  FeedRequestFactory(std::string exchange, std::string token, std::shared_ptr<FeedSource> source)
+      : exchange_(std::move(exchange)), token_(std::move(token)), source_(std::move(source)) {}
 
   Poco::Net::HTTPRequestHandler* createRequestHandler(const Poco::Net::HTTPServerRequest& request) override {
     const auto expected_path = "/" + exchange_;
     if (request.getURI() != expected_path) {
       return nullptr;
     }
-    return new FeedRequestHandler(exchange_, token_, payloads_, interval_);
+    return new FeedRequestHandler(exchange_, token_, source_);
   }
 
  private:
   std::string exchange_;
   std::string token_;
-  std::shared_ptr<PayloadCycler> payloads_;
-  std::chrono::milliseconds interval_;
+  std::shared_ptr<FeedSource> source_;
 };
 
+constexpr const char* kUsage =
+    "Usage: cex_type1_service <exchange> <file> <port> <token> [interval_ms] [start_sequence] "
+    "[--rate msgs_per_sec] [--burst n] [--speed factor] [--stamp] [--fanout independent|broadcast] "
+    "[--max-clients n]";
+
 }  // namespace
 
 int main(int argc, char** argv) {
-  if (argc < 5) {
-    spdlog::error(
-        "Usage: cex_type1_service <exchange> <file> <port> <token> [interval_ms] [start_sequence]");
+  // Flags may appear anywhere; the rest stay positional.
+  bool stamp = false;
+  double rate = 0.0;
+  std::size_t burst = 1;
+  double speed = 0.0;
+  bool broadcast = false;
+  int max_clients = 16;
+  std::vector<std::string> args;
+  try {
+    for (int i = 1; i < argc; ++i) {
+      const std::string_view arg(argv[i]);
+      if (arg == "--stamp") {
+        stamp = true;
+      } else if ((arg == "--rate" || arg == "--burst" || arg == "--speed" || arg == "--fanout" ||
+                  arg == "--max-clients") &&
+                 i + 1 < argc) {
+        const std::string value = argv[++i];
+        if (arg == "--rate") {
+          rate = std::stod(value);
+        } else if (arg == "--burst") {
+          burst = std::stoul(value);
+        } else if (arg == "--speed") {
+          speed = std::stod(value);
+        } else if (arg == "--max-clients") {
+          max_clients = std::stoi(value);
+        } else if (value == "broadcast" || value == "independent") {
+          broadcast = value == "broadcast";
+        } else {
+          throw std::invalid_argument("unknown fanout " + value);
+        }
+      } else {
+        args.emplace_back(arg);
+      }
+    }
+  } catch (const std::exception&) {
+    spdlog::error(kUsage);
+    return 1;
+  }
+
+  if (args.size() < 4 || max_clients <= 0) {
+    spdlog::error(kUsage);
     return 1;
   }
 
-  const std::string exchange = argv[1];
-  const std::string file = argv[2];
-  const unsigned short port = static_cast<unsigned short>(std::stoi(argv[3]));
-  const std::string token = argv[4];
+  const std::string exchange = args[0];
+  const std::string file = args[1];
+  const unsigned short port = static_cast<unsigned short>(std::stoi(args[2]));
+  const std::string token = args[3];
   int interval_ms = 200;
-  if (argc > 5) {
-    interval_ms = std::stoi(argv[5]);
+  if (args.size() > 4) {
+    interval_ms = std::stoi(args[4]);
   }
 
   std::uint64_t start_sequence = 0;
-  if (argc > 6) {
-    start_sequence = std::strtoull(argv[6], nullptr, 10);
+  if (args.size() > 5) {
+    start_sequence = std::strtoull(args[5].c_str(), nullptr, 10);
   }
 
   try {
-    auto payloads = std::make_shared<PayloadCycler>(file, start_sequence);
+    auto log = PayloadLog::load(file, start_sequence);
+    PacingOptions pacing{.interval = std::chrono::milliseconds(interval_ms)};
+    std::string pacing_text = std::to_string(interval_ms) + " ms per message";
+    if (speed > 0 && log.hasTimestamps()) {
+      pacing = {.speed = speed};
+      pacing_text = "recorded timestamps at " + std::to_string(speed) + "x";
+    } else {
+      if (speed > 0) {
+        spdlog::warn("{} has no timestamp_ns fields; ignoring --speed", file);
+      }
+      if (rate > 0) {
+        pacing = hermeneutic::services::cex_type1_service::pacingForRate(rate, burst);
+        pacing_text = std::to_string(static_cast<long long>(rate)) + " msgs/s in bursts of " + std::to_string(burst);
+      }
+    }
+    spdlog::info("{} loaded {} messages from {}; pacing {}", exchange, log.size(), file, pacing_text);
+
+    auto source = std::make_shared<FeedSource>(std::move(log), pacing, stamp);
+    if (broadcast) {
+      source->broadcaster = std::make_unique<FrameBroadcaster>(source->log, source->pacing, stamp);
+      source->broadcaster->start();
+    }
     Poco::Net::ServerSocket socket(port);
     Poco::Net::HTTPServerParams::Ptr params = new Poco::Net::HTTPServerParams;
     params->setMaxQueued(10);
-    params->setMaxThreads(1);
-    Poco::Net::HTTPServer server(new FeedRequestFactory(exchange, token, payloads,
-                                                        std::chrono::milliseconds(interval_ms)),
-                                 socket,
-                                 params);
+    // Each WebSocket client holds a server thread for as long as it stays,
+    // so the server gets a pool of its own: the default pool stops at 16.
+    params->setMaxThreads(max_clients);
+    Poco::ThreadPool threads(std::min(2, max_clients), max_clients);
+    Poco::Net::HTTPServer server(new FeedRequestFactory(exchange, token, source), threads, socket, params);
 
     std::signal(SIGINT, handleSignal);
     std::signal(SIGTERM, handleSignal);
 
     server.start();
-    spdlog::info("{} feed serving {} on ws://localhost:{}/{}", exchange, file, port, exchange);
+    spdlog::info("{} feed serving {} on ws://localhost:{}/{} to up to {} clients ({}){}", exchange, file, port,
+                 exchange, max_clients, broadcast ? "one shared stream" : "independent replays",
+                 stamp ? ", stamping send times" : "");
 
     while (g_running.load()) {
       std::this_thread::sleep_for(std::chrono::milliseconds(200));
     }
 
+    if (source->broadcaster) {
+      source->broadcaster->stop();
+    }
     server.stop();
   } catch (const std::exception& ex) {
     spdlog::error("cex_type1_service failed: {}", ex.what());
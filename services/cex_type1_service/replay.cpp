@@ -0,0 +1,156 @@
+#include "services/cex_type1_service/replay.hpp"
+
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace hermeneutic::services::cex_type1_service {
+namespace {
+
+// Leading integer value of `"key":` in a flat JSON line, or 0.
+std::int64_t extractInteger(std::string_view line, std::string_view key) {
+  auto pos = line.find(key);
+  if (pos == std::string_view::npos) {
+    return 0;
+  }
+  pos = line.find(':', pos + key.size());
+  if (pos == std::string_view::npos) {
+    return 0;
+  }
+  ++pos;
+  while (pos < line.size() && std::isspace(static_cast<unsigned char>(line[pos]))) {
+    ++pos;
+  }
+  std::int64_t value = 0;
+  bool any = false;
+  while (pos < line.size() && std::isdigit(static_cast<unsigned char>(line[pos]))) {
+    value = value * 10 + (line[pos] - '0');
+    any = true;
+    ++pos;
+  }
+  return any ? value : 0;
+}
+
+constexpr auto kSpinThreshold = std::chrono::microseconds(200);
+
+}  // namespace
+
+PayloadLog PayloadLog::load(const std::string& path, std::uint64_t start_sequence) {
+  std::ifstream input(path, std::ios::binary);
+  if (!input.is_open()) {
+    throw std::runtime_error("could not open feed file: " + path);
+  }
+  std::ostringstream buffer;
+  buffer << input.rdbuf();
+  return fromString(std::move(buffer).str(), start_sequence);
+}
+
+PayloadLog PayloadLog::fromString(std::string data, std::uint64_t start_sequence) {
+  PayloadLog log;
+  log.data_ = std::move(data);
+  const std::string_view text(log.data_);
+  bool found_start = start_sequence == 0;
+  std::size_t offset = 0;
+  while (offset < text.size()) {
+    auto end = text.find('\n', offset);
+    if (end == std::string_view::npos) {
+      end = text.size();
+    }
+    auto length = end - offset;
+    if (length > 0 && text[offset + length - 1] == '\r') {
+      --length;
+    }
+    if (length > 0) {
+      const auto line = text.substr(offset, length);
+      const auto timestamp_ns = extractInteger(line, "\"timestamp_ns\"");
+      log.has_timestamps_ = log.has_timestamps_ || timestamp_ns != 0;
+      if (!found_start &&
+          static_cast<std::uint64_t>(extractInteger(line, "\"sequence\"")) >= start_sequence) {
+        log.start_index_ = log.lines_.size();
+        found_start = true;
+      }
+      log.lines_.push_back({offset, length, timestamp_ns});
+    }
+    offset = end + 1;
+  }
+  if (log.lines_.empty()) {
+    throw std::runtime_error("feed file has no messages");
+  }
+  return log;
+}
+
+void appendSendTimestamp(std::string& payload) {
+  const auto closing = payload.rfind('}');
+  if (closing == std::string::npos) {
+    return;
+  }
+  const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                       .count();
+  payload.insert(closing, ",\"timestamp_ns\":" + std::to_string(now));
+}
+
+PacingOptions pacingForRate(double rate, std::size_t burst) {
+  if (rate <= 0 || burst == 0) {
+    throw std::invalid_argument("rate and burst must be positive");
+  }
+  return {.interval = std::chrono::nanoseconds(static_cast<std::int64_t>(1e9 * static_cast<double>(burst) / rate)),
+          .burst = burst};
+}
+
+void waitUntil(std::chrono::steady_clock::time_point due) {
+  auto remaining = due - std::chrono::steady_clock::now();
+  if (remaining > kSpinThreshold) {
+    std::this_thread::sleep_until(due - kSpinThreshold / 2);
+  }
+  while (std::chrono::steady_clock::now() < due) {
+  }
+}
+
+Pacer::Pacer(PacingOptions options) : options_(options) {
+  if (options_.burst == 0) {
+    options_.burst = 1;
+  }
+}
+
+void Pacer::wait(std::int64_t timestamp_ns) {
+  const auto now = std::chrono::steady_clock::now();
+  if (options_.speed > 0) {
+    // Rebase on the first frame and whenever the recording steps backwards
+    // (the log wrapped around); frames without a stamp go out at once.
+    if (!started_ || (timestamp_ns != 0 && timestamp_ns < last_timestamp_ns_)) {
+      started_ = true;
+      due_ = now;
+      base_timestamp_ns_ = timestamp_ns;
+      last_timestamp_ns_ = timestamp_ns;
+      return;
+    }
+    if (timestamp_ns == 0) {
+      return;
+    }
+    if (base_timestamp_ns_ == 0) {
+      base_timestamp_ns_ = timestamp_ns;
+    }
+    last_timestamp_ns_ = timestamp_ns;
+    const auto offset = static_cast<double>(timestamp_ns - base_timestamp_ns_) / options_.speed;
+    waitUntil(due_ + std::chrono::nanoseconds(static_cast<std::int64_t>(offset)));
+    return;
+  }
+  if (options_.interval.count() == 0) {
+    return;
+  }
+  if (!started_) {
+    started_ = true;
+    due_ = now;
+  }
+  if (sent_in_burst_ == options_.burst) {
+    sent_in_burst_ = 0;
+    due_ += options_.interval;
+    waitUntil(due_);
+  }
+  ++sent_in_burst_;
+}
+
+}  // namespace hermeneutic::services::cex_type1_service
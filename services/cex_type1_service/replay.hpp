@@ -0,0 +1,103 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hermeneutic::services::cex_type1_service {
+
+// An NDJSON feed file read into memory once. Frames are sent straight out
+// of the buffer, so serving a line costs no I/O, allocation or lock.
+class PayloadLog {
+ public:
+  // Throws std::runtime_error when the file cannot be read or has no
+  // non-empty lines. Replay begins at the first line whose "sequence" is at
+  // least `start_sequence`; after wrapping it starts again from the top.
+  static PayloadLog load(const std::string& path, std::uint64_t start_sequence = 0);
+  static PayloadLog fromString(std::string data, std::uint64_t start_sequence = 0);
+
+  std::size_t size() const { return lines_.size(); }
+  std::size_t startIndex() const { return start_index_; }
+  std::string_view line(std::size_t index) const {
+    return std::string_view(data_).substr(lines_[index].offset, lines_[index].length);
+  }
+  // Recorded "timestamp_ns" of the line, or 0 when it has none.
+  std::int64_t timestampNs(std::size_t index) const { return lines_[index].timestamp_ns; }
+  bool hasTimestamps() const { return has_timestamps_; }
+
+ private:
+  struct Line {
+    std::size_t offset;
+    std::size_t length;
+    std::int64_t timestamp_ns;
+  };
+
+  std::string data_;
+  std::vector<Line> lines_;
+  std::size_t start_index_{0};
+  bool has_timestamps_{false};
+};
+
+// One reader's position in a PayloadLog: the first pass starts at the
+// log's start index, later passes from the top.
+class LogCursor {
+ public:
+  explicit LogCursor(const PayloadLog& log) : log_(log), next_(log.startIndex()) {}
+
+  std::size_t next() {
+    const auto index = next_;
+    next_ = next_ + 1 == log_.size() ? 0 : next_ + 1;
+    return index;
+  }
+
+ private:
+  const PayloadLog& log_;
+  std::size_t next_;
+};
+
+// Appends the current time as "timestamp_ns" before the closing brace, so
+// downstream latency can be measured from the moment the frame is sent. It
+// goes last so it wins over any recorded timestamp in the line.
+void appendSendTimestamp(std::string& payload);
+
+struct PacingOptions {
+  // Gap between bursts; zero sends as fast as the socket takes frames.
+  std::chrono::nanoseconds interval{0};
+  // Frames sent back to back per interval.
+  std::size_t burst{1};
+  // When positive, frames follow the gaps between their recorded
+  // timestamp_ns divided by this factor instead of `interval`.
+  double speed{0.0};
+};
+
+// `rate` messages per second in bursts of `burst`.
+PacingOptions pacingForRate(double rate, std::size_t burst = 1);
+
+// Blocks until `due`: sleeps while the wait is long and spins for the last
+// stretch, since sleeping for a few microseconds overshoots by far more.
+void waitUntil(std::chrono::steady_clock::time_point due);
+
+// Releases frames on a fixed schedule anchored at the first frame, so a
+// slow send eats into the next gap instead of lowering the rate. Not
+// thread-safe; each connection owns one.
+class Pacer {
+ public:
+  explicit Pacer(PacingOptions options);
+
+  // Waits until the next frame, recorded at `timestamp_ns` (0 if unknown),
+  // may be sent.
+  void wait(std::int64_t timestamp_ns = 0);
+
+ private:
+  PacingOptions options_;
+  bool started_{false};
+  std::chrono::steady_clock::time_point due_{};
+  std::size_t sent_in_burst_{0};
+  std::int64_t base_timestamp_ns_{0};
+  std::int64_t last_timestamp_ns_{0};
+};
+
+}  // namespace hermeneutic::services::cex_type1_service
@@ -0,0 +1,85 @@
+#include "common/book_mirror.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "common/grpc_helpers.hpp"
+
+namespace hermeneutic::services {
+
+using hermeneutic::common::Decimal;
+using hermeneutic::common::PriceLevel;
+
+bool BookMirror::apply(const hermeneutic::grpc::BookUpdate& update) {
+  if (update.snapshot()) {
+    view_ = grpc_helpers::ToDomain(update.book());
+    sequence_ = update.sequence();
+    synced_ = true;
+    return true;
+  }
+  if (!synced_ || update.sequence() != sequence_ + 1) {
+    synced_ = false;
+    return false;
+  }
+  grpc_helpers::ToDomainHeader(update.book(), view_);
+  const bool fixed = update.book().has_fixed();
+  const auto scale = fixed ? grpc_helpers::FixedPointScale(update.book().fixed()) : 0;
+  for (const auto& delta : update.deltas()) {
+    if (!applyDelta(delta, fixed, scale)) {
+      synced_ = false;
+      return false;
+    }
+  }
+  sequence_ = update.sequence();
+  return true;
+}
+
+void BookMirror::reset() {
+  view_ = {};
+  sequence_ = 0;
+  synced_ = false;
+}
+
+bool BookMirror::applyDelta(const hermeneutic::grpc::LevelDelta& delta, bool fixed, int scale) {
+  const bool bids = delta.side() == hermeneutic::grpc::BOOK_SIDE_BID;
+  auto& levels = bids ? view_.bid_levels : view_.ask_levels;
+  PriceLevel level;
+  if (fixed) {
+    level.price = Decimal::fromScaled(delta.price(), scale);
+    level.quantity = Decimal::fromScaled(delta.quantity(), scale);
+  } else {
+    level.price = Decimal::fromString(delta.level().price());
+    if (delta.action() != hermeneutic::grpc::LEVEL_ACTION_DELETE) {
+      level.quantity = Decimal::fromString(delta.level().quantity());
+    }
+  }
+  auto it = std::lower_bound(levels.begin(), levels.end(), level.price,
+                             [bids](const PriceLevel& lhs, const Decimal& price) {
+                               return bids ? lhs.price > price : lhs.price < price;
+                             });
+  const bool found = it != levels.end() && it->price == level.price;
+  switch (delta.action()) {
+    case hermeneutic::grpc::LEVEL_ACTION_INSERT:
+      if (found) {
+        return false;
+      }
+      levels.insert(it, level);
+      return true;
+    case hermeneutic::grpc::LEVEL_ACTION_UPDATE:
+      if (!found) {
+        return false;
+      }
+      it->quantity = level.quantity;
+      return true;
+    case hermeneutic::grpc::LEVEL_ACTION_DELETE:
+      if (!found) {
+        return false;
+      }
+      levels.erase(it);
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace hermeneutic::services
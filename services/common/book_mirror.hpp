@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+#include "aggregator.grpc.pb.h"
+#include "hermeneutic/common/events.hpp"
+
+namespace hermeneutic::services {
+
+// Client-side copy of an aggregated book kept up to date from a
+// StreamBookUpdates stream. apply() returns false when the update cannot be
+// applied (sequence gap, delta against a missing level, or no snapshot
+// yet); the mirror then stays unsynced until the next snapshot.
+class BookMirror {
+ public:
+  bool apply(const hermeneutic::grpc::BookUpdate& update);
+  void reset();
+
+  bool synced() const { return synced_; }
+  std::uint64_t sequence() const { return sequence_; }
+  const hermeneutic::common::AggregatedBookView& view() const { return view_; }
+
+ private:
+  bool applyDelta(const hermeneutic::grpc::LevelDelta& delta, bool fixed, int scale);
+
+  hermeneutic::common::AggregatedBookView view_;
+  std::uint64_t sequence_{0};
+  bool synced_{false};
+};
+
+}  // namespace hermeneutic::services
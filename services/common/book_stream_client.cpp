@@ -1,5 +1,7 @@
 #include "common/book_stream_client.hpp"
 
+#include <utility>
+
 #include <spdlog/spdlog.h>
 
 #include "common/grpc_helpers.hpp"
@@ -40,6 +42,12 @@ BookStreamClient::BookStreamClient(ChannelFactory channel_factory,
 
 BookStreamClient::~BookStreamClient() { stop(); }
 
+void BookStreamClient::setLevelFilter(std::uint32_t max_depth, std::uint32_t window_bps) {
+  HERMENEUTIC_ASSERT_DEBUG(!running_.load(), "level filter must be set before start()");
+  max_depth_ = max_depth;
+  window_bps_ = window_bps;
+}
+
 void BookStreamClient::start() {
   if (running_.exchange(true)) {
     return;
@@ -65,6 +73,7 @@ void BookStreamClient::cancelActiveContext() {
 }
 
 void BookStreamClient::run() {
+  bool resync = false;
   while (running_.load()) {
     std::shared_ptr<::grpc::Channel> channel;
     if (channel_factory_) {
@@ -85,23 +94,74 @@ void BookStreamClient::run() {
     hermeneutic::services::grpc_helpers::AttachAuth(context, token_);
     hermeneutic::grpc::SubscribeRequest request;
     request.set_symbol(symbol_);
+    request.set_encoding(hermeneutic::grpc::BOOK_ENCODING_FIXED_POINT);
+    request.set_max_depth(max_depth_);
+    request.set_window_bps(window_bps_);
 
-    auto reader = stub->StreamBooks(&context, request);
-    hermeneutic::grpc::AggregatedBook message;
-    while (running_.load() && reader->Read(&message)) {
-      auto view = hermeneutic::services::grpc_helpers::ToDomain(message);
-      if (callback_) {
-        callback_(view);
+    resync = false;
+    // StreamBooks is a fallback for one connection only; the next attempt
+    // tries StreamBookUpdates again in case the server has been upgraded.
+    const bool full_books = std::exchange(full_books_, false);
+    ::grpc::Status status;
+    if (full_books) {
+      auto reader = stub->StreamBooks(&context, request);
+      hermeneutic::grpc::AggregatedBook message;
+      while (running_.load() && reader->Read(&message)) {
+        hermeneutic::common::AggregatedBookView view;
+        try {
+          view = hermeneutic::services::grpc_helpers::ToDomain(message);
+        } catch (const std::exception& ex) {
+          spdlog::warn("BookStreamClient dropping stream after a malformed book: {}", ex.what());
+          context.TryCancel();
+          break;
+        }
+        if (callback_) {
+          callback_(view);
+        }
+      }
+      clearActiveContext();
+      status = reader->Finish();
+    } else {
+      auto reader = stub->StreamBookUpdates(&context, request);
+      hermeneutic::grpc::BookUpdate update;
+      mirror_.reset();
+      while (running_.load() && reader->Read(&update)) {
+        bool applied = false;
+        try {
+          applied = mirror_.apply(update);
+        } catch (const std::exception& ex) {
+          // Not a gap: a fresh snapshot would be just as malformed, so back
+          // off like any other stream error.
+          spdlog::warn("BookStreamClient dropping stream after a malformed update: {}", ex.what());
+          context.TryCancel();
+          break;
+        }
+        if (!applied) {
+          spdlog::warn("BookStreamClient lost sync at update {} (expected {}), resyncing", update.sequence(),
+                       mirror_.sequence() + 1);
+          resync = true;
+          context.TryCancel();
+          break;
+        }
+        if (callback_) {
+          callback_(mirror_.view());
+        }
+      }
+      clearActiveContext();
+      status = reader->Finish();
+      if (status.error_code() == ::grpc::StatusCode::UNIMPLEMENTED) {
+        spdlog::info("BookStreamClient server has no StreamBookUpdates, using StreamBooks");
+        full_books_ = true;
+        continue;
       }
     }
-    {
-      std::lock_guard<std::mutex> lock(context_mutex_);
-      active_context_ = nullptr;
-    }
-    auto status = reader->Finish();
     if (!running_.load()) {
       break;
     }
+    if (resync) {
+      // A fresh stream starts with a snapshot; no need to back off.
+      continue;
+    }
     if (!status.ok()) {
       spdlog::warn("BookStreamClient reconnect after error: {}", status.error_message());
     } else {
@@ -111,4 +171,9 @@ void BookStreamClient::run() {
   }
 }
 
+void BookStreamClient::clearActiveContext() {
+  std::lock_guard<std::mutex> lock(context_mutex_);
+  active_context_ = nullptr;
+}
+
 }  // namespace hermeneutic::services
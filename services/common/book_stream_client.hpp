@@ -2,6 +2,7 @@
 
 #include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -11,11 +12,16 @@
 #include <grpcpp/grpcpp.h>
 
 #include "aggregator.grpc.pb.h"
+#include "common/book_mirror.hpp"
 #include "hermeneutic/common/assert.hpp"
 #include "hermeneutic/common/events.hpp"
 
 namespace hermeneutic::services {
 
+// Streams aggregated books from the aggregator service. Subscribes through
+// StreamBookUpdates and keeps a BookMirror, so the callback sees a full view
+// while only changed levels cross the wire; a sequence gap reopens the
+// stream to resync. Falls back to StreamBooks against servers without it.
 class BookStreamClient {
  public:
   using Callback = std::function<void(const hermeneutic::common::AggregatedBookView&)>;
@@ -33,12 +39,18 @@ class BookStreamClient {
                    std::chrono::milliseconds reconnect_delay = std::chrono::milliseconds(500));
   ~BookStreamClient();
 
+  // Asks the server to trim each side to `max_depth` levels and/or to levels
+  // within `window_bps` of the best price (0 disables either). Servers that
+  // predate the fields keep sending full depth.
+  void setLevelFilter(std::uint32_t max_depth, std::uint32_t window_bps);
+
   void start();
   void stop();
 
  private:
   void run();
   void cancelActiveContext();
+  void clearActiveContext();
 
   std::string endpoint_;
   ChannelFactory channel_factory_;
@@ -50,6 +62,10 @@ class BookStreamClient {
   std::thread worker_;
   std::mutex context_mutex_;
   ::grpc::ClientContext* active_context_{nullptr};
+  std::uint32_t max_depth_{0};
+  std::uint32_t window_bps_{0};
+  BookMirror mirror_;
+  bool full_books_{false};
 };
 
 }  // namespace hermeneutic::services
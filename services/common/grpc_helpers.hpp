@@ -2,21 +2,61 @@
 
 #include <grpcpp/grpcpp.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include "aggregator.grpc.pb.h"
 #include "hermeneutic/common/events.hpp"
 
 namespace hermeneutic::services::grpc_helpers {
 
-inline hermeneutic::common::AggregatedBookView ToDomain(
-    const hermeneutic::grpc::AggregatedBook& message) {
-  hermeneutic::common::AggregatedBookView view;
-  view.best_bid.price = hermeneutic::common::Decimal::fromString(message.best_bid().price());
-  view.best_bid.quantity = hermeneutic::common::Decimal::fromString(message.best_bid().quantity());
-  view.best_ask.price = hermeneutic::common::Decimal::fromString(message.best_ask().price());
-  view.best_ask.quantity = hermeneutic::common::Decimal::fromString(message.best_ask().quantity());
+// Scale of BOOK_ENCODING_FIXED_POINT messages; matches the eight decimals
+// of the string encoding.
+inline constexpr std::uint32_t kFixedPointScale = 8;
+
+// Scale of a received FixedPointBook. Throws std::invalid_argument for a
+// scale Decimal cannot represent rather than clamping it, which would
+// silently rescale every price.
+inline int FixedPointScale(const hermeneutic::grpc::FixedPointBook& fixed) {
+  if (fixed.scale() > static_cast<std::uint32_t>(hermeneutic::common::Decimal::kScaleDigits)) {
+    throw std::invalid_argument("fixed-point book scale " + std::to_string(fixed.scale()) + " exceeds " +
+                                std::to_string(hermeneutic::common::Decimal::kScaleDigits));
+  }
+  return static_cast<int>(fixed.scale());
+}
+
+inline void ToDomainLevels(const ::google::protobuf::RepeatedField<std::int64_t>& packed,
+                           int scale,
+                           std::vector<hermeneutic::common::PriceLevel>& levels) {
+  using hermeneutic::common::Decimal;
+  levels.reserve(static_cast<std::size_t>(packed.size() / 2));
+  for (int i = 0; i + 1 < packed.size(); i += 2) {
+    levels.push_back({Decimal::fromScaled(packed[i], scale), Decimal::fromScaled(packed[i + 1], scale)});
+  }
+}
+
+// Everything but the depth ladders: best quotes, exchange count, timestamps.
+inline void ToDomainHeader(const hermeneutic::grpc::AggregatedBook& message,
+                           hermeneutic::common::AggregatedBookView& view) {
+  if (message.has_fixed()) {
+    const auto& fixed = message.fixed();
+    const auto scale = FixedPointScale(fixed);
+    if (fixed.best_size() == 4) {
+      view.best_bid.price = hermeneutic::common::Decimal::fromScaled(fixed.best(0), scale);
+      view.best_bid.quantity = hermeneutic::common::Decimal::fromScaled(fixed.best(1), scale);
+      view.best_ask.price = hermeneutic::common::Decimal::fromScaled(fixed.best(2), scale);
+      view.best_ask.quantity = hermeneutic::common::Decimal::fromScaled(fixed.best(3), scale);
+    }
+  } else {
+    view.best_bid.price = hermeneutic::common::Decimal::fromString(message.best_bid().price());
+    view.best_bid.quantity = hermeneutic::common::Decimal::fromString(message.best_bid().quantity());
+    view.best_ask.price = hermeneutic::common::Decimal::fromString(message.best_ask().price());
+    view.best_ask.quantity = hermeneutic::common::Decimal::fromString(message.best_ask().quantity());
+  }
   view.exchange_count = message.exchange_count();
   auto to_time_point = [](auto duration) {
     return std::chrono::system_clock::time_point(
@@ -31,6 +71,24 @@ inline hermeneutic::common::AggregatedBookView ToDomain(
     view.timestamp = to_time_point(ms);
     view.publish_timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(ms).count();
   }
+  view.last_feed_timestamp_ns = message.last_feed_timestamp_ns();
+  view.last_local_timestamp_ns = message.last_local_timestamp_ns();
+  view.min_feed_timestamp_ns = message.min_feed_timestamp_ns();
+  view.max_feed_timestamp_ns = message.max_feed_timestamp_ns();
+  view.min_local_timestamp_ns = message.min_local_timestamp_ns();
+  view.max_local_timestamp_ns = message.max_local_timestamp_ns();
+}
+
+inline hermeneutic::common::AggregatedBookView ToDomain(
+    const hermeneutic::grpc::AggregatedBook& message) {
+  hermeneutic::common::AggregatedBookView view;
+  ToDomainHeader(message, view);
+  if (message.has_fixed()) {
+    const auto scale = FixedPointScale(message.fixed());
+    ToDomainLevels(message.fixed().bid_levels(), scale, view.bid_levels);
+    ToDomainLevels(message.fixed().ask_levels(), scale, view.ask_levels);
+    return view;
+  }
   view.bid_levels.reserve(message.bid_levels_size());
   for (const auto& level : message.bid_levels()) {
     view.bid_levels.push_back({hermeneutic::common::Decimal::fromString(level.price()),
@@ -41,24 +99,40 @@ inline hermeneutic::common::AggregatedBookView ToDomain(
     view.ask_levels.push_back({hermeneutic::common::Decimal::fromString(level.price()),
                                hermeneutic::common::Decimal::fromString(level.quantity())});
   }
-  view.last_feed_timestamp_ns = message.last_feed_timestamp_ns();
-  view.last_local_timestamp_ns = message.last_local_timestamp_ns();
-  view.min_feed_timestamp_ns = message.min_feed_timestamp_ns();
-  view.max_feed_timestamp_ns = message.max_feed_timestamp_ns();
-  view.min_local_timestamp_ns = message.min_local_timestamp_ns();
-  view.max_local_timestamp_ns = message.max_local_timestamp_ns();
   return view;
 }
 
-inline hermeneutic::grpc::AggregatedBook FromDomain(
-    const hermeneutic::common::AggregatedBookView& view) {
+inline void FromDomainLevels(const std::vector<hermeneutic::common::PriceLevel>& levels,
+                             ::google::protobuf::RepeatedField<std::int64_t>& packed) {
+  packed.Reserve(static_cast<int>(2 * levels.size()));
+  for (const auto& level : levels) {
+    packed.AddAlreadyReserved(level.price.toScaled(kFixedPointScale));
+    packed.AddAlreadyReserved(level.quantity.toScaled(kFixedPointScale));
+  }
+}
+
+// Book message without depth ladders (see ToDomainHeader).
+inline hermeneutic::grpc::AggregatedBook FromDomainHeader(
+    const hermeneutic::common::AggregatedBookView& view,
+    hermeneutic::grpc::BookEncoding encoding = hermeneutic::grpc::BOOK_ENCODING_DECIMAL_STRING) {
   hermeneutic::grpc::AggregatedBook message;
-  auto* bid = message.mutable_best_bid();
-  bid->set_price(view.best_bid.price.toString(8));
-  bid->set_quantity(view.best_bid.quantity.toString(8));
-  auto* ask = message.mutable_best_ask();
-  ask->set_price(view.best_ask.price.toString(8));
-  ask->set_quantity(view.best_ask.quantity.toString(8));
+  if (encoding == hermeneutic::grpc::BOOK_ENCODING_FIXED_POINT) {
+    auto* fixed = message.mutable_fixed();
+    fixed->set_scale(kFixedPointScale);
+    auto* best = fixed->mutable_best();
+    best->Reserve(4);
+    best->AddAlreadyReserved(view.best_bid.price.toScaled(kFixedPointScale));
+    best->AddAlreadyReserved(view.best_bid.quantity.toScaled(kFixedPointScale));
+    best->AddAlreadyReserved(view.best_ask.price.toScaled(kFixedPointScale));
+    best->AddAlreadyReserved(view.best_ask.quantity.toScaled(kFixedPointScale));
+  } else {
+    auto* bid = message.mutable_best_bid();
+    bid->set_price(view.best_bid.price.toString(8));
+    bid->set_quantity(view.best_bid.quantity.toString(8));
+    auto* ask = message.mutable_best_ask();
+    ask->set_price(view.best_ask.price.toString(8));
+    ask->set_quantity(view.best_ask.quantity.toString(8));
+  }
   message.set_exchange_count(static_cast<std::uint32_t>(view.exchange_count));
   auto duration = view.timestamp.time_since_epoch();
   auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(duration);
@@ -66,6 +140,24 @@ inline hermeneutic::grpc::AggregatedBook FromDomain(
   auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration);
   const auto publish_ns = view.publish_timestamp_ns != 0 ? view.publish_timestamp_ns : ns.count();
   message.set_publish_timestamp_ns(publish_ns);
+  message.set_last_feed_timestamp_ns(view.last_feed_timestamp_ns);
+  message.set_last_local_timestamp_ns(view.last_local_timestamp_ns);
+  message.set_min_feed_timestamp_ns(view.min_feed_timestamp_ns);
+  message.set_max_feed_timestamp_ns(view.max_feed_timestamp_ns);
+  message.set_min_local_timestamp_ns(view.min_local_timestamp_ns);
+  message.set_max_local_timestamp_ns(view.max_local_timestamp_ns);
+  return message;
+}
+
+inline hermeneutic::grpc::AggregatedBook FromDomain(
+    const hermeneutic::common::AggregatedBookView& view,
+    hermeneutic::grpc::BookEncoding encoding = hermeneutic::grpc::BOOK_ENCODING_DECIMAL_STRING) {
+  auto message = FromDomainHeader(view, encoding);
+  if (encoding == hermeneutic::grpc::BOOK_ENCODING_FIXED_POINT) {
+    FromDomainLevels(view.bid_levels, *message.mutable_fixed()->mutable_bid_levels());
+    FromDomainLevels(view.ask_levels, *message.mutable_fixed()->mutable_ask_levels());
+    return message;
+  }
   for (const auto& level : view.bid_levels) {
     auto* proto_level = message.add_bid_levels();
     proto_level->set_price(level.price.toString(8));
@@ -76,19 +168,83 @@ inline hermeneutic::grpc::AggregatedBook FromDomain(
     proto_level->set_price(level.price.toString(8));
     proto_level->set_quantity(level.quantity.toString(8));
   }
-  message.set_last_feed_timestamp_ns(view.last_feed_timestamp_ns);
-  message.set_last_local_timestamp_ns(view.last_local_timestamp_ns);
-  message.set_min_feed_timestamp_ns(view.min_feed_timestamp_ns);
-  message.set_max_feed_timestamp_ns(view.max_feed_timestamp_ns);
-  message.set_min_local_timestamp_ns(view.min_local_timestamp_ns);
-  message.set_max_local_timestamp_ns(view.max_local_timestamp_ns);
   return message;
 }
 
+inline void AddLevelDelta(hermeneutic::grpc::BookUpdate& update,
+                          hermeneutic::grpc::BookSide side,
+                          hermeneutic::grpc::LevelAction action,
+                          const hermeneutic::common::PriceLevel& level,
+                          hermeneutic::grpc::BookEncoding encoding) {
+  auto* delta = update.add_deltas();
+  delta->set_side(side);
+  delta->set_action(action);
+  const bool with_quantity = action != hermeneutic::grpc::LEVEL_ACTION_DELETE;
+  if (encoding == hermeneutic::grpc::BOOK_ENCODING_FIXED_POINT) {
+    delta->set_price(level.price.toScaled(kFixedPointScale));
+    if (with_quantity) {
+      delta->set_quantity(level.quantity.toScaled(kFixedPointScale));
+    }
+  } else {
+    delta->mutable_level()->set_price(level.price.toString(8));
+    if (with_quantity) {
+      delta->mutable_level()->set_quantity(level.quantity.toString(8));
+    }
+  }
+}
+
+// Appends the inserts/updates/deletes that turn `previous` into `current`.
+// Both ladders are best level first, so a single merge pass suffices.
+inline void AppendLevelDeltas(const std::vector<hermeneutic::common::PriceLevel>& previous,
+                              const std::vector<hermeneutic::common::PriceLevel>& current,
+                              hermeneutic::grpc::BookSide side,
+                              hermeneutic::grpc::BookEncoding encoding,
+                              hermeneutic::grpc::BookUpdate& update) {
+  const bool bids = side == hermeneutic::grpc::BOOK_SIDE_BID;
+  auto ahead = [bids](const hermeneutic::common::Decimal& lhs, const hermeneutic::common::Decimal& rhs) {
+    return bids ? lhs > rhs : lhs < rhs;
+  };
+  std::size_t i = 0;
+  std::size_t j = 0;
+  while (i < previous.size() || j < current.size()) {
+    if (j == current.size() || (i < previous.size() && ahead(previous[i].price, current[j].price))) {
+      AddLevelDelta(update, side, hermeneutic::grpc::LEVEL_ACTION_DELETE, previous[i++], encoding);
+    } else if (i == previous.size() || ahead(current[j].price, previous[i].price)) {
+      AddLevelDelta(update, side, hermeneutic::grpc::LEVEL_ACTION_INSERT, current[j++], encoding);
+    } else {
+      if (previous[i].quantity != current[j].quantity) {
+        AddLevelDelta(update, side, hermeneutic::grpc::LEVEL_ACTION_UPDATE, current[j], encoding);
+      }
+      ++i;
+      ++j;
+    }
+  }
+}
+
+// Builds StreamBookUpdates message `sequence`: a snapshot when `previous`
+// is null, otherwise the header plus the level deltas since `previous`.
+inline hermeneutic::grpc::BookUpdate FromDomainUpdate(
+    const hermeneutic::common::AggregatedBookView* previous,
+    const hermeneutic::common::AggregatedBookView& current,
+    std::uint64_t sequence,
+    hermeneutic::grpc::BookEncoding encoding = hermeneutic::grpc::BOOK_ENCODING_DECIMAL_STRING) {
+  hermeneutic::grpc::BookUpdate update;
+  update.set_sequence(sequence);
+  if (previous == nullptr) {
+    update.set_snapshot(true);
+    *update.mutable_book() = FromDomain(current, encoding);
+    return update;
+  }
+  *update.mutable_book() = FromDomainHeader(current, encoding);
+  AppendLevelDeltas(previous->bid_levels, current.bid_levels, hermeneutic::grpc::BOOK_SIDE_BID, encoding, update);
+  AppendLevelDeltas(previous->ask_levels, current.ask_levels, hermeneutic::grpc::BOOK_SIDE_ASK, encoding, update);
+  return update;
+}
+
 inline void AttachAuth(::grpc::ClientContext& context, const std::string& token) {
   if (!token.empty()) {
     context.AddMetadata("authorization", "Bearer " + token);
   }
 }
-  
+
 }  // namespace hermeneutic::services::grpc_helpers
@@ -1,8 +1,10 @@
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
 #include <atomic>
 #include <csignal>
 #include <chrono>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <string>
@@ -52,8 +54,8 @@ int main(int argc, char** argv) {
     return 1;
   }
 
-  auto calculator = hermeneutic::price_bands::PriceBandsCalculator(
-      hermeneutic::price_bands::defaultOffsets());
+  const auto offsets = hermeneutic::price_bands::defaultOffsets();
+  auto calculator = hermeneutic::price_bands::PriceBandsCalculator(offsets);
   hermeneutic::services::BookStreamClient client(
       endpoint,
       token,
@@ -97,6 +99,12 @@ int main(int argc, char** argv) {
         csv.flush();
       });
 
+  // Levels beyond the widest band never affect a quote.
+  std::int64_t window_bps = 0;
+  for (const auto& offset : offsets) {
+    window_bps = std::max(window_bps, offset.toScaled(0));
+  }
+  client.setLevelFilter(0, static_cast<std::uint32_t>(window_bps));
   client.start();
   spdlog::info("Price bands client streaming from {} token='{}' symbol='{}' output={}"
                , endpoint, token, symbol, csv_path);
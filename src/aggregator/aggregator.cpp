@@ -3,8 +3,8 @@
 #include "hermeneutic/common/assert.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <limits>
-#include <map>
 #include <string>
 #include <spdlog/spdlog.h>
 #include <simdjson.h>
@@ -20,56 +20,13 @@ using common::Decimal;
 
 namespace {
 constexpr Decimal kZero = Decimal::fromRaw(0);
-
-void virtualUncross(std::vector<common::PriceLevel>& bids,
-                    std::vector<common::PriceLevel>& asks) {
-  const auto zero = Decimal::fromRaw(0);
-  for (std::size_t i = 1; i < bids.size(); ++i) {
-    HERMENEUTIC_ASSERT_DEBUG(bids[i - 1].price > bids[i].price,
-                             "bid levels must remain strictly descending before uncross");
-  }
-  for (std::size_t i = 1; i < asks.size(); ++i) {
-    HERMENEUTIC_ASSERT_DEBUG(asks[i - 1].price < asks[i].price,
-                             "ask levels must remain strictly ascending before uncross");
-  }
-  std::size_t bid_index = 0;
-  std::size_t ask_index = 0;
-  while (bid_index < bids.size() && ask_index < asks.size()) {
-    auto& bid = bids[bid_index];
-    auto& ask = asks[ask_index];
-    if (bid.price < ask.price) {
-      break;
-    }
-    const auto matched = std::min(bid.quantity, ask.quantity);
-    bid.quantity -= matched;
-    ask.quantity -= matched;
-    if (bid.quantity <= zero) {
-      ++bid_index;
-    }
-    if (ask.quantity <= zero) {
-      ++ask_index;
-    }
-  }
-  const auto erase_consumed = [&](std::vector<common::PriceLevel>& levels, std::size_t consumed) {
-    const auto remove_prefix = std::min(consumed, levels.size());
-    levels.erase(levels.begin(), levels.begin() + static_cast<std::ptrdiff_t>(remove_prefix));
-    levels.erase(std::remove_if(levels.begin(), levels.end(), [&](const auto& level) {
-                     return level.quantity <= zero;
-                   }),
-                 levels.end());
-  };
-  erase_consumed(bids, bid_index);
-  erase_consumed(asks, ask_index);
-  if (!bids.empty() && !asks.empty()) {
-    HERMENEUTIC_ASSERT_DEBUG(bids.front().price < asks.front().price,
-                             "uncrossed book still crossed");
-  }
-}
-
 }  // namespace
 
 AggregationEngine::AggregationEngine() = default;
 
+AggregationEngine::AggregationEngine(common::QueueOptions queue_options)
+    : queue_(queue_options), publish_queue_(queue_options) {}
+
 AggregationEngine::~AggregationEngine() {
   stop();
 }
@@ -78,7 +35,11 @@ void AggregationEngine::start() {
   if (running_.exchange(true)) {
     return;
   }
-  publisher_ = std::thread(&AggregationEngine::publisherLoop, this);
+  if (publish_options_.interval.count() > 0) {
+    publisher_ = std::thread(&AggregationEngine::conflatingPublisherLoop, this);
+  } else {
+    publisher_ = std::thread(&AggregationEngine::publisherLoop, this);
+  }
   worker_ = std::thread(&AggregationEngine::run, this);
 }
 
@@ -89,106 +50,361 @@ void AggregationEngine::stop() {
     worker_.join();
   }
   publish_queue_.close();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    publish_closed_ = true;
+  }
+  publish_cv_.notify_all();
   if (publisher_.joinable()) {
     publisher_.join();
   }
 }
 
 void AggregationEngine::push(BookEvent event) {
-  HERMENEUTIC_ASSERT_DEBUG(!event.exchange.empty(), "book event missing exchange");
+  if (event.exchange_id == common::kUnknownExchange) {
+    HERMENEUTIC_ASSERT_DEBUG(!event.exchange.empty(), "book event missing exchange");
+    event.exchange_id = common::ExchangeRegistry::instance().intern(event.exchange);
+  }
+  if (event.symbol_id == common::kUnknownSymbol) {
+    event.symbol_id = common::SymbolRegistry::instance().intern(event.symbol);
+  }
   queue_.push(std::move(event));
 }
 
 AggregationEngine::SubscriberId AggregationEngine::subscribe(Subscriber subscriber) {
+  return subscribe(std::string{}, std::move(subscriber));
+}
+
+AggregationEngine::SubscriberId AggregationEngine::subscribe(const std::string& symbol, Subscriber subscriber) {
   HERMENEUTIC_ASSERT_DEBUG(static_cast<bool>(subscriber), "subscriber callback must be valid");
   const auto id = next_subscriber_id_.fetch_add(1);
   std::lock_guard<std::mutex> lock(mutex_);
-  subscribers_.emplace(id, std::move(subscriber));
+  auto& books = symbolFor(symbol);
+  auto subscribers = std::make_shared<Subscribers>(*books.subscribers.load());
+  subscribers->emplace_back(id, std::move(subscriber));
+  books.subscribers.store(std::move(subscribers));
+  ++books.subscriber_count;
+  subscriber_symbols_.emplace(id, &books);
   return id;
 }
 
 void AggregationEngine::unsubscribe(SubscriberId id) {
   std::lock_guard<std::mutex> lock(mutex_);
-  subscribers_.erase(id);
+  if (auto it = subscriber_symbols_.find(id); it != subscriber_symbols_.end()) {
+    auto& books = *it->second;
+    auto subscribers = std::make_shared<Subscribers>(*books.subscribers.load());
+    std::erase_if(*subscribers, [id](const auto& entry) { return entry.first == id; });
+    books.subscribers.store(std::move(subscribers));
+    --books.subscriber_count;
+    subscriber_symbols_.erase(it);
+  }
+}
+
+BookSnapshot AggregationEngine::snapshot() const {
+  return snapshot(std::string{});
+}
+
+BookSnapshot AggregationEngine::snapshot(const std::string& symbol) const {
+  auto* books = findSymbol(symbol);
+  if (books == nullptr) {
+    static const auto empty = std::make_shared<const AggregatedBookView>();
+    return empty;
+  }
+  return books->view.load(std::memory_order_acquire);
 }
 
 common::AggregatedBookView AggregationEngine::latest() const {
+  return latest(std::string{});
+}
+
+common::AggregatedBookView AggregationEngine::latest(const std::string& symbol) const {
+  return *snapshot(symbol);
+}
+
+bool AggregationEngine::ready(const std::string& symbol) const {
   std::lock_guard<std::mutex> lock(mutex_);
-  return view_;
+  const auto* books = findSymbol(symbol);
+  return books != nullptr && books->ready_count == books->expected_count;
 }
 
 void AggregationEngine::setExpectedExchanges(std::vector<std::string> exchanges) {
+  setExpectedExchanges(std::string{}, std::move(exchanges));
+}
+
+void AggregationEngine::setExpectedExchanges(const std::string& symbol, std::vector<std::string> exchanges) {
   std::lock_guard<std::mutex> lock(mutex_);
-  expected_exchanges_.clear();
-  ready_exchanges_.clear();
-  for (auto& ex : exchanges) {
+  auto& books = symbolFor(symbol);
+  books.expected_exchanges.clear();
+  books.ready_exchanges.clear();
+  books.expected_count = 0;
+  books.ready_count = 0;
+  for (const auto& ex : exchanges) {
     HERMENEUTIC_ASSERT_DEBUG(!ex.empty(), "expected exchange names must be non-empty");
-    expected_exchanges_.insert(ex);
+    const auto id = common::ExchangeRegistry::instance().intern(ex);
+    if (id >= books.expected_exchanges.size()) {
+      books.expected_exchanges.resize(id + 1u, false);
+    }
+    if (!books.expected_exchanges[id]) {
+      books.expected_exchanges[id] = true;
+      ++books.expected_count;
+    }
   }
-  require_all_ready_ = !expected_exchanges_.empty();
+  books.ready_exchanges.resize(books.expected_exchanges.size(), false);
+}
+
+void AggregationEngine::setPublishOptions(PublishOptions options) {
+  HERMENEUTIC_ASSERT_DEBUG(!running_.load(), "publish options must be set before start()");
+  HERMENEUTIC_ASSERT_DEBUG(options.interval.count() >= 0, "publish interval must be non-negative");
+  std::lock_guard<std::mutex> lock(mutex_);
+  publish_options_ = options;
+}
+
+void AggregationEngine::setBookOptions(const std::string& exchange, lob::BookOptions options) {
+  setBookOptions(std::string{}, exchange, options);
+}
+
+void AggregationEngine::setBookOptions(const std::string& symbol,
+                                       const std::string& exchange,
+                                       lob::BookOptions options) {
+  HERMENEUTIC_ASSERT_DEBUG(!running_.load(), "book options must be set before start()");
+  std::lock_guard<std::mutex> lock(mutex_);
+  symbolFor(symbol).book_options.insert_or_assign(common::ExchangeRegistry::instance().intern(exchange), options);
+}
+
+std::unordered_map<std::string, lob::BookStats> AggregationEngine::bookStats() const {
+  return bookStats(std::string{});
+}
+
+std::unordered_map<std::string, lob::BookStats> AggregationEngine::bookStats(const std::string& symbol) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::unordered_map<std::string, lob::BookStats> stats;
+  if (const auto* books = findSymbol(symbol)) {
+    for (std::size_t id = 0; id < books->books.size(); ++id) {
+      if (const auto& book = books->books[id]) {
+        stats.emplace(common::ExchangeRegistry::instance().name(static_cast<common::ExchangeId>(id)), book->stats());
+      }
+    }
+  }
+  return stats;
+}
+
+AggregationEngine::SymbolBooks& AggregationEngine::symbolFor(const std::string& symbol) {
+  auto [it, inserted] = symbols_.try_emplace(symbol);
+  if (inserted) {
+    it->second.symbol = symbol;
+    const auto id = common::SymbolRegistry::instance().intern(symbol);
+    if (id >= symbols_by_id_.size()) {
+      symbols_by_id_.resize(id + 1u, nullptr);
+    }
+    symbols_by_id_[id] = &it->second;
+    auto index = std::make_shared<SymbolIndex>(*symbol_index_.load());
+    index->emplace(symbol, &it->second);
+    symbol_index_.store(std::move(index));
+  }
+  return it->second;
+}
+
+AggregationEngine::SymbolBooks& AggregationEngine::symbolFor(common::SymbolId id) {
+  if (id < symbols_by_id_.size() && symbols_by_id_[id] != nullptr) {
+    return *symbols_by_id_[id];
+  }
+  return symbolFor(common::SymbolRegistry::instance().name(id));
+}
+
+AggregationEngine::SymbolBooks* AggregationEngine::findSymbol(const std::string& symbol) const {
+  const auto index = symbol_index_.load(std::memory_order_acquire);
+  auto it = index->find(symbol);
+  return it == index->end() ? nullptr : it->second;
+}
+
+lob::LimitOrderBook& AggregationEngine::bookFor(SymbolBooks& symbol, common::ExchangeId exchange) {
+  auto& books = symbol.books;
+  if (exchange < books.size() && books[exchange]) {
+    return *books[exchange];
+  }
+  if (exchange >= books.size()) {
+    books.resize(exchange + 1u);
+  }
+  auto options = symbol.book_options.find(exchange);
+  books[exchange] = options != symbol.book_options.end() ? std::make_unique<lob::LimitOrderBook>(options->second)
+                                                         : std::make_unique<lob::LimitOrderBook>();
+  ++symbol.book_count;
+  return *books[exchange];
+}
+
+bool AggregationEngine::refreshTopOfBook(SymbolBooks& symbol) {
+  AggregatedQuote bid;
+  AggregatedQuote ask;
+  symbol.consolidated.uncrossedTop(bid, ask);
+  const bool changed = bid.price != symbol.top_bid.price || bid.quantity != symbol.top_bid.quantity ||
+                       ask.price != symbol.top_ask.price || ask.quantity != symbol.top_ask.quantity;
+  symbol.top_bid = bid;
+  symbol.top_ask = ask;
+  return changed;
+}
+
+AggregationEngine::SymbolBooks& AggregationEngine::applyLocked(const BookEvent& event) {
+  auto& symbol = symbolFor(event.symbol_id);
+  auto& book = bookFor(symbol, event.exchange_id);
+  level_deltas_.clear();
+  book.apply(event, level_deltas_);
+  symbol.consolidated.apply(level_deltas_);
+  symbol.view_dirty.store(true, std::memory_order_release);
+  const auto exchange = event.exchange_id;
+  if (exchange < symbol.expected_exchanges.size() && symbol.expected_exchanges[exchange] &&
+      !symbol.ready_exchanges[exchange]) {
+    symbol.ready_exchanges[exchange] = true;
+    ++symbol.ready_count;
+  }
+  return symbol;
 }
 
 void AggregationEngine::run() {
-  BookEvent update;
+  const bool conflate = publish_options_.interval.count() > 0;
+  // Sized once. Popping move-assigns into a slot, so each event takes over
+  // the producer's buffers (the slot's old ones are freed) rather than
+  // copying levels; the slots do not keep capacity across batches.
+  std::vector<BookEvent> batch(std::max<std::size_t>(publish_options_.max_batch, 1));
+  std::vector<SymbolBooks*> touched;
+  std::vector<Publication> snapshots;
+  // Symbols whose view trails their books; refreshed at most every
+  // view_refresh while busy, and once the queue has been idle that long.
+  std::vector<SymbolBooks*> dirty;
+  auto next_refresh = std::chrono::steady_clock::now();
+  const auto refresh_views = [&] {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto* symbol : dirty) {
+      if (symbol->view_dirty.load(std::memory_order_relaxed)) {
+        storeSnapshot(*symbol);
+      }
+    }
+    dirty.clear();
+    next_refresh = std::chrono::steady_clock::now() + publish_options_.view_refresh;
+  };
   while (running_.load()) {
-    if (!queue_.wait_pop(update)) {
-      break;
+    if (!queue_.try_pop(batch[0])) {
+      if (dirty.empty()) {
+        if (!queue_.wait_pop(batch[0])) {
+          break;
+        }
+      } else if (!queue_.wait_pop_for(batch[0], next_refresh - std::chrono::steady_clock::now())) {
+        refresh_views();
+        continue;
+      }
+    }
+    std::size_t count = 1;
+    while (count < batch.size() && queue_.try_pop(batch[count])) {
+      ++count;
     }
 
-    AggregatedBookView snapshot;
-    bool can_publish = true;
+    touched.clear();
+    snapshots.clear();
+    bool notify = false;
     {
       std::lock_guard<std::mutex> lock(mutex_);
-      auto& book = books_[update.exchange];
-      book.apply(update);
-      if (require_all_ready_ && expected_exchanges_.count(update.exchange)) {
-        ready_exchanges_.insert(update.exchange);
+      for (std::size_t i = 0; i < count; ++i) {
+        auto& symbol = applyLocked(batch[i]);
+        if (std::find(touched.begin(), touched.end(), &symbol) == touched.end()) {
+          touched.push_back(&symbol);
+        }
+      }
+      for (auto* symbol : touched) {
+        // Only pay for a view per batch when someone is listening; otherwise
+        // the view_refresh schedule below keeps snapshot() current.
+        if (symbol->ready_count != symbol->expected_count || symbol->subscriber_count == 0) {
+          continue;
+        }
+        // Checked last, so top_bid/top_ask stay the top of the last book
+        // offered to subscribers rather than of skipped batches.
+        if (publish_options_.bbo_changes_only && !refreshTopOfBook(*symbol)) {
+          continue;
+        }
+        if (!conflate) {
+          snapshots.push_back({symbol, storeSnapshot(*symbol)});
+        } else if (!symbol->publish_pending) {
+          symbol->publish_pending = true;
+          publish_pending_.push_back(symbol);
+          notify = true;
+        }
       }
-      view_ = consolidate();
-      snapshot = view_;
-      can_publish = !require_all_ready_ || ready_exchanges_.size() == expected_exchanges_.size();
+      for (auto* symbol : touched) {
+        if (symbol->view_dirty.load(std::memory_order_relaxed) &&
+            std::find(dirty.begin(), dirty.end(), symbol) == dirty.end()) {
+          dirty.push_back(symbol);
+        }
+      }
+    }
+    if (notify) {
+      publish_cv_.notify_one();
     }
-    if (can_publish) {
-      enqueueSnapshot(std::move(snapshot));
+    for (auto& publication : snapshots) {
+      enqueueSnapshot(*publication.symbol, std::move(publication.view));
+    }
+    if (!dirty.empty() && std::chrono::steady_clock::now() >= next_refresh) {
+      refresh_views();
     }
   }
+  refresh_views();
 }
 
 void AggregationEngine::publisherLoop() {
-  AggregatedBookView snapshot;
-  while (publish_queue_.wait_pop(snapshot)) {
-    publish(snapshot);
+  Publication publication;
+  while (publish_queue_.wait_pop(publication)) {
+    publish(*publication.symbol, publication.view);
   }
 }
 
-void AggregationEngine::enqueueSnapshot(AggregatedBookView view) {
-  publish_queue_.push(std::move(view));
-}
-
-void AggregationEngine::publish(const AggregatedBookView& view) {
-  std::vector<Subscriber> subscribers;
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-    subscribers.reserve(subscribers_.size());
-    for (const auto& [_, cb] : subscribers_) {
-      subscribers.push_back(cb);
+void AggregationEngine::conflatingPublisherLoop() {
+  auto next_publish = std::chrono::steady_clock::now();
+  std::vector<Publication> publications;
+  for (;;) {
+    publications.clear();
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      publish_cv_.wait(lock, [this] { return publish_closed_ || !publish_pending_.empty(); });
+      // Events that land before the interval elapses fold into this snapshot.
+      if (publish_closed_ ||
+          publish_cv_.wait_until(lock, next_publish, [this] { return publish_closed_; })) {
+        break;
+      }
+      for (auto* symbol : publish_pending_) {
+        symbol->publish_pending = false;
+        publications.push_back(
+            {symbol, symbol->view_dirty.load(std::memory_order_relaxed) ? storeSnapshot(*symbol) : symbol->view.load()});
+      }
+      publish_pending_.clear();
     }
-  }
-  for (auto& subscriber : subscribers) {
-    if (subscriber) {
-      subscriber(view);
+    for (const auto& publication : publications) {
+      publish(*publication.symbol, publication.view);
     }
+    next_publish = std::chrono::steady_clock::now() + publish_options_.interval;
+  }
+}
+
+BookSnapshot AggregationEngine::storeSnapshot(SymbolBooks& symbol) const {
+  auto snapshot = std::make_shared<const AggregatedBookView>(consolidate(symbol));
+  symbol.view.store(snapshot, std::memory_order_release);
+  symbol.view_dirty.store(false, std::memory_order_release);
+  return snapshot;
+}
+
+void AggregationEngine::enqueueSnapshot(SymbolBooks& symbol, BookSnapshot view) {
+  publish_queue_.push(Publication{&symbol, std::move(view)});
+}
+
+void AggregationEngine::publish(SymbolBooks& symbol, const BookSnapshot& view) {
+  // A subscriber removed after this load may still see this one book.
+  const auto subscribers = symbol.subscribers.load(std::memory_order_acquire);
+  for (const auto& [_, subscriber] : *subscribers) {
+    subscriber(view);
   }
 }
 
-AggregatedBookView AggregationEngine::consolidate() const {
+AggregatedBookView AggregationEngine::consolidate(SymbolBooks& symbol) const {
   AggregatedBookView view;
-  view.exchange_count = books_.size();
+  view.exchange_count = symbol.book_count;
   view.timestamp = std::chrono::system_clock::now();
 
-  std::map<Decimal, Decimal, std::greater<Decimal>> aggregated_bids;
-  std::map<Decimal, Decimal, std::less<Decimal>> aggregated_asks;
-
   std::int64_t latest_feed_ns = 0;
   std::int64_t latest_local_ns = 0;
   std::int64_t min_feed_ns = std::numeric_limits<std::int64_t>::max();
@@ -196,23 +412,19 @@ AggregatedBookView AggregationEngine::consolidate() const {
   std::int64_t min_local_ns = std::numeric_limits<std::int64_t>::max();
   std::int64_t max_local_ns = 0;
 
-  for (const auto& [name, book] : books_) {
-    (void)name;
-    for (auto it = book.bidLevelsBegin(); it != book.bidLevelsEnd(); ++it) {
-      aggregated_bids[it->first] += it->second;
-    }
-    for (auto it = book.askLevelsBegin(); it != book.askLevelsEnd(); ++it) {
-      aggregated_asks[it->first] += it->second;
+  for (const auto& book : symbol.books) {
+    // A stale book's levels are already out of the consolidated ladder.
+    if (!book || book->stale()) {
+      continue;
     }
-
-    const auto feed_ns = book.lastFeedTimestampNs();
+    const auto feed_ns = book->lastFeedTimestampNs();
     if (feed_ns > 0) {
       latest_feed_ns = std::max(latest_feed_ns, feed_ns);
       min_feed_ns = std::min(min_feed_ns, feed_ns);
       max_feed_ns = std::max(max_feed_ns, feed_ns);
     }
 
-    const auto local_ns = book.lastLocalUpdateTimestampNs();
+    const auto local_ns = book->lastLocalUpdateTimestampNs();
     if (local_ns > 0) {
       latest_local_ns = std::max(latest_local_ns, local_ns);
       min_local_ns = std::min(min_local_ns, local_ns);
@@ -220,18 +432,7 @@ AggregatedBookView AggregationEngine::consolidate() const {
     }
   }
 
-  view.bid_levels.reserve(aggregated_bids.size());
-  for (const auto& [price, qty] : aggregated_bids) {
-    if (qty > kZero) {
-      view.bid_levels.push_back({price, qty});
-    }
-  }
-  view.ask_levels.reserve(aggregated_asks.size());
-  for (const auto& [price, qty] : aggregated_asks) {
-    if (qty > kZero) {
-      view.ask_levels.push_back({price, qty});
-    }
-  }
+  symbol.consolidated.materialize(view.bid_levels, view.ask_levels);
 
   virtualUncross(view.bid_levels, view.ask_levels);
 
@@ -245,13 +446,13 @@ AggregatedBookView AggregationEngine::consolidate() const {
 
   if (!view.ask_levels.empty()) {
     view.best_ask = AggregatedQuote{view.ask_levels.front().price, view.ask_levels.front().quantity};
-    last_best_ask_valid_ = true;
-    last_best_ask_ = view.best_ask;
+    symbol.last_best_ask_valid = true;
+    symbol.last_best_ask = view.best_ask;
   } else {
     view.ask_levels.clear();
-    if (last_best_ask_valid_) {
-      view.best_ask = last_best_ask_;
-      view.ask_levels.push_back({last_best_ask_.price, last_best_ask_.quantity});
+    if (symbol.last_best_ask_valid) {
+      view.best_ask = symbol.last_best_ask;
+      view.ask_levels.push_back({symbol.last_best_ask.price, symbol.last_best_ask.quantity});
     } else {
       view.best_ask = AggregatedQuote{kZero, kZero};
     }
@@ -267,7 +468,7 @@ AggregatedBookView AggregationEngine::consolidate() const {
   const auto publish_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(view.timestamp.time_since_epoch()).count();
   view.publish_timestamp_ns = publish_ns;
   //HERMENEUTIC_ASSERT_DEBUG(false, "xxx");
-  validateAggregatedView(view);
+  validateAggregatedView(symbol, view);
   const auto feed_span = (view.min_feed_timestamp_ns > 0 && view.max_feed_timestamp_ns > 0)
                              ? (view.max_feed_timestamp_ns - view.min_feed_timestamp_ns)
                              : 0;
@@ -277,14 +478,14 @@ AggregatedBookView AggregationEngine::consolidate() const {
   const auto publish_delay = (view.max_feed_timestamp_ns > 0)
                                  ? (publish_ns - view.max_feed_timestamp_ns)
                                  : 0;
-  maybeWarnOnStaleness(feed_span, local_span, publish_delay);
+  maybeWarnOnStaleness(symbol, feed_span, local_span, publish_delay);
 
   return view;
 }
 
-void AggregationEngine::validateAggregatedView(const AggregatedBookView& view) const {
+void AggregationEngine::validateAggregatedView(const SymbolBooks& symbol, const AggregatedBookView& view) const {
 #if defined(HERMENEUTIC_ENABLE_DEBUG_ASSERTS) && HERMENEUTIC_ENABLE_DEBUG_ASSERTS
-  HERMENEUTIC_ASSERT_DEBUG(view.exchange_count == books_.size(), "exchange count mismatch");
+  HERMENEUTIC_ASSERT_DEBUG(view.exchange_count == symbol.book_count, "exchange count mismatch");
   const auto zero = common::Decimal::fromRaw(0);
   if (view.best_bid.quantity > zero) {
     HERMENEUTIC_ASSERT_DEBUG(view.best_bid.price >= zero, "best bid price negative");
@@ -353,7 +554,8 @@ void AggregationEngine::validateAggregatedView(const AggregatedBookView& view) c
 #endif
 }
 
-void AggregationEngine::maybeWarnOnStaleness(std::int64_t feed_span,
+void AggregationEngine::maybeWarnOnStaleness(const SymbolBooks& symbol,
+                                             std::int64_t feed_span,
                                              std::int64_t local_span,
                                              std::int64_t publish_delay) const {
   constexpr std::int64_t kSpreadThresholdNs =
@@ -384,7 +586,11 @@ void AggregationEngine::maybeWarnOnStaleness(std::int64_t feed_span,
   for (std::size_t i = 1; i < reasons.size(); ++i) {
     message.append("; ").append(reasons[i]);
   }
-  spdlog::warn("Aggregated feed staleness detected: {}", message);
+  if (symbol.symbol.empty()) {
+    spdlog::warn("Aggregated feed staleness detected: {}", message);
+  } else {
+    spdlog::warn("Aggregated feed staleness detected for {}: {}", symbol.symbol, message);
+  }
 }
 
 }  // namespace hermeneutic::aggregator
@@ -400,9 +606,42 @@ AggregatorConfig loadAggregatorConfig(const std::string& path) {
   if (auto publish = obj["publish_interval_ms"].get_uint64(); publish.error() == simdjson::SUCCESS) {
     config.publish_interval = std::chrono::milliseconds(publish.value());
   }
+  if (auto bbo_only = obj["publish_on_bbo_change"].get_bool(); bbo_only.error() == simdjson::SUCCESS) {
+    config.publish_on_bbo_change = bbo_only.value();
+  }
+  if (auto batch = obj["max_batch_events"].get_uint64(); batch.error() == simdjson::SUCCESS) {
+    if (batch.value() == 0) {
+      throw std::runtime_error("config max_batch_events must be positive");
+    }
+    config.max_batch_events = static_cast<std::size_t>(batch.value());
+  }
+  if (auto queue = obj["queue"].get_object(); queue.error() == simdjson::SUCCESS) {
+    if (auto kind = queue["kind"].get_string(); kind.error() == simdjson::SUCCESS) {
+      if (!common::parseQueueKind(kind.value(), config.queue.kind)) {
+        throw std::runtime_error("config queue.kind must be 'mutex' or 'lockfree'");
+      }
+    }
+    if (auto wait = queue["wait"].get_string(); wait.error() == simdjson::SUCCESS) {
+      if (!common::parseWaitStrategy(wait.value(), config.queue.wait)) {
+        throw std::runtime_error("config queue.wait must be 'blocking', 'spinning' or 'hybrid'");
+      }
+    }
+    if (auto capacity = queue["capacity"].get_uint64(); capacity.error() == simdjson::SUCCESS) {
+      config.queue.capacity = static_cast<std::size_t>(capacity.value());
+    }
+  }
+  if (auto feed_threads = obj["feed_threads"].get_uint64(); feed_threads.error() == simdjson::SUCCESS) {
+    config.feed_threads = static_cast<std::size_t>(feed_threads.value());
+  }
   if (auto symbol = obj["symbol"].get_string(); symbol.error() == simdjson::SUCCESS) {
     config.symbol = std::string(symbol.value());
   }
+  if (auto shards = obj["shards"].get_uint64(); shards.error() == simdjson::SUCCESS) {
+    if (shards.value() == 0) {
+      throw std::runtime_error("config shards must be positive");
+    }
+    config.shards = static_cast<std::size_t>(shards.value());
+  }
 
   if (auto grpc_value = obj["grpc"].get_object(); grpc_value.error() == simdjson::SUCCESS) {
     if (auto listen = grpc_value["listen_address"].get_string(); listen.error() == simdjson::SUCCESS) {
@@ -414,10 +653,41 @@ AggregatorConfig loadAggregatorConfig(const std::string& path) {
     if (auto token = grpc_value["auth_token"].get_string(); token.error() == simdjson::SUCCESS) {
       config.grpc.auth_token = std::string(token.value());
     }
+    if (auto stream = grpc_value["stream"].get_object(); stream.error() == simdjson::SUCCESS) {
+      if (auto pending = stream["max_pending"].get_uint64(); pending.error() == simdjson::SUCCESS) {
+        if (pending.value() == 0) {
+          throw std::runtime_error("config grpc.stream.max_pending must be positive");
+        }
+        config.grpc.stream.max_pending = static_cast<std::size_t>(pending.value());
+      }
+      if (auto policy = stream["slow_consumer"].get_string(); policy.error() == simdjson::SUCCESS) {
+        if (policy.value() == "drop_oldest") {
+          config.grpc.stream.slow_consumer = SlowConsumerPolicy::DropOldest;
+        } else if (policy.value() == "conflate") {
+          config.grpc.stream.slow_consumer = SlowConsumerPolicy::Conflate;
+        } else if (policy.value() == "disconnect") {
+          config.grpc.stream.slow_consumer = SlowConsumerPolicy::Disconnect;
+        } else {
+          throw std::runtime_error("config grpc.stream.slow_consumer must be 'drop_oldest', 'conflate' or 'disconnect'");
+        }
+      }
+    }
   } else {
     throw std::runtime_error("config missing grpc section");
   }
 
+  if (auto journal = obj["journal"].get_object(); journal.error() == simdjson::SUCCESS) {
+    if (auto directory = journal["directory"].get_string(); directory.error() == simdjson::SUCCESS) {
+      config.journal.directory = std::string(directory.value());
+    }
+    if (auto segment = journal["segment_mb"].get_uint64(); segment.error() == simdjson::SUCCESS) {
+      if (segment.value() == 0) {
+        throw std::runtime_error("config journal.segment_mb must be positive");
+      }
+      config.journal.segment_bytes = segment.value() << 20;
+    }
+  }
+
   auto feeds = obj["feeds"].get_array();
   if (feeds.error() != simdjson::SUCCESS) {
     throw std::runtime_error("config missing feeds array");
@@ -427,12 +697,57 @@ AggregatorConfig loadAggregatorConfig(const std::string& path) {
     auto feed_obj = feed_value.get_object();
     feed.name = std::string(feed_obj["name"].get_string().value());
     feed.url = std::string(feed_obj["url"].get_string().value());
+    feed.symbol = config.symbol;
+    if (auto symbol = feed_obj["symbol"].get_string(); symbol.error() == simdjson::SUCCESS) {
+      feed.symbol = std::string(symbol.value());
+    }
     if (auto token = feed_obj["auth_token"].get_string(); token.error() == simdjson::SUCCESS) {
       feed.auth_token = std::string(token.value());
     }
+    if (auto book = feed_obj["book"].get_object(); book.error() == simdjson::SUCCESS) {
+      if (auto ladder = book["ladder"].get_string(); ladder.error() == simdjson::SUCCESS) {
+        if (ladder.value() == "flat") {
+          feed.book.ladder = lob::LadderKind::Flat;
+        } else if (ladder.value() == "map") {
+          feed.book.ladder = lob::LadderKind::Map;
+        } else {
+          throw std::runtime_error("config feed book.ladder must be 'map' or 'flat'");
+        }
+      }
+      if (auto tick = book["tick_size"].get_string(); tick.error() == simdjson::SUCCESS) {
+        feed.book.tick_size = common::Decimal::fromString(tick.value());
+      }
+      if (auto ticks = book["initial_ticks"].get_uint64(); ticks.error() == simdjson::SUCCESS) {
+        feed.book.initial_ticks = static_cast<std::size_t>(ticks.value());
+      }
+      if (auto ticks = book["max_ticks"].get_uint64(); ticks.error() == simdjson::SUCCESS) {
+        feed.book.max_ticks = static_cast<std::size_t>(ticks.value());
+      }
+      if (auto orders = book["expected_orders"].get_uint64(); orders.error() == simdjson::SUCCESS) {
+        feed.book.expected_orders = static_cast<std::size_t>(orders.value());
+      }
+      if (auto buffered = book["max_buffered_events"].get_uint64(); buffered.error() == simdjson::SUCCESS) {
+        feed.book.max_buffered_events = static_cast<std::size_t>(buffered.value());
+      }
+    }
     config.feeds.push_back(std::move(feed));
   }
+  // Interned in config order, so the shards take the symbols round-robin
+  // and the feeds stamp ids that already exist.
+  for (const auto& symbol : config.symbols()) {
+    common::SymbolRegistry::instance().intern(symbol);
+  }
   return config;
 }
 
+std::vector<std::string> AggregatorConfig::symbols() const {
+  std::vector<std::string> result{symbol};
+  for (const auto& feed : feeds) {
+    if (!feed.symbol.empty() && std::find(result.begin(), result.end(), feed.symbol) == result.end()) {
+      result.push_back(feed.symbol);
+    }
+  }
+  return result;
+}
+
 }  // namespace hermeneutic::aggregator
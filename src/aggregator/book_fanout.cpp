@@ -0,0 +1,338 @@
+#include "hermeneutic/aggregator/book_fanout.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+#include <utility>
+
+#include "hermeneutic/common/assert.hpp"
+#include "services/common/grpc_helpers.hpp"
+
+namespace hermeneutic::aggregator {
+
+using common::AggregatedBookView;
+
+namespace {
+
+template <typename Message>
+::grpc::ByteBuffer serialize(const Message& message) {
+  ::grpc::ByteBuffer buffer;
+  bool own_buffer = false;
+  const auto status = ::grpc::SerializationTraits<Message>::Serialize(message, &buffer, &own_buffer);
+  HERMENEUTIC_ASSERT_DEBUG(status.ok(), "book payload failed to serialize");
+  (void)status;
+  return buffer;
+}
+
+std::size_t windowEnd(const std::vector<common::PriceLevel>& levels, const BookFilter& filter, bool bids) {
+  auto end = levels.size();
+  if (filter.max_depth != 0) {
+    end = std::min<std::size_t>(end, filter.max_depth);
+  }
+  if (filter.window_bps == 0 || end == 0) {
+    return end;
+  }
+  // Same widening as the price band calculator: price * fraction can
+  // overflow the 128-bit intermediate.
+  using common::DecimalWide;
+  const auto fraction = DecimalWide::fromInteger(filter.window_bps) / DecimalWide::fromInteger(10'000);
+  const auto one = DecimalWide::fromInteger(1);
+  const auto best = DecimalWide::fromRaw(levels.front().price.raw());
+  const auto bound = common::Decimal::fromRaw((best * (bids ? one - fraction : one + fraction)).raw());
+  const auto outside = std::find_if(levels.begin(), levels.begin() + static_cast<std::ptrdiff_t>(end),
+                                    [&](const common::PriceLevel& level) {
+                                      return bids ? level.price < bound : level.price > bound;
+                                    });
+  return static_cast<std::size_t>(outside - levels.begin());
+}
+
+}  // namespace
+
+AggregatedBookView filterBook(const AggregatedBookView& view, const BookFilter& filter) {
+  AggregatedBookView trimmed;
+  trimmed.bid_levels.assign(view.bid_levels.begin(),
+                            view.bid_levels.begin() +
+                                static_cast<std::ptrdiff_t>(windowEnd(view.bid_levels, filter, true)));
+  trimmed.ask_levels.assign(view.ask_levels.begin(),
+                            view.ask_levels.begin() +
+                                static_cast<std::ptrdiff_t>(windowEnd(view.ask_levels, filter, false)));
+  trimmed.best_bid = view.best_bid;
+  trimmed.best_ask = view.best_ask;
+  trimmed.timestamp = view.timestamp;
+  trimmed.exchange_count = view.exchange_count;
+  trimmed.last_feed_timestamp_ns = view.last_feed_timestamp_ns;
+  trimmed.last_local_timestamp_ns = view.last_local_timestamp_ns;
+  trimmed.min_feed_timestamp_ns = view.min_feed_timestamp_ns;
+  trimmed.max_feed_timestamp_ns = view.max_feed_timestamp_ns;
+  trimmed.min_local_timestamp_ns = view.min_local_timestamp_ns;
+  trimmed.max_local_timestamp_ns = view.max_local_timestamp_ns;
+  trimmed.publish_timestamp_ns = view.publish_timestamp_ns;
+  return trimmed;
+}
+
+BookFrame::BookFrame(std::uint64_t sequence,
+                     std::shared_ptr<const AggregatedBookView> view,
+                     std::shared_ptr<const AggregatedBookView> previous)
+    : sequence_(sequence), view_(std::move(view)), previous_(std::move(previous)) {
+  HERMENEUTIC_ASSERT_DEBUG(view_ != nullptr, "book frame requires a view");
+}
+
+const ::grpc::ByteBuffer& BookFrame::book(hermeneutic::grpc::BookEncoding encoding,
+                                          const BookFilter& filter) const {
+  return payload(kBook, encoding, filter);
+}
+
+const ::grpc::ByteBuffer& BookFrame::snapshotUpdate(hermeneutic::grpc::BookEncoding encoding,
+                                                    const BookFilter& filter) const {
+  return payload(kSnapshot, encoding, filter);
+}
+
+const ::grpc::ByteBuffer& BookFrame::deltaUpdate(hermeneutic::grpc::BookEncoding encoding,
+                                                 const BookFilter& filter) const {
+  // The first frame after a (re)subscription has nothing to diff against.
+  return payload(previous_ ? kDelta : kSnapshot, encoding, filter);
+}
+
+BookFrame::Filtered& BookFrame::filtered(const BookFilter& filter) const {
+  std::lock_guard<std::mutex> lock(filtered_mutex_);
+  for (const auto& entry : filtered_) {
+    if (entry->filter == filter) {
+      return *entry;
+    }
+  }
+  auto entry = std::make_unique<Filtered>();
+  entry->filter = filter;
+  entry->view = filterBook(*view_, filter);
+  if (previous_) {
+    entry->previous = filterBook(*previous_, filter);
+  }
+  return *filtered_.emplace_back(std::move(entry));
+}
+
+const ::grpc::ByteBuffer& BookFrame::payload(Payload kind,
+                                             hermeneutic::grpc::BookEncoding encoding,
+                                             const BookFilter& filter) const {
+  const AggregatedBookView* view = view_.get();
+  const AggregatedBookView* previous = previous_.get();
+  Slots* slots = &slots_;
+  if (filter.trims()) {
+    auto& entry = filtered(filter);
+    view = &entry.view;
+    previous = entry.previous ? &*entry.previous : nullptr;
+    slots = &entry.slots;
+  }
+  const auto index = encoding == hermeneutic::grpc::BOOK_ENCODING_FIXED_POINT ? 1u : 0u;
+  auto& slot = (*slots)[kind][index];
+  std::call_once(slot.once, [&] {
+    namespace helpers = hermeneutic::services::grpc_helpers;
+    const auto build = [&](hermeneutic::grpc::BookEncoding as) {
+      switch (kind) {
+        case kBook:
+          return serialize(helpers::FromDomain(*view, as));
+        case kSnapshot:
+          return serialize(helpers::FromDomainUpdate(nullptr, *view, sequence_, as));
+        default:
+          return serialize(helpers::FromDomainUpdate(previous, *view, sequence_, as));
+      }
+    };
+    try {
+      slot.buffer = build(encoding);
+    } catch (const std::overflow_error& ex) {
+      // A value too large for 64-bit fixed point. Clients decode each
+      // message by its own encoding, so this frame goes out as strings.
+      static std::atomic<bool> warned{false};
+      if (!warned.exchange(true)) {
+        spdlog::warn("Sending decimal strings for a book the fixed-point encoding cannot hold: {}", ex.what());
+      }
+      slot.buffer = build(hermeneutic::grpc::BOOK_ENCODING_DECIMAL_STRING);
+    }
+  });
+  return slot.buffer;
+}
+
+// One registered listener. Deliveries run outside State::mutex, so remove()
+// marks the entry removed under its own mutex instead, which waits out a
+// delivery in progress. Recursive so a listener whose reaction ends up in
+// remove() on the same thread does not deadlock on itself.
+struct BookFanout::Entry {
+  ListenerId id;
+  Listener listener;
+  std::recursive_mutex mutex;
+  bool removed{false};
+
+  void deliver(const std::shared_ptr<const BookFrame>& frame) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (!removed) {
+      listener(frame);
+    }
+  }
+
+  void retire() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    removed = true;
+  }
+};
+
+// Shared with the engine callback, which may still run briefly after
+// unsubscribe() returns. The mutex only guards the bookkeeping: publish()
+// takes the current listener list under it and delivers after releasing
+// it, so a listener may start a write, or add and remove streams, without
+// stalling the rest. Frames come from the engine's single publisher
+// thread, so each listener still sees them in order. add() hands its first
+// frame over before the listener is registered.
+struct BookFanout::State {
+  using Entries = std::vector<std::shared_ptr<Entry>>;
+
+  std::mutex mutex;
+  // Copy-on-write like the engine's subscriber list: add() and remove()
+  // swap in a new list, so publish() only copies a pointer.
+  std::shared_ptr<const Entries> listeners{std::make_shared<const Entries>()};
+  ListenerId next_id{1};
+  // add() calls still handing their first frame over outside the lock;
+  // they keep the subscription and frame numbering alive meanwhile.
+  std::size_t adding{0};
+  AggregationEngine::SubscriberId subscription{0};
+  std::uint64_t sequence{0};
+  std::shared_ptr<const AggregatedBookView> previous;
+  std::shared_ptr<const BookFrame> latest;
+
+  std::shared_ptr<const BookFrame> nextFrameLocked(const BookSnapshot& view) {
+    latest = std::make_shared<const BookFrame>(++sequence, view, previous);
+    previous = view;
+    return latest;
+  }
+
+  void publish(const BookSnapshot& view) {
+    std::shared_ptr<const Entries> entries;
+    std::shared_ptr<const BookFrame> frame;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (listeners->empty() && adding == 0) {
+        return;
+      }
+      frame = nextFrameLocked(view);
+      entries = listeners;
+    }
+    for (const auto& entry : *entries) {
+      entry->deliver(frame);
+    }
+  }
+};
+
+BookFanout::BookFanout(AggregationEngine& engine, std::string symbol)
+    : engine_(engine), symbol_(std::move(symbol)), state_(std::make_shared<State>()) {}
+
+BookFanout::~BookFanout() {
+  std::shared_ptr<const State::Entries> entries;
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    if (state_->subscription != 0) {
+      engine_.unsubscribe(state_->subscription);
+      state_->subscription = 0;
+    }
+    entries = std::exchange(state_->listeners, std::make_shared<const State::Entries>());
+  }
+  for (const auto& entry : *entries) {
+    entry->retire();
+  }
+}
+
+BookFanout::ListenerId BookFanout::add(Listener listener) {
+  HERMENEUTIC_ASSERT_DEBUG(static_cast<bool>(listener), "fanout listener must be valid");
+  std::unique_lock<std::mutex> lock(state_->mutex);
+  auto entry = std::make_shared<Entry>();
+  entry->id = state_->next_id++;
+  entry->listener = std::move(listener);
+  if (state_->subscription == 0) {
+    state_->previous.reset();
+    state_->latest.reset();
+    state_->subscription = engine_.subscribe(
+        symbol_, [state = state_](const BookSnapshot& view) { state->publish(view); });
+    // The engine only publishes on change, so seed the fanout with the book
+    // as it stands, but only once the engine would publish it. snapshot()
+    // never waits on the worker or the publisher thread.
+    if (engine_.ready(symbol_)) {
+      if (auto view = engine_.snapshot(symbol_); view->exchange_count > 0) {
+        state_->nextFrameLocked(view);
+      }
+    }
+  }
+  // Hand over the latest frame outside the lock, since the listener may
+  // start a write. The listener is registered only once no newer frame
+  // has appeared meanwhile, so it never sees frames out of order.
+  std::shared_ptr<const BookFrame> delivered;
+  ++state_->adding;
+  while (state_->latest != delivered) {
+    delivered = state_->latest;
+    lock.unlock();
+    entry->listener(delivered);
+    lock.lock();
+  }
+  --state_->adding;
+  auto entries = std::make_shared<State::Entries>(*state_->listeners);
+  entries->push_back(entry);
+  state_->listeners = std::move(entries);
+  return entry->id;
+}
+
+void BookFanout::remove(ListenerId id) {
+  std::shared_ptr<Entry> removed;
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    auto entries = std::make_shared<State::Entries>(*state_->listeners);
+    const auto it = std::find_if(entries->begin(), entries->end(),
+                                 [id](const std::shared_ptr<Entry>& entry) { return entry->id == id; });
+    if (it != entries->end()) {
+      removed = std::move(*it);
+      entries->erase(it);
+      state_->listeners = std::move(entries);
+    }
+    if (state_->listeners->empty() && state_->adding == 0 && state_->subscription != 0) {
+      engine_.unsubscribe(state_->subscription);
+      state_->subscription = 0;
+    }
+  }
+  // Outside the fanout lock: a delivery to this listener may be running.
+  if (removed) {
+    removed->retire();
+  }
+}
+
+FrameQueue::FrameQueue(StreamOptions options) : options_(options) {
+  HERMENEUTIC_ASSERT_DEBUG(options_.max_pending > 0, "stream max_pending must be positive");
+}
+
+bool FrameQueue::push(std::shared_ptr<const BookFrame> frame) {
+  const auto limit = options_.slow_consumer == SlowConsumerPolicy::Conflate ? 1 : options_.max_pending;
+  if (frames_.size() >= limit) {
+    if (options_.slow_consumer == SlowConsumerPolicy::Disconnect) {
+      return false;
+    }
+    frames_.pop_front();
+    ++stats_.dropped;
+  }
+  frames_.push_back(std::move(frame));
+  stats_.lag = frames_.size();
+  stats_.max_lag = std::max(stats_.max_lag, stats_.lag);
+  return true;
+}
+
+std::shared_ptr<const BookFrame> FrameQueue::pop() {
+  if (frames_.empty()) {
+    return nullptr;
+  }
+  auto frame = std::move(frames_.front());
+  frames_.pop_front();
+  stats_.lag = frames_.size();
+  ++stats_.sent;
+  return frame;
+}
+
+void FrameQueue::clear() {
+  stats_.dropped += frames_.size();
+  frames_.clear();
+  stats_.lag = 0;
+}
+
+}  // namespace hermeneutic::aggregator
@@ -0,0 +1,145 @@
+#include "hermeneutic/aggregator/consolidated_book.hpp"
+
+#include <algorithm>
+
+#include "hermeneutic/common/assert.hpp"
+
+namespace hermeneutic::aggregator {
+
+using common::Decimal;
+
+namespace {
+const Decimal kZero = Decimal::fromRaw(0);
+
+template <typename LevelMap>
+void applyToLadder(const lob::LevelDelta& delta, LevelMap& levels) {
+  const bool was_present = delta.previous_quantity > kZero;
+  const bool is_present = delta.quantity > kZero;
+  auto it = levels.find(delta.price);
+  if (it == levels.end()) {
+    HERMENEUTIC_ASSERT_DEBUG(!was_present, "consolidated ladder missing contributing level");
+    if (!is_present) {
+      return;
+    }
+    it = levels.emplace(delta.price, ConsolidatedBook::Level{}).first;
+  }
+  auto& level = it->second;
+  level.quantity += delta.quantity - delta.previous_quantity;
+  if (was_present && !is_present) {
+    HERMENEUTIC_ASSERT_DEBUG(level.sources > 0, "consolidated level source underflow");
+    --level.sources;
+  } else if (!was_present && is_present) {
+    ++level.sources;
+  }
+  if (level.sources == 0) {
+    levels.erase(it);
+  }
+}
+
+template <typename LevelMap>
+void copyLevels(const LevelMap& levels, std::vector<common::PriceLevel>& out) {
+  out.clear();
+  out.reserve(levels.size());
+  for (const auto& [price, level] : levels) {
+    if (level.quantity > kZero) {
+      out.push_back({price, level.quantity});
+    }
+  }
+}
+
+}  // namespace
+
+void virtualUncross(std::vector<common::PriceLevel>& bids,
+                    std::vector<common::PriceLevel>& asks) {
+  const auto zero = Decimal::fromRaw(0);
+  for (std::size_t i = 1; i < bids.size(); ++i) {
+    HERMENEUTIC_ASSERT_DEBUG(bids[i - 1].price > bids[i].price,
+                             "bid levels must remain strictly descending before uncross");
+  }
+  for (std::size_t i = 1; i < asks.size(); ++i) {
+    HERMENEUTIC_ASSERT_DEBUG(asks[i - 1].price < asks[i].price,
+                             "ask levels must remain strictly ascending before uncross");
+  }
+  std::size_t bid_index = 0;
+  std::size_t ask_index = 0;
+  while (bid_index < bids.size() && ask_index < asks.size()) {
+    auto& bid = bids[bid_index];
+    auto& ask = asks[ask_index];
+    if (bid.price < ask.price) {
+      break;
+    }
+    const auto matched = std::min(bid.quantity, ask.quantity);
+    bid.quantity -= matched;
+    ask.quantity -= matched;
+    if (bid.quantity <= zero) {
+      ++bid_index;
+    }
+    if (ask.quantity <= zero) {
+      ++ask_index;
+    }
+  }
+  const auto erase_consumed = [&](std::vector<common::PriceLevel>& levels, std::size_t consumed) {
+    const auto remove_prefix = std::min(consumed, levels.size());
+    levels.erase(levels.begin(), levels.begin() + static_cast<std::ptrdiff_t>(remove_prefix));
+    levels.erase(std::remove_if(levels.begin(), levels.end(), [&](const auto& level) {
+                     return level.quantity <= zero;
+                   }),
+                 levels.end());
+  };
+  erase_consumed(bids, bid_index);
+  erase_consumed(asks, ask_index);
+  if (!bids.empty() && !asks.empty()) {
+    HERMENEUTIC_ASSERT_DEBUG(bids.front().price < asks.front().price,
+                             "uncrossed book still crossed");
+  }
+}
+
+void ConsolidatedBook::apply(const lob::LevelDelta& delta) {
+  if (delta.side == common::Side::Bid) {
+    applyToLadder(delta, bids_);
+  } else {
+    applyToLadder(delta, asks_);
+  }
+}
+
+void ConsolidatedBook::apply(const lob::LevelDeltas& deltas) {
+  for (const auto& delta : deltas) {
+    apply(delta);
+  }
+}
+
+void ConsolidatedBook::clear() {
+  bids_.clear();
+  asks_.clear();
+}
+
+void ConsolidatedBook::uncrossedTop(common::AggregatedQuote& bid,
+                                    common::AggregatedQuote& ask) const {
+  auto bid_it = bids_.begin();
+  auto ask_it = asks_.begin();
+  Decimal bid_qty = bid_it != bids_.end() ? bid_it->second.quantity : kZero;
+  Decimal ask_qty = ask_it != asks_.end() ? ask_it->second.quantity : kZero;
+  while (bid_it != bids_.end() && ask_it != asks_.end() && bid_it->first >= ask_it->first) {
+    const auto matched = std::min(bid_qty, ask_qty);
+    bid_qty -= matched;
+    ask_qty -= matched;
+    if (bid_qty <= kZero && ++bid_it != bids_.end()) {
+      bid_qty = bid_it->second.quantity;
+    }
+    if (ask_qty <= kZero && ++ask_it != asks_.end()) {
+      ask_qty = ask_it->second.quantity;
+    }
+  }
+  bid = bid_it != bids_.end() ? common::AggregatedQuote{bid_it->first, bid_qty}
+                              : common::AggregatedQuote{kZero, kZero};
+  ask = ask_it != asks_.end() ? common::AggregatedQuote{ask_it->first, ask_qty}
+                              : common::AggregatedQuote{kZero, kZero};
+}
+
+void ConsolidatedBook::materialize(std::vector<common::PriceLevel>& bids,
+                                   std::vector<common::PriceLevel>& asks) const {
+  copyLevels(bids_, bids);
+  copyLevels(asks_, asks);
+}
+
+}  // namespace hermeneutic::aggregator
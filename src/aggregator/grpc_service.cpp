@@ -1,76 +1,257 @@
 #include "hermeneutic/aggregator/grpc_service.hpp"
 
-#include <atomic>
-#include <chrono>
+#include <grpcpp/impl/codegen/server_callback_handlers.h>
+#include <grpcpp/support/server_callback.h>
 
-#include "hermeneutic/common/concurrent_queue.hpp"
-#include "services/common/grpc_helpers.hpp"
+#include <spdlog/spdlog.h>
 
-namespace hermeneutic::aggregator {
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
 
-using hermeneutic::common::AggregatedBookView;
-using hermeneutic::common::ConcurrentQueue;
+namespace hermeneutic::aggregator {
 
 namespace {
 
-class SubscriptionGuard {
- public:
-  SubscriptionGuard(AggregationEngine& engine, AggregationEngine::SubscriberId id)
-      : engine_(engine), id_(id) {}
-  ~SubscriptionGuard() { engine_.unsubscribe(id_); }
+// Method indices in AggregatorService, in proto declaration order.
+constexpr int kStreamBooksMethod = 0;
+constexpr int kStreamBookUpdatesMethod = 1;
 
- private:
-  AggregationEngine& engine_;
-  AggregationEngine::SubscriberId id_;
-};
+hermeneutic::grpc::BookEncoding requestedEncoding(const hermeneutic::grpc::SubscribeRequest& request) {
+  return request.encoding() == hermeneutic::grpc::BOOK_ENCODING_FIXED_POINT
+             ? hermeneutic::grpc::BOOK_ENCODING_FIXED_POINT
+             : hermeneutic::grpc::BOOK_ENCODING_DECIMAL_STRING;
+}
 
 }  // namespace
 
-AggregatorGrpcService::AggregatorGrpcService(AggregationEngine& engine,
-                                             std::string token,
-                                             std::string symbol)
-    : engine_(engine), expected_token_(std::move(token)), symbol_(std::move(symbol)) {}
-
-::grpc::Status AggregatorGrpcService::StreamBooks(
-    ::grpc::ServerContext* context,
-    const hermeneutic::grpc::SubscribeRequest* request,
-    ::grpc::ServerWriter<hermeneutic::grpc::AggregatedBook>* writer) {
-  if (!authorize(*context)) {
-    return {::grpc::StatusCode::UNAUTHENTICATED, "missing or invalid token"};
+// One subscriber stream. Frames arrive on the engine's publisher thread and
+// are written one at a time; gRPC's callback threads run the reactions. The
+// mutex is never held across StartWrite/Finish in case gRPC runs a reaction
+// inline.
+class AggregatorGrpcService::Stream final : public ::grpc::ServerWriteReactor<::grpc::ByteBuffer> {
+ public:
+  Stream(AggregatorGrpcService& service,
+         ::grpc::CallbackServerContext* context,
+         const hermeneutic::grpc::SubscribeRequest* request,
+         bool updates)
+      : service_(service),
+        context_(context),
+        encoding_(requestedEncoding(*request)),
+        filter_{request->max_depth(), request->window_bps()},
+        updates_(updates),
+        queue_(service.stream_options_) {
+    if (auto status = service.checkRequest(*context, *request); !status.ok()) {
+      finishing_ = true;
+      finish_sent_ = true;
+      Finish(status);
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(service_.streams_mutex_);
+      service_.streams_.insert(this);
+    }
+    symbol_ = request->symbol().empty() ? service_.default_symbol_ : request->symbol();
+    fanout_ = &service_.fanoutFor(symbol_);
+    listener_ = fanout_->add([this](const std::shared_ptr<const BookFrame>& frame) { push(frame); });
   }
-  if (!request->symbol().empty() && request->symbol() != symbol_) {
-    return {::grpc::StatusCode::INVALID_ARGUMENT, "unsupported symbol"};
+
+  void OnWriteDone(bool ok) override {
+    const ::grpc::ByteBuffer* payload = nullptr;
+    bool finish = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      writing_ = false;
+      current_.reset();
+      if (!ok) {
+        finishing_ = true;
+      }
+      if (finishing_) {
+        finish = takeFinishLocked();
+      } else if (!queue_.empty()) {
+        payload = nextPayloadLocked();
+      }
+    }
+    if (payload != nullptr) {
+      StartWrite(payload);
+    } else if (finish) {
+      Finish(finish_status_);
+    }
   }
 
-  ConcurrentQueue<AggregatedBookView> queue;
-  std::atomic<bool> active{true};
-  auto subscriber_id = engine_.subscribe([&](const AggregatedBookView& view) {
-    if (!active.load(std::memory_order_relaxed)) {
-      return;
+  void OnCancel() override {
+    bool finish = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!finishing_) {
+        finish_status_ = ::grpc::Status::CANCELLED;
+      }
+      finishing_ = true;
+      queue_.clear();
+      finish = !writing_ && takeFinishLocked();
     }
-    queue.push(view);
-  });
-  SubscriptionGuard guard(engine_, subscriber_id);
-
-  AggregatedBookView snapshot;
-  while (!context->IsCancelled()) {
-    if (!queue.wait_pop_for(snapshot, std::chrono::milliseconds(100))) {
-      if (context->IsCancelled()) {
-        break;
+    if (finish) {
+      Finish(finish_status_);
+    }
+  }
+
+  void OnDone() override {
+    // remove() waits out a delivery in progress, so nothing calls push()
+    // once it returns.
+    if (listener_ != 0) {
+      {
+        std::lock_guard<std::mutex> lock(service_.streams_mutex_);
+        service_.streams_.erase(this);
+      }
+      fanout_->remove(listener_);
+    }
+    delete this;
+  }
+
+  SubscriberStats stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto stream = queue_.stats();
+    stream.resyncs = resyncs_;
+    return {context_->peer(), updates_ ? "StreamBookUpdates" : "StreamBooks", symbol_, stream};
+  }
+
+ private:
+  void push(const std::shared_ptr<const BookFrame>& frame) {
+    const ::grpc::ByteBuffer* payload = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (finishing_) {
+        return;
+      }
+      if (!queue_.push(frame)) {
+        // A write is in flight whenever frames back up, and a stalled peer
+        // may never complete it: cancel, and OnCancel/OnWriteDone finish.
+        spdlog::warn("Disconnecting gRPC subscriber {} after {} queued books", context_->peer(),
+                     queue_.stats().lag);
+        finishing_ = true;
+        finish_status_ = {::grpc::StatusCode::RESOURCE_EXHAUSTED, "subscriber too slow"};
+        queue_.clear();
+      } else if (writing_) {
+        return;
+      } else {
+        payload = nextPayloadLocked();
       }
-      continue;
     }
-    if (!writer->Write(hermeneutic::services::grpc_helpers::FromDomain(snapshot))) {
-      break;
+    if (payload != nullptr) {
+      StartWrite(payload);
+    } else {
+      context_->TryCancel();
+    }
+  }
+
+  const ::grpc::ByteBuffer* nextPayloadLocked() {
+    current_ = queue_.pop();
+    writing_ = true;
+    const auto& frame = *current_;
+    const auto previous = std::exchange(last_sequence_, frame.sequence());
+    if (!updates_) {
+      return &frame.book(encoding_, filter_);
+    }
+    // Deltas are only valid on top of the frame this stream sent last.
+    if (previous != 0 && frame.sequence() == previous + 1) {
+      return &frame.deltaUpdate(encoding_, filter_);
     }
+    if (previous != 0) {
+      ++resyncs_;
+    }
+    return &frame.snapshotUpdate(encoding_, filter_);
+  }
+
+  bool takeFinishLocked() { return !std::exchange(finish_sent_, true); }
+
+  AggregatorGrpcService& service_;
+  std::string symbol_;
+  BookFanout* fanout_{nullptr};
+  ::grpc::CallbackServerContext* context_;
+  const hermeneutic::grpc::BookEncoding encoding_;
+  const BookFilter filter_;
+  const bool updates_;
+  BookFanout::ListenerId listener_{0};
+
+  std::mutex mutex_;
+  FrameQueue queue_;
+  // Keeps the payload being written alive until OnWriteDone.
+  std::shared_ptr<const BookFrame> current_;
+  std::uint64_t last_sequence_{0};
+  std::uint64_t resyncs_{0};
+  ::grpc::Status finish_status_;
+  bool writing_{false};
+  bool finishing_{false};
+  bool finish_sent_{false};
+};
+
+AggregatorGrpcService::AggregatorGrpcService(AggregationEngine& engine,
+                                             std::string token,
+                                             std::string symbol,
+                                             StreamOptions stream_options)
+    : expected_token_(std::move(token)), default_symbol_(std::move(symbol)), stream_options_(stream_options) {
+  fanouts_.emplace(default_symbol_, std::make_unique<BookFanout>(engine));
+  registerMethods();
+}
+
+AggregatorGrpcService::AggregatorGrpcService(ShardedAggregator& aggregator,
+                                             std::string token,
+                                             const std::vector<std::string>& symbols,
+                                             StreamOptions stream_options)
+    : expected_token_(std::move(token)), stream_options_(stream_options) {
+  HERMENEUTIC_ASSERT_DEBUG(!symbols.empty(), "gRPC service needs at least one symbol");
+  default_symbol_ = symbols.empty() ? std::string{} : symbols.front();
+  for (const auto& symbol : symbols) {
+    fanouts_.try_emplace(symbol, std::make_unique<BookFanout>(aggregator.engineFor(symbol), symbol));
   }
+  registerMethods();
+}
 
-  active.store(false, std::memory_order_relaxed);
-  queue.close();
+void AggregatorGrpcService::registerMethods() {
+  // Equivalent to the generated WithRawCallbackMethod_* mixins, but with a
+  // typed request: only the response side needs to be raw.
+  using Handler = ::grpc::internal::CallbackServerStreamingHandler<hermeneutic::grpc::SubscribeRequest,
+                                                                   ::grpc::ByteBuffer>;
+  MarkMethodCallback(kStreamBooksMethod,
+                     new Handler([this](::grpc::CallbackServerContext* context,
+                                        const hermeneutic::grpc::SubscribeRequest* request) {
+                       return new Stream(*this, context, request, false);
+                     }));
+  MarkMethodCallback(kStreamBookUpdatesMethod,
+                     new Handler([this](::grpc::CallbackServerContext* context,
+                                        const hermeneutic::grpc::SubscribeRequest* request) {
+                       return new Stream(*this, context, request, true);
+                     }));
+}
+
+::grpc::Status AggregatorGrpcService::checkRequest(const ::grpc::ServerContextBase& context,
+                                                   const hermeneutic::grpc::SubscribeRequest& request) const {
+  if (!authorize(context)) {
+    return {::grpc::StatusCode::UNAUTHENTICATED, "missing or invalid token"};
+  }
+  if (!request.symbol().empty() && fanouts_.count(request.symbol()) == 0) {
+    return {::grpc::StatusCode::INVALID_ARGUMENT, "unsupported symbol"};
+  }
   return ::grpc::Status::OK;
 }
 
-bool AggregatorGrpcService::authorize(const ::grpc::ServerContext& context) const {
+std::vector<SubscriberStats> AggregatorGrpcService::subscriberStats() const {
+  std::lock_guard<std::mutex> lock(streams_mutex_);
+  std::vector<SubscriberStats> stats;
+  stats.reserve(streams_.size());
+  for (auto* stream : streams_) {
+    stats.push_back(stream->stats());
+  }
+  return stats;
+}
+
+BookFanout& AggregatorGrpcService::fanoutFor(const std::string& symbol) {
+  return *fanouts_.at(symbol);
+}
+
+bool AggregatorGrpcService::authorize(const ::grpc::ServerContextBase& context) const {
   if (expected_token_.empty()) {
     return true;
   }
@@ -2,26 +2,62 @@
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstddef>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <unordered_map>
-#include <unordered_set>
+#include <utility>
+#include <vector>
 
+#include "hermeneutic/aggregator/consolidated_book.hpp"
 #include "hermeneutic/common/assert.hpp"
-#include "hermeneutic/common/concurrent_queue.hpp"
+#include "hermeneutic/common/event_queue.hpp"
 #include "hermeneutic/common/events.hpp"
 #include "hermeneutic/lob/order_book.hpp"
 
 namespace hermeneutic::aggregator {
 
+struct PublishOptions {
+  // Minimum spacing between snapshots handed to subscribers. Zero publishes
+  // after every event; otherwise events inside the window are conflated and
+  // only the latest consolidated book is delivered.
+  std::chrono::milliseconds interval{0};
+  // Suppress snapshots whose (uncrossed) best bid/ask did not change.
+  bool bbo_changes_only{false};
+  // Most events the worker drains and applies before consolidating and
+  // publishing once. It only takes what is already queued, so an idle
+  // engine still publishes each event alone; larger values trade latency
+  // under bursts for throughput.
+  std::size_t max_batch{1};
+  // Longest snapshot()/latest() may trail the applied events when nothing
+  // is published: the worker stores a fresh view this often while busy,
+  // and this long after it goes idle.
+  std::chrono::milliseconds view_refresh{1};
+};
+
+// Published consolidated books are immutable and shared: subscribers and
+// latest() readers hold the same view rather than copies of it.
+using BookSnapshot = std::shared_ptr<const common::AggregatedBookView>;
+
+// Consolidates the per-exchange books of one or more symbols on a single
+// worker thread. Events select their symbol through BookEvent::symbol_id
+// (or the name, which push() interns); the
+// single-symbol overloads use the default (empty) symbol. Each symbol has
+// its own books, consolidated ladder and subscribers, so one engine can be
+// one shard of a ShardedAggregator.
 class AggregationEngine {
  public:
   using SubscriberId = std::size_t;
-  using Subscriber = std::function<void(const common::AggregatedBookView&)>;
+  using Subscriber = std::function<void(const BookSnapshot&)>;
 
   AggregationEngine();
+  // Selects the event/publish queue backend; the default constructor uses the
+  // build-time default (see HERMENEUTIC_DEFAULT_QUEUE).
+  explicit AggregationEngine(common::QueueOptions queue_options);
   ~AggregationEngine();
 
   void start();
@@ -29,39 +65,113 @@ class AggregationEngine {
 
   void push(common::BookEvent event);
   SubscriberId subscribe(Subscriber subscriber);
+  SubscriberId subscribe(const std::string& symbol, Subscriber subscriber);
   void unsubscribe(SubscriberId id);
 
+  // Latest consolidated book the worker stored; a lock-free load that never
+  // waits on event application. Trails the books by at most
+  // PublishOptions::view_refresh.
+  BookSnapshot snapshot() const;
+  BookSnapshot snapshot(const std::string& symbol) const;
   common::AggregatedBookView latest() const;
+  common::AggregatedBookView latest(const std::string& symbol) const;
+  // True once every expected exchange of `symbol` has delivered an event,
+  // i.e. once its books may be published.
+  bool ready(const std::string& symbol) const;
   void setExpectedExchanges(std::vector<std::string> exchanges);
+  void setExpectedExchanges(const std::string& symbol, std::vector<std::string> exchanges);
+  // Must be called before start().
+  void setPublishOptions(PublishOptions options);
+  // Price ladder backend for one exchange's book. Must be called before
+  // start(); exchanges without options get the default map ladder.
+  void setBookOptions(const std::string& exchange, lob::BookOptions options);
+  void setBookOptions(const std::string& symbol, const std::string& exchange, lob::BookOptions options);
+  // Per-exchange book metrics (levels, memory, sequence gaps, resyncs).
+  std::unordered_map<std::string, lob::BookStats> bookStats() const;
+  std::unordered_map<std::string, lob::BookStats> bookStats(const std::string& symbol) const;
 
  private:
+  using Subscribers = std::vector<std::pair<SubscriberId, Subscriber>>;
+
+  // Everything the engine keeps per symbol; guarded by mutex_ except for
+  // the atomics, which readers and the publisher load without it.
+  struct SymbolBooks {
+    std::string symbol;
+    // Indexed by ExchangeId; null until that exchange's first event.
+    std::vector<std::unique_ptr<lob::LimitOrderBook>> books;
+    std::size_t book_count{0};
+    std::unordered_map<common::ExchangeId, lob::BookOptions> book_options;
+    ConsolidatedBook consolidated;
+    std::atomic<BookSnapshot> view{std::make_shared<const common::AggregatedBookView>()};
+    std::atomic<bool> view_dirty{false};
+    common::AggregatedQuote last_best_ask{};
+    bool last_best_ask_valid{false};
+    // Also indexed by ExchangeId.
+    std::vector<bool> expected_exchanges;
+    std::vector<bool> ready_exchanges;
+    std::size_t expected_count{0};
+    std::size_t ready_count{0};
+    common::AggregatedQuote top_bid{};
+    common::AggregatedQuote top_ask{};
+    bool publish_pending{false};
+    // Copy-on-write: subscribe()/unsubscribe() swap in a new list, so
+    // publishing never copies the callbacks or takes mutex_.
+    std::atomic<std::shared_ptr<const Subscribers>> subscribers{std::make_shared<const Subscribers>()};
+    std::size_t subscriber_count{0};
+  };
+  // Symbols are never removed, so the index maps names to stable nodes.
+  using SymbolIndex = std::unordered_map<std::string, SymbolBooks*>;
+
+  struct Publication {
+    SymbolBooks* symbol{nullptr};
+    BookSnapshot view;
+  };
+
   void run();
+  // Applies one event; caller holds mutex_.
+  SymbolBooks& applyLocked(const common::BookEvent& event);
+  SymbolBooks& symbolFor(const std::string& symbol);
+  SymbolBooks& symbolFor(common::SymbolId id);
+  SymbolBooks* findSymbol(const std::string& symbol) const;
+  lob::LimitOrderBook& bookFor(SymbolBooks& symbol, common::ExchangeId exchange);
   void publisherLoop();
-  void enqueueSnapshot(common::AggregatedBookView view);
-  void publish(const common::AggregatedBookView& view);
-  common::AggregatedBookView consolidate() const;
-  void validateAggregatedView(const common::AggregatedBookView& view) const;
-  void maybeWarnOnStaleness(std::int64_t feed_span,
+  void conflatingPublisherLoop();
+  bool refreshTopOfBook(SymbolBooks& symbol);
+  // Builds and installs a fresh snapshot; caller holds mutex_.
+  BookSnapshot storeSnapshot(SymbolBooks& symbol) const;
+  void enqueueSnapshot(SymbolBooks& symbol, BookSnapshot view);
+  void publish(SymbolBooks& symbol, const BookSnapshot& view);
+  // Materialises the persistent consolidated ladder into a full view.
+  common::AggregatedBookView consolidate(SymbolBooks& symbol) const;
+  void validateAggregatedView(const SymbolBooks& symbol, const common::AggregatedBookView& view) const;
+  void maybeWarnOnStaleness(const SymbolBooks& symbol,
+                            std::int64_t feed_span,
                             std::int64_t local_span,
                             std::int64_t publish_delay) const;
 
   mutable std::mutex mutex_;
-  std::unordered_map<std::string, lob::LimitOrderBook> books_;
-  common::AggregatedBookView view_{};
-  mutable common::AggregatedQuote last_best_ask_{};
-  mutable bool last_best_ask_valid_{false};
-  std::unordered_set<std::string> expected_exchanges_;
-  std::unordered_set<std::string> ready_exchanges_;
-  bool require_all_ready_{false};
-
-  common::ConcurrentQueue<common::BookEvent> queue_;
-  common::ConcurrentQueue<common::AggregatedBookView> publish_queue_;
+  // Node-based, so SymbolBooks references stay valid as symbols are added.
+  mutable std::unordered_map<std::string, SymbolBooks> symbols_;
+  // Copy of the symbols_ keys for lock-free lookups; replaced when a
+  // symbol is added.
+  std::atomic<std::shared_ptr<const SymbolIndex>> symbol_index_{std::make_shared<const SymbolIndex>()};
+  // The same nodes indexed by SymbolId for the worker; null for symbols this
+  // engine has not seen. Guarded by mutex_.
+  std::vector<SymbolBooks*> symbols_by_id_;
+  lob::LevelDeltas level_deltas_;
+  PublishOptions publish_options_{};
+  std::vector<SymbolBooks*> publish_pending_;
+  bool publish_closed_{false};
+  std::condition_variable publish_cv_;
+
+  common::EventQueue<common::BookEvent> queue_;
+  common::EventQueue<Publication> publish_queue_;
   std::thread worker_;
   std::thread publisher_;
   std::atomic<bool> running_{false};
   mutable std::chrono::steady_clock::time_point last_staleness_warning_{};
 
-  std::unordered_map<SubscriberId, Subscriber> subscribers_;
+  std::unordered_map<SubscriberId, SymbolBooks*> subscriber_symbols_;
   std::atomic<SubscriberId> next_subscriber_id_{1};
 };
 
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <grpcpp/grpcpp.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "aggregator.grpc.pb.h"
+#include "hermeneutic/aggregator/aggregator.hpp"
+#include "hermeneutic/aggregator/config.hpp"
+#include "hermeneutic/common/events.hpp"
+
+namespace hermeneutic::aggregator {
+
+// Per-subscriber trim of the depth ladders (SubscribeRequest max_depth and
+// window_bps). Zero fields do not trim.
+struct BookFilter {
+  std::uint32_t max_depth{0};
+  std::uint32_t window_bps{0};
+
+  bool trims() const { return max_depth != 0 || window_bps != 0; }
+  bool operator==(const BookFilter&) const = default;
+};
+
+// Keeps at most max_depth levels per side, and only those priced within
+// window_bps of that side's best level. Best quotes and timestamps are
+// left untouched.
+common::AggregatedBookView filterBook(const common::AggregatedBookView& view, const BookFilter& filter);
+
+// One published book shared by every stream. Wire payloads are serialized
+// on first use and then reused, so each (message kind, encoding, filter)
+// combination is encoded once per book however many streams write it.
+// Frames are immutable once built and safe to use from any thread.
+class BookFrame {
+ public:
+  BookFrame(std::uint64_t sequence,
+            std::shared_ptr<const common::AggregatedBookView> view,
+            std::shared_ptr<const common::AggregatedBookView> previous);
+
+  // Fanout-wide publication number; consecutive frames differ by one.
+  std::uint64_t sequence() const { return sequence_; }
+  const common::AggregatedBookView& view() const { return *view_; }
+
+  // StreamBooks message.
+  const ::grpc::ByteBuffer& book(hermeneutic::grpc::BookEncoding encoding, const BookFilter& filter = {}) const;
+  // StreamBookUpdates snapshot carrying the full (filtered) ladder.
+  const ::grpc::ByteBuffer& snapshotUpdate(hermeneutic::grpc::BookEncoding encoding,
+                                           const BookFilter& filter = {}) const;
+  // StreamBookUpdates deltas against the previous frame under the same
+  // filter; only valid for a stream whose last message was built from
+  // frame sequence() - 1.
+  const ::grpc::ByteBuffer& deltaUpdate(hermeneutic::grpc::BookEncoding encoding,
+                                        const BookFilter& filter = {}) const;
+
+ private:
+  enum Payload : std::size_t { kBook, kSnapshot, kDelta, kPayloadCount };
+  static constexpr std::size_t kEncodingCount = 2;
+
+  struct Slot {
+    std::once_flag once;
+    ::grpc::ByteBuffer buffer;
+  };
+  using Slots = std::array<std::array<Slot, kEncodingCount>, kPayloadCount>;
+
+  // Trimmed copies of the view and its predecessor for one filter.
+  struct Filtered {
+    BookFilter filter;
+    common::AggregatedBookView view;
+    std::optional<common::AggregatedBookView> previous;
+    Slots slots;
+  };
+
+  const ::grpc::ByteBuffer& payload(Payload kind,
+                                    hermeneutic::grpc::BookEncoding encoding,
+                                    const BookFilter& filter) const;
+  Filtered& filtered(const BookFilter& filter) const;
+
+  std::uint64_t sequence_;
+  std::shared_ptr<const common::AggregatedBookView> view_;
+  std::shared_ptr<const common::AggregatedBookView> previous_;
+  mutable Slots slots_;
+  // Subscribers usually share a handful of filters, so a short list does.
+  mutable std::mutex filtered_mutex_;
+  mutable std::vector<std::unique_ptr<Filtered>> filtered_;
+};
+
+// Single engine subscription shared by all gRPC streams: every published
+// book becomes one BookFrame handed to each listener by pointer. The engine
+// subscription is only held while listeners exist, so an aggregator without
+// clients keeps skipping view materialisation.
+class BookFanout {
+ public:
+  using ListenerId = std::size_t;
+  using Listener = std::function<void(const std::shared_ptr<const BookFrame>&)>;
+
+  // Follows `symbol` on `engine`; the empty symbol is the engine's default.
+  explicit BookFanout(AggregationEngine& engine, std::string symbol = {});
+  ~BookFanout();
+
+  BookFanout(const BookFanout&) = delete;
+  BookFanout& operator=(const BookFanout&) = delete;
+
+  // The listener is handed the most recent frame, if any, before add()
+  // returns, so a new stream does not wait for the next book change.
+  ListenerId add(Listener listener);
+  // Once this returns the listener is not called again; a delivery in
+  // progress on another thread is waited out.
+  void remove(ListenerId id);
+
+ private:
+  struct Entry;
+  struct State;
+
+  AggregationEngine& engine_;
+  std::string symbol_;
+  std::shared_ptr<State> state_;
+};
+
+struct StreamStats {
+  std::size_t lag{0};      // frames queued behind the write in flight
+  std::size_t max_lag{0};  // high-water mark of lag
+  std::uint64_t sent{0};
+  std::uint64_t dropped{0};
+  std::uint64_t resyncs{0};  // snapshots an update stream resent after losing frames
+};
+
+// Frames one stream has been handed but not yet written, bounded by
+// StreamOptions. Dropping frames is safe for update streams: the next frame
+// no longer follows the last one sent, so it goes out as a snapshot. Not
+// thread-safe; the owning stream serialises access.
+class FrameQueue {
+ public:
+  explicit FrameQueue(StreamOptions options);
+
+  // Returns false when the slow-consumer policy says to disconnect; the
+  // frame is not queued in that case.
+  bool push(std::shared_ptr<const BookFrame> frame);
+  // Next frame to write, or null when the queue is empty.
+  std::shared_ptr<const BookFrame> pop();
+  void clear();
+
+  bool empty() const { return frames_.empty(); }
+  const StreamStats& stats() const { return stats_; }
+
+ private:
+  StreamOptions options_;
+  std::deque<std::shared_ptr<const BookFrame>> frames_;
+  StreamStats stats_;
+};
+
+}  // namespace hermeneutic::aggregator
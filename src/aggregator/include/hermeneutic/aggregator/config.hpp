@@ -1,28 +1,70 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
+#include "hermeneutic/common/event_queue.hpp"
+#include "hermeneutic/lob/price_ladder.hpp"
+
 namespace hermeneutic::aggregator {
 
 struct FeedConfig {
   std::string name;
+  // Instrument this feed quotes; defaults to AggregatorConfig::symbol.
+  std::string symbol;
   std::string url;
   std::string auth_token;
+  lob::BookOptions book{};
+};
+
+// What a gRPC stream does when its client falls more than max_pending
+// frames behind the publisher.
+enum class SlowConsumerPolicy {
+  DropOldest,  // discard the oldest queued frame
+  Conflate,    // keep only the newest frame, whatever max_pending says
+  Disconnect,  // end the stream with RESOURCE_EXHAUSTED
+};
+
+struct StreamOptions {
+  std::size_t max_pending{64};
+  SlowConsumerPolicy slow_consumer{SlowConsumerPolicy::DropOldest};
 };
 
 struct GrpcConfig {
   std::string listen_address{"0.0.0.0"};
   int port{50051};
   std::string auth_token;
+  StreamOptions stream{};
+};
+
+// Optional binary journal of every normalised event (hermeneutic::journal);
+// off while `directory` is empty.
+struct JournalConfig {
+  std::string directory;
+  std::uint64_t segment_bytes{256ULL << 20};
 };
 
 struct AggregatorConfig {
   std::vector<FeedConfig> feeds;
   std::chrono::milliseconds publish_interval{50};
+  bool publish_on_bbo_change{false};
+  // PublishOptions::max_batch for every shard.
+  std::size_t max_batch_events{64};
+  common::QueueOptions queue{};
+  // 0 runs every feed on its own blocking thread; otherwise the feeds share
+  // this many epoll loops (cex_type1::FeedReactor).
+  std::size_t feed_threads{0};
   std::string symbol{"BTCUSDT"};
+  // Aggregation workers; symbols are hashed across them.
+  std::size_t shards{1};
   GrpcConfig grpc;
+  JournalConfig journal;
+
+  // `symbol` first, then every other symbol a feed quotes.
+  std::vector<std::string> symbols() const;
 };
 
 AggregatorConfig loadAggregatorConfig(const std::string& path);
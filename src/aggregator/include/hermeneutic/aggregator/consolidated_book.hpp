@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "hermeneutic/common/events.hpp"
+#include "hermeneutic/lob/order_book.hpp"
+
+namespace hermeneutic::aggregator {
+
+// Cross-exchange price ladder maintained from per-book level deltas, so each
+// event costs O(changed levels) instead of a rebuild across every book.
+class ConsolidatedBook {
+ public:
+  struct Level {
+    common::Decimal quantity{};
+    // Number of exchange books currently quoting this price; the level is
+    // dropped once it reaches zero regardless of any rounding residue.
+    std::uint32_t sources{0};
+  };
+
+  using BidMap = std::map<common::Decimal, Level, std::greater<common::Decimal>>;
+  using AskMap = std::map<common::Decimal, Level, std::less<common::Decimal>>;
+
+  void apply(const lob::LevelDelta& delta);
+  void apply(const lob::LevelDeltas& deltas);
+  void clear();
+
+  // Copies the ladder into price-ordered vectors (best level first).
+  void materialize(std::vector<common::PriceLevel>& bids,
+                   std::vector<common::PriceLevel>& asks) const;
+
+  // Best bid/ask after virtually matching crossed liquidity, computed by
+  // walking only the crossed prefix of each side.
+  void uncrossedTop(common::AggregatedQuote& bid, common::AggregatedQuote& ask) const;
+
+  const BidMap& bids() const { return bids_; }
+  const AskMap& asks() const { return asks_; }
+  bool empty() const { return bids_.empty() && asks_.empty(); }
+
+ private:
+  BidMap bids_;
+  AskMap asks_;
+};
+
+// Virtually matches crossed liquidity between materialised ladders: fully
+// consumed levels are removed and partially matched ones keep the residue.
+void virtualUncross(std::vector<common::PriceLevel>& bids, std::vector<common::PriceLevel>& asks);
+
+}  // namespace hermeneutic::aggregator
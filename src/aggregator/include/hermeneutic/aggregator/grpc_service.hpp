@@ -2,30 +2,68 @@
 
 #include <grpcpp/grpcpp.h>
 
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "aggregator.grpc.pb.h"
 #include "hermeneutic/aggregator/aggregator.hpp"
+#include "hermeneutic/aggregator/book_fanout.hpp"
+#include "hermeneutic/aggregator/config.hpp"
+#include "hermeneutic/aggregator/sharded_aggregator.hpp"
 
 namespace hermeneutic::aggregator {
 
+struct SubscriberStats {
+  std::string peer;
+  std::string method;
+  std::string symbol;
+  StreamStats stream;
+};
+
+// Serves StreamBooks and StreamBookUpdates (full snapshot first, then
+// per-level deltas; see BookUpdate in the proto) on the gRPC callback API.
+// Each stream is a write reactor fed by BookFanout notifications, so no
+// thread is held per client and cancellation is handled as soon as gRPC
+// reports it. Responses are the raw ByteBuffers each BookFrame serialized
+// once for all subscribers. A stream that cannot keep up is handled per
+// StreamOptions instead of queueing without bound.
 class AggregatorGrpcService final : public hermeneutic::grpc::AggregatorService::Service {
  public:
   AggregatorGrpcService(AggregationEngine& engine,
                         std::string token,
-                        std::string symbol);
+                        std::string symbol,
+                        StreamOptions stream_options = {});
+  // Serves every symbol in `symbols` from the shard that owns it. Requests
+  // that leave the symbol empty get the first one.
+  AggregatorGrpcService(ShardedAggregator& aggregator,
+                        std::string token,
+                        const std::vector<std::string>& symbols,
+                        StreamOptions stream_options = {});
   ~AggregatorGrpcService() override = default;
 
-  ::grpc::Status StreamBooks(::grpc::ServerContext* context,
-                             const hermeneutic::grpc::SubscribeRequest* request,
-                             ::grpc::ServerWriter<hermeneutic::grpc::AggregatedBook>* writer) override;
+  ::grpc::Status checkRequest(const ::grpc::ServerContextBase& context,
+                              const hermeneutic::grpc::SubscribeRequest& request) const;
+
+  // Lag and drop counters of the streams currently open.
+  std::vector<SubscriberStats> subscriberStats() const;
 
  private:
-  bool authorize(const ::grpc::ServerContext& context) const;
+  class Stream;
+
+  void registerMethods();
+  bool authorize(const ::grpc::ServerContextBase& context) const;
+  BookFanout& fanoutFor(const std::string& symbol);
 
-  AggregationEngine& engine_;
   std::string expected_token_;
-  std::string symbol_;
+  std::string default_symbol_;
+  StreamOptions stream_options_;
+  std::unordered_map<std::string, std::unique_ptr<BookFanout>> fanouts_;
+  mutable std::mutex streams_mutex_;
+  std::unordered_set<Stream*> streams_;
 };
 
 }  // namespace hermeneutic::aggregator
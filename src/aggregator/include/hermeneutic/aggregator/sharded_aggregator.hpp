@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "hermeneutic/aggregator/aggregator.hpp"
+#include "hermeneutic/common/event_queue.hpp"
+#include "hermeneutic/common/events.hpp"
+
+namespace hermeneutic::aggregator {
+
+// Spreads symbols over several AggregationEngines, each with its own event
+// queue and worker thread. A symbol always maps to the same shard (its
+// SymbolId modulo the shard count), so its events stay ordered while
+// different symbols are consolidated in parallel. Dense ids spread the
+// configured symbols round-robin.
+class ShardedAggregator {
+ public:
+  explicit ShardedAggregator(std::size_t shard_count);
+  ShardedAggregator(std::size_t shard_count, common::QueueOptions queue_options);
+  ~ShardedAggregator();
+
+  ShardedAggregator(const ShardedAggregator&) = delete;
+  ShardedAggregator& operator=(const ShardedAggregator&) = delete;
+
+  void start();
+  void stop();
+
+  // Routes by event.symbol_id, interning event.symbol when it is unset.
+  void push(common::BookEvent event);
+
+  std::size_t shardCount() const { return shards_.size(); }
+  std::size_t shardIndex(const std::string& symbol) const;
+  // The engine that owns `symbol`; subscribe and query it with the symbol.
+  AggregationEngine& engineFor(const std::string& symbol);
+
+  // Applied to every shard; must be called before start().
+  void setPublishOptions(PublishOptions options);
+
+ private:
+  std::vector<std::unique_ptr<AggregationEngine>> shards_;
+};
+
+}  // namespace hermeneutic::aggregator
@@ -0,0 +1,62 @@
+#include "hermeneutic/aggregator/sharded_aggregator.hpp"
+
+#include <utility>
+
+#include "hermeneutic/common/assert.hpp"
+
+namespace hermeneutic::aggregator {
+
+ShardedAggregator::ShardedAggregator(std::size_t shard_count) {
+  HERMENEUTIC_ASSERT_DEBUG(shard_count > 0, "aggregator needs at least one shard");
+  shards_.reserve(shard_count);
+  for (std::size_t i = 0; i < shard_count; ++i) {
+    shards_.push_back(std::make_unique<AggregationEngine>());
+  }
+}
+
+ShardedAggregator::ShardedAggregator(std::size_t shard_count, common::QueueOptions queue_options) {
+  HERMENEUTIC_ASSERT_DEBUG(shard_count > 0, "aggregator needs at least one shard");
+  shards_.reserve(shard_count);
+  for (std::size_t i = 0; i < shard_count; ++i) {
+    shards_.push_back(std::make_unique<AggregationEngine>(queue_options));
+  }
+}
+
+ShardedAggregator::~ShardedAggregator() {
+  stop();
+}
+
+void ShardedAggregator::start() {
+  for (auto& shard : shards_) {
+    shard->start();
+  }
+}
+
+void ShardedAggregator::stop() {
+  for (auto& shard : shards_) {
+    shard->stop();
+  }
+}
+
+void ShardedAggregator::push(common::BookEvent event) {
+  if (event.symbol_id == common::kUnknownSymbol) {
+    event.symbol_id = common::SymbolRegistry::instance().intern(event.symbol);
+  }
+  shards_[event.symbol_id % shards_.size()]->push(std::move(event));
+}
+
+std::size_t ShardedAggregator::shardIndex(const std::string& symbol) const {
+  return common::SymbolRegistry::instance().intern(symbol) % shards_.size();
+}
+
+AggregationEngine& ShardedAggregator::engineFor(const std::string& symbol) {
+  return *shards_[shardIndex(symbol)];
+}
+
+void ShardedAggregator::setPublishOptions(PublishOptions options) {
+  for (auto& shard : shards_) {
+    shard->setPublishOptions(options);
+  }
+}
+
+}  // namespace hermeneutic::aggregator
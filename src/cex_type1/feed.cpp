@@ -1,4 +1,6 @@
 #include "hermeneutic/cex_type1/feed.hpp"
+#include "hermeneutic/cex_type1/feed_parser.hpp"
+#include "hermeneutic/cex_type1/frame_assembler.hpp"
 
 #include <Poco/Net/HTTPClientSession.h>
 #include <Poco/Net/HTTPRequest.h>
@@ -7,53 +9,16 @@
 #include <Poco/Timespan.h>
 #include <Poco/URI.h>
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
-#include <simdjson.h>
+#include <cstdint>
+#include <limits>
 #include <spdlog/spdlog.h>
-#include <string_view>
 #include <thread>
-#include <vector>
 
 namespace hermeneutic::cex_type1 {
 
-namespace {
-
-common::Side parseSide(std::string_view text) {
-  return text == "ask" ? common::Side::Ask : common::Side::Bid;
-}
-
-common::Decimal parseDecimal(const simdjson::dom::element& element) {
-  auto str = element.get_string();
-  if (str.error() == simdjson::SUCCESS) {
-    return common::Decimal::fromString(std::string(str.value()));
-  }
-  if (auto number_value = element.get_double(); number_value.error() == simdjson::SUCCESS) {
-    return common::Decimal::fromDouble(number_value.value());
-  }
-  throw std::runtime_error("invalid decimal payload");
-}
-
-bool parseOrderId(const simdjson::dom::element& element, std::uint64_t& id) {
-  auto numeric = element.get_uint64();
-  if (numeric.error() == simdjson::SUCCESS) {
-    id = numeric.value();
-    return true;
-  }
-  auto string_value = element.get_string();
-  if (string_value.error() == simdjson::SUCCESS) {
-    try {
-      id = std::stoull(std::string(string_value.value()));
-      return true;
-    } catch (...) {
-      return false;
-    }
-  }
-  return false;
-}
-
-}  // namespace
-
 class WebSocketExchangeFeed : public ExchangeFeed {
  public:
   WebSocketExchangeFeed(FeedOptions options, Callback callback)
@@ -105,93 +70,49 @@ class WebSocketExchangeFeed : public ExchangeFeed {
     Poco::Net::WebSocket ws(session, request, response);
     ws.setReceiveTimeout(Poco::Timespan(5, 0));
 
-    simdjson::dom::parser parser;
-    std::vector<char> buffer(4096);
+    // Poco rejects single frames above the limit before reading them; the
+    // assembler enforces it across fragments.
+    const auto max_frame = std::min<std::size_t>(options_.max_message_bytes, std::numeric_limits<int>::max());
+    ws.setMaxPayloadSize(static_cast<int>(max_frame));
+
+    FeedParser parser(options_.exchange, options_.symbol);
+    FrameAssembler assembler(options_.max_message_bytes);
+    common::BookEvent event;
     while (running_.load()) {
       int flags = 0;
-      int n = ws.receiveFrame(buffer.data(), static_cast<int>(buffer.size()), flags);
-      if (n <= 0) {
+      int n = ws.receiveFrame(assembler.prepare(), flags);
+      if (n < 0 || (n == 0 && flags == 0)) {
         break;
       }
-      auto op = flags & Poco::Net::WebSocket::FRAME_OP_BITMASK;
-      if (op == Poco::Net::WebSocket::FRAME_OP_PING) {
-        ws.sendFrame(buffer.data(), n, Poco::Net::WebSocket::FRAME_FLAG_FIN | Poco::Net::WebSocket::FRAME_OP_PONG);
-        continue;
-      }
-      if (op != Poco::Net::WebSocket::FRAME_OP_TEXT) {
-        continue;
-      }
-      std::string_view payload(buffer.data(), static_cast<std::size_t>(n));
-      if (payload.empty()) {
-        continue;
-      }
-      try {
-        auto doc = parser.parse(payload.data(), payload.size());
-        auto obj = doc.get_object();
-        auto type = obj["type"].get_string();
-        if (type.error() != simdjson::SUCCESS) {
+      const auto op = static_cast<std::uint8_t>(flags & Poco::Net::WebSocket::FRAME_OP_BITMASK);
+      const bool fin = (flags & Poco::Net::WebSocket::FRAME_FLAG_FIN) != 0;
+      switch (assembler.onFrame(op, fin, static_cast<std::size_t>(n))) {
+        case FrameAssembler::Frame::Message:
+          break;
+        case FrameAssembler::Frame::Ping: {
+          const auto payload = assembler.control();
+          ws.sendFrame(payload.data(), static_cast<int>(payload.size()),
+                       Poco::Net::WebSocket::FRAME_FLAG_FIN | Poco::Net::WebSocket::FRAME_OP_PONG);
           continue;
         }
-        common::BookEvent event;
-        event.exchange = options_.exchange;
-        auto now = std::chrono::system_clock::now();
-        event.timestamp = now;
-        event.local_timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
-        if (auto ts_ns = obj["timestamp_ns"].get_int64(); ts_ns.error() == simdjson::SUCCESS) {
-          event.feed_timestamp_ns = ts_ns.value();
-        } else if (auto ts_ms = obj["timestamp_ms"].get_int64(); ts_ms.error() == simdjson::SUCCESS) {
-          event.feed_timestamp_ns = ts_ms.value() * 1'000'000;
-        } else {
-          event.feed_timestamp_ns = event.local_timestamp_ns;
-        }
-        if (auto seq = obj["sequence"].get_uint64(); seq.error() == simdjson::SUCCESS) {
-          event.sequence = seq.value();
-        }
-        auto type_string = type.value();
-        if (type_string == "snapshot") {
-          event.kind = common::BookEventKind::Snapshot;
-          if (auto bids = obj["bids"].get_array(); bids.error() == simdjson::SUCCESS) {
-            for (auto level_element : bids.value()) {
-              auto level_obj = level_element.get_object();
-              common::PriceLevel level;
-              level.price = parseDecimal(level_obj["price"]);
-              level.quantity = parseDecimal(level_obj["quantity"]);
-              event.snapshot.bids.push_back(std::move(level));
-            }
-          }
-          if (auto asks = obj["asks"].get_array(); asks.error() == simdjson::SUCCESS) {
-            for (auto level_element : asks.value()) {
-              auto level_obj = level_element.get_object();
-              common::PriceLevel level;
-              level.price = parseDecimal(level_obj["price"]);
-              level.quantity = parseDecimal(level_obj["quantity"]);
-              event.snapshot.asks.push_back(std::move(level));
-            }
-          }
-          callback_(std::move(event));
-        } else if (type_string == "new_order") {
-          event.kind = common::BookEventKind::NewOrder;
-          std::uint64_t order_id = 0;
-          if (!parseOrderId(obj["order_id"], order_id)) {
-            continue;
-          }
-          event.order.order_id = order_id;
-          auto side_value = obj["side"].get_string();
-          if (side_value.error() != simdjson::SUCCESS) {
-            continue;
-          }
-          event.order.side = parseSide(side_value.value());
-          event.order.price = parseDecimal(obj["price"]);
-          event.order.quantity = parseDecimal(obj["quantity"]);
-          callback_(std::move(event));
-        } else if (type_string == "cancel_order") {
-          event.kind = common::BookEventKind::CancelOrder;
-          std::uint64_t order_id = 0;
-          if (!parseOrderId(obj["order_id"], order_id)) {
-            continue;
-          }
-          event.order.order_id = order_id;
-          callback_(std::move(event));
+        case FrameAssembler::Frame::Close:
+          return;
+        case FrameAssembler::Frame::Oversized:
+          spdlog::warn("Feed {} dropping message larger than {} bytes", options_.exchange,
+                       assembler.maxMessageSize());
+          continue;
+        default:
+          continue;
+      }
+      try {
+        const auto now = std::chrono::system_clock::now();
+        const auto local_ns =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+        // The assembler keeps FeedParser::kPadding bytes behind the message,
+        // so it is parsed in place.
+        const auto message = assembler.message();
+        if (parser.parse(message.data(), message.size(), local_ns, event)) {
+          callback_(event);
         }
       } catch (const std::exception& ex) {
         spdlog::warn("Feed {} parse error: {}", options_.exchange, ex.what());
@@ -0,0 +1,193 @@
+#include "hermeneutic/cex_type1/feed_parser.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+namespace hermeneutic::cex_type1 {
+
+namespace {
+
+using simdjson::ondemand::json_type;
+
+common::Side parseSide(std::string_view text) {
+  return text == "ask" ? common::Side::Ask : common::Side::Bid;
+}
+
+common::Decimal parseDecimal(simdjson::ondemand::value value) {
+  switch (value.type()) {
+    case json_type::string:
+      return common::Decimal::fromString(value.get_string().value());
+    case json_type::number:
+      return common::Decimal::fromDouble(value.get_double());
+    default:
+      throw std::runtime_error("invalid decimal payload");
+  }
+}
+
+bool parseOrderId(simdjson::ondemand::value value, std::uint64_t& id) {
+  switch (value.type()) {
+    case json_type::number: {
+      auto numeric = value.get_uint64();
+      if (numeric.error() != simdjson::SUCCESS) {
+        return false;
+      }
+      id = numeric.value_unsafe();
+      return true;
+    }
+    case json_type::string: {
+      const std::string_view text = value.get_string();
+      const auto* end = text.data() + text.size();
+      auto [ptr, ec] = std::from_chars(text.data(), end, id);
+      return ec == std::errc{} && ptr == end;
+    }
+    default:
+      return false;
+  }
+}
+
+void parseLevels(simdjson::ondemand::array levels, std::vector<common::PriceLevel>& out) {
+  for (simdjson::ondemand::object level_obj : levels) {
+    common::PriceLevel level;
+    bool has_price = false;
+    bool has_quantity = false;
+    for (auto field : level_obj) {
+      const std::string_view key = field.unescaped_key();
+      if (key == "price") {
+        level.price = parseDecimal(field.value());
+        has_price = true;
+      } else if (key == "quantity") {
+        level.quantity = parseDecimal(field.value());
+        has_quantity = true;
+      }
+    }
+    if (!has_price || !has_quantity) {
+      throw std::runtime_error("invalid decimal payload");
+    }
+    out.push_back(level);
+  }
+}
+
+}  // namespace
+
+FeedParser::FeedParser(std::string exchange, std::string_view symbol)
+    : exchange_(std::move(exchange)),
+      exchange_id_(exchange_.empty() ? common::kUnknownExchange
+                                     : common::ExchangeRegistry::instance().intern(exchange_)),
+      symbol_id_(common::SymbolRegistry::instance().intern(symbol)) {}
+
+bool FeedParser::parse(std::string_view payload,
+                       std::int64_t local_timestamp_ns,
+                       common::BookEvent& event) {
+  scratch_.assign(payload);
+  scratch_.resize(payload.size() + kPadding, '\0');
+  return parse(scratch_.data(), payload.size(), local_timestamp_ns, event);
+}
+
+bool FeedParser::parse(const char* data,
+                       std::size_t length,
+                       std::int64_t local_timestamp_ns,
+                       common::BookEvent& event) {
+  auto doc = parser_.iterate(data, length, length + kPadding);
+  simdjson::ondemand::object obj = doc.get_object();
+
+  event.sequence = 0;
+  event.order = common::MarketOrder{};
+  event.snapshot.bids.clear();
+  event.snapshot.asks.clear();
+
+  std::string_view type;
+  std::int64_t timestamp_ns = 0;
+  std::int64_t timestamp_ms = 0;
+  bool has_timestamp_ns = false;
+  bool has_timestamp_ms = false;
+  bool has_order_id = false;
+  bool has_side = false;
+  bool has_price = false;
+  bool has_quantity = false;
+
+  // One forward pass over the fields: On-Demand values can only be consumed
+  // once and field order is not guaranteed by the exchanges.
+  for (auto field : obj) {
+    const std::string_view key = field.unescaped_key();
+    simdjson::ondemand::value value = field.value();
+    if (key == "type") {
+      auto text = value.get_string();
+      if (text.error() != simdjson::SUCCESS) {
+        return false;
+      }
+      type = text.value_unsafe();
+    } else if (key == "sequence") {
+      if (auto seq = value.get_uint64(); seq.error() == simdjson::SUCCESS) {
+        event.sequence = seq.value_unsafe();
+      }
+    } else if (key == "timestamp_ns") {
+      if (auto ts = value.get_int64(); ts.error() == simdjson::SUCCESS) {
+        timestamp_ns = ts.value_unsafe();
+        has_timestamp_ns = true;
+      }
+    } else if (key == "timestamp_ms") {
+      if (auto ts = value.get_int64(); ts.error() == simdjson::SUCCESS) {
+        timestamp_ms = ts.value_unsafe();
+        has_timestamp_ms = true;
+      }
+    } else if (key == "order_id") {
+      has_order_id = parseOrderId(value, event.order.order_id);
+    } else if (key == "side") {
+      if (auto side = value.get_string(); side.error() == simdjson::SUCCESS) {
+        event.order.side = parseSide(side.value_unsafe());
+        has_side = true;
+      }
+    } else if (key == "price") {
+      event.order.price = parseDecimal(value);
+      has_price = true;
+    } else if (key == "quantity") {
+      event.order.quantity = parseDecimal(value);
+      has_quantity = true;
+    } else if (key == "bids") {
+      parseLevels(value.get_array(), event.snapshot.bids);
+    } else if (key == "asks") {
+      parseLevels(value.get_array(), event.snapshot.asks);
+    }
+  }
+
+  if (type == "snapshot") {
+    event.kind = common::BookEventKind::Snapshot;
+  } else if (type == "new_order") {
+    if (!has_order_id || !has_side) {
+      return false;
+    }
+    if (!has_price || !has_quantity) {
+      throw std::runtime_error("invalid decimal payload");
+    }
+    event.kind = common::BookEventKind::NewOrder;
+  } else if (type == "cancel_order") {
+    if (!has_order_id) {
+      return false;
+    }
+    event.kind = common::BookEventKind::CancelOrder;
+  } else {
+    return false;
+  }
+
+  event.exchange_id = exchange_id_;
+  if (exchange_id_ == common::kUnknownExchange) {
+    event.exchange = exchange_;
+  }
+  event.symbol_id = symbol_id_;
+  event.timestamp = std::chrono::system_clock::time_point(
+      std::chrono::duration_cast<std::chrono::system_clock::duration>(
+          std::chrono::nanoseconds(local_timestamp_ns)));
+  event.local_timestamp_ns = local_timestamp_ns;
+  if (has_timestamp_ns) {
+    event.feed_timestamp_ns = timestamp_ns;
+  } else if (has_timestamp_ms) {
+    event.feed_timestamp_ns = timestamp_ms * 1'000'000;
+  } else {
+    event.feed_timestamp_ns = local_timestamp_ns;
+  }
+  return true;
+}
+
+}  // namespace hermeneutic::cex_type1
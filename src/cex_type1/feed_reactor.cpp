@@ -0,0 +1,759 @@
+#include "hermeneutic/cex_type1/feed_reactor.hpp"
+
+#include <Poco/Base64Encoder.h>
+#include <Poco/SHA1Engine.h>
+#include <Poco/URI.h>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+#include <spdlog/spdlog.h>
+
+#include "hermeneutic/cex_type1/feed_parser.hpp"
+#include "hermeneutic/cex_type1/frame_assembler.hpp"
+
+namespace hermeneutic::cex_type1 {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Same receive timeout the blocking feed puts on its socket.
+constexpr auto kIdleTimeout = std::chrono::seconds(5);
+constexpr auto kConnectTimeout = std::chrono::seconds(5);
+// A feed retrying in a tight loop would starve the others on its loop.
+constexpr auto kMinRetryDelay = std::chrono::milliseconds(10);
+constexpr std::size_t kReadChunk = 64 * 1024;
+constexpr std::size_t kMaxHandshakeBytes = 16 * 1024;
+constexpr int kMaxEvents = 64;
+constexpr std::string_view kWebSocketGuid = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+std::string base64(const unsigned char* data, std::size_t length) {
+  std::ostringstream out;
+  Poco::Base64Encoder encoder(out);
+  encoder.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(length));
+  encoder.close();
+  return out.str();
+}
+
+std::string expectedAccept(const std::string& key) {
+  Poco::SHA1Engine sha1;
+  sha1.update(key);
+  sha1.update(kWebSocketGuid.data(), static_cast<unsigned>(kWebSocketGuid.size()));
+  const auto& digest = sha1.digest();
+  return base64(digest.data(), digest.size());
+}
+
+bool equalsIgnoreCase(std::string_view lhs, std::string_view rhs) {
+  return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](char a, char b) {
+           return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+         });
+}
+
+// Value of `name` in an HTTP header block, or an empty view.
+std::string_view headerValue(std::string_view headers, std::string_view name) {
+  std::size_t line_start = headers.find("\r\n");
+  while (line_start != std::string_view::npos && line_start + 2 < headers.size()) {
+    line_start += 2;
+    const auto line_end = headers.find("\r\n", line_start);
+    const auto line = headers.substr(line_start, line_end - line_start);
+    const auto colon = line.find(':');
+    if (colon != std::string_view::npos && equalsIgnoreCase(line.substr(0, colon), name)) {
+      auto value = line.substr(colon + 1);
+      while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+        value.remove_prefix(1);
+      }
+      while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+        value.remove_suffix(1);
+      }
+      return value;
+    }
+    line_start = line_end;
+  }
+  return {};
+}
+
+}  // namespace
+
+// Per-feed connection state, owned by the feed and touched only by its loop.
+struct FeedConnection {
+  enum class State { Idle, Waiting, Resolving, Connecting, Handshaking, Open };
+
+  FeedConnection(FeedOptions feed_options, ExchangeFeed::Callback feed_callback)
+      : options(std::move(feed_options)),
+        callback(std::move(feed_callback)),
+        parser(options.exchange, options.symbol),
+        assembler(options.max_message_bytes) {}
+
+  FeedOptions options;
+  ExchangeFeed::Callback callback;
+  FeedParser parser;
+  FrameAssembler assembler;
+  common::BookEvent event;
+
+  State state{State::Idle};
+  int fd{-1};
+  Clock::time_point deadline{};
+  // Identifies the lookup in flight, so a late answer for an abandoned
+  // attempt (or a removed feed) is ignored.
+  std::uint64_t attempt{0};
+  std::string host;
+  std::string port;
+  std::string path;
+  std::string accept;
+  bool want_write{false};
+
+  // Raw socket bytes not consumed yet live in input[input_begin, input_end).
+  std::vector<char> input;
+  std::size_t input_begin{0};
+  std::size_t input_end{0};
+  std::string output;
+  std::size_t output_sent{0};
+
+  // Frame whose payload is being copied into the assembler.
+  struct {
+    bool active{false};
+    bool fin{false};
+    bool masked{false};
+    std::uint8_t opcode{0};
+    std::array<unsigned char, 4> mask{};
+    std::size_t length{0};
+    std::size_t received{0};
+    // Payload too large for the assembler: `skip` bytes are left to drop.
+    bool discard{false};
+    std::uint64_t skip{0};
+    Poco::Buffer<char>* target{nullptr};
+  } frame;
+};
+
+class FeedReactor::Loop {
+ public:
+  Loop() {
+    epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd_ < 0 || wake_fd_ < 0) {
+      throw std::system_error(errno, std::generic_category(), "feed reactor setup failed");
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
+    if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event) != 0) {
+      const int error = errno;
+      ::close(wake_fd_);
+      ::close(epoll_fd_);
+      throw std::system_error(error, std::generic_category(), "feed reactor setup failed");
+    }
+    resolver_ = std::thread(&Loop::resolveLoop, this);
+    thread_ = std::thread(&Loop::run, this);
+  }
+
+  ~Loop() {
+    running_.store(false);
+    wake();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    {
+      std::lock_guard<std::mutex> lock(resolve_mutex_);
+      resolve_stopping_ = true;
+    }
+    resolve_cv_.notify_one();
+    if (resolver_.joinable()) {
+      resolver_.join();
+    }
+    for (auto* connection : connections_) {
+      closeSocket(*connection);
+    }
+    ::close(wake_fd_);
+    ::close(epoll_fd_);
+  }
+
+  void add(FeedConnection& connection) {
+    execute([this, &connection] {
+      connection.state = FeedConnection::State::Waiting;
+      connection.deadline = Clock::now();
+      connections_.push_back(&connection);
+    });
+  }
+
+  // Returns once the loop no longer references `connection`, so no callback
+  // runs after it (unless called from that callback).
+  void remove(FeedConnection& connection) {
+    execute([this, &connection] {
+      closeSocket(connection);
+      connection.state = FeedConnection::State::Idle;
+      connections_.erase(std::remove(connections_.begin(), connections_.end(), &connection), connections_.end());
+    });
+  }
+
+ private:
+  void execute(std::function<void()> task) {
+    if (std::this_thread::get_id() == thread_.get_id()) {
+      task();
+      return;
+    }
+    std::packaged_task<void()> packaged(std::move(task));
+    auto done = packaged.get_future();
+    post(std::move(packaged));
+    done.get();
+  }
+
+  // Runs `task` on the loop thread without waiting for it.
+  void post(std::packaged_task<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push_back(std::move(task));
+    }
+    wake();
+  }
+
+  void wake() {
+    const std::uint64_t one = 1;
+    [[maybe_unused]] auto written = ::write(wake_fd_, &one, sizeof(one));
+  }
+
+  void run() {
+    std::array<epoll_event, kMaxEvents> events{};
+    while (running_.load()) {
+      const int ready = ::epoll_wait(epoll_fd_, events.data(), kMaxEvents, timeoutMs());
+      if (ready < 0 && errno != EINTR) {
+        spdlog::error("Feed reactor epoll_wait failed: {}", std::strerror(errno));
+        break;
+      }
+      bool woken = false;
+      for (int i = 0; i < ready; ++i) {
+        auto* connection = static_cast<FeedConnection*>(events[static_cast<std::size_t>(i)].data.ptr);
+        if (connection == nullptr) {
+          woken = true;
+        } else if (connection->fd >= 0) {
+          onEvents(*connection, events[static_cast<std::size_t>(i)].events);
+        }
+      }
+      // Tasks run between batches so add/remove never race a pending event.
+      if (woken) {
+        std::uint64_t count = 0;
+        [[maybe_unused]] auto drained = ::read(wake_fd_, &count, sizeof(count));
+        runTasks();
+      }
+      checkDeadlines();
+    }
+    runTasks();
+  }
+
+  void runTasks() {
+    std::vector<std::packaged_task<void()>> tasks;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks.swap(tasks_);
+    }
+    for (auto& task : tasks) {
+      task();
+    }
+  }
+
+  int timeoutMs() const {
+    auto timeout = std::chrono::milliseconds(1000);
+    const auto now = Clock::now();
+    for (const auto* connection : connections_) {
+      const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(connection->deadline - now);
+      timeout = std::clamp(remaining, std::chrono::milliseconds(0), timeout);
+    }
+    return static_cast<int>(timeout.count());
+  }
+
+  void checkDeadlines() {
+    const auto now = Clock::now();
+    for (std::size_t i = 0; i < connections_.size(); ++i) {
+      auto& connection = *connections_[i];
+      if (connection.deadline > now) {
+        continue;
+      }
+      switch (connection.state) {
+        case FeedConnection::State::Waiting:
+          resolve(connection);
+          break;
+        case FeedConnection::State::Resolving:
+        case FeedConnection::State::Connecting:
+        case FeedConnection::State::Handshaking:
+          fail(connection, "connect timed out");
+          break;
+        case FeedConnection::State::Open:
+          fail(connection, "receive timed out");
+          break;
+        case FeedConnection::State::Idle:
+          break;
+      }
+    }
+  }
+
+  // getaddrinfo() blocks, so lookups run on the resolver thread and the
+  // result comes back to the loop as a task.
+  void resolve(FeedConnection& connection) {
+    try {
+      Poco::URI uri(connection.options.url);
+      connection.path = uri.getPathAndQuery();
+      if (connection.path.empty()) {
+        connection.path = "/";
+      }
+      connection.host = uri.getHost();
+      connection.port = std::to_string(uri.getPort());
+    } catch (const std::exception& ex) {
+      fail(connection, ex.what());
+      return;
+    }
+    connection.attempt = ++next_attempt_;
+    connection.state = FeedConnection::State::Resolving;
+    connection.deadline = Clock::now() + kConnectTimeout;
+    {
+      std::lock_guard<std::mutex> lock(resolve_mutex_);
+      lookups_.push_back({&connection, connection.attempt, connection.host, connection.port});
+    }
+    resolve_cv_.notify_one();
+  }
+
+  void resolveLoop() {
+    std::unique_lock<std::mutex> lock(resolve_mutex_);
+    for (;;) {
+      resolve_cv_.wait(lock, [this] { return resolve_stopping_ || !lookups_.empty(); });
+      if (resolve_stopping_) {
+        return;
+      }
+      auto lookup = std::move(lookups_.front());
+      lookups_.erase(lookups_.begin());
+      lock.unlock();
+
+      addrinfo hints{};
+      hints.ai_family = AF_UNSPEC;
+      hints.ai_socktype = SOCK_STREAM;
+      addrinfo* resolved = nullptr;
+      const int rc = ::getaddrinfo(lookup.host.c_str(), lookup.port.c_str(), &hints, &resolved);
+      std::shared_ptr<addrinfo> result(rc == 0 ? resolved : nullptr, [](addrinfo* info) {
+        if (info != nullptr) {
+          ::freeaddrinfo(info);
+        }
+      });
+      std::string error = rc == 0 ? std::string{} : "cannot resolve " + lookup.host + ": " + ::gai_strerror(rc);
+      post(std::packaged_task<void()>(
+          [this, lookup = std::move(lookup), result = std::move(result), error = std::move(error)] {
+            // The feed may have been removed or given up on meanwhile.
+            auto* connection = lookup.connection;
+            if (std::find(connections_.begin(), connections_.end(), connection) == connections_.end() ||
+                connection->state != FeedConnection::State::Resolving || connection->attempt != lookup.attempt) {
+              return;
+            }
+            if (!result) {
+              fail(*connection, error);
+              return;
+            }
+            connect(*connection, *result);
+          }));
+      lock.lock();
+    }
+  }
+
+  void connect(FeedConnection& connection, const addrinfo& resolved) {
+    try {
+      connection.fd = ::socket(resolved.ai_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+      if (connection.fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "socket");
+      }
+      const int one = 1;
+      ::setsockopt(connection.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+      if (::connect(connection.fd, resolved.ai_addr, resolved.ai_addrlen) < 0 && errno != EINPROGRESS) {
+        throw std::system_error(errno, std::generic_category(), "connect");
+      }
+
+      std::array<unsigned char, 16> nonce{};
+      for (auto& byte : nonce) {
+        byte = static_cast<unsigned char>(random_());
+      }
+      const auto key = base64(nonce.data(), nonce.size());
+      connection.accept = expectedAccept(key);
+      connection.output = "GET " + connection.path + " HTTP/1.1\r\nHost: " + connection.host + ":" +
+                          connection.port +
+                          "\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Key: " + key +
+                          "\r\nSec-WebSocket-Version: 13\r\n";
+      if (!connection.options.auth_token.empty()) {
+        connection.output += "Authorization: Bearer " + connection.options.auth_token + "\r\n";
+      }
+      connection.output += "\r\n";
+      connection.output_sent = 0;
+      connection.input_begin = connection.input_end = 0;
+      connection.frame.active = false;
+      connection.assembler.reset();
+
+      epoll_event event{};
+      event.events = EPOLLIN | EPOLLOUT;
+      event.data.ptr = &connection;
+      if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, connection.fd, &event) != 0) {
+        throw std::system_error(errno, std::generic_category(), "epoll_ctl");
+      }
+      connection.want_write = true;
+      connection.state = FeedConnection::State::Connecting;
+      connection.deadline = Clock::now() + kConnectTimeout;
+    } catch (const std::exception& ex) {
+      fail(connection, ex.what());
+    }
+  }
+
+  void onEvents(FeedConnection& connection, std::uint32_t events) {
+    if (connection.state == FeedConnection::State::Connecting) {
+      int error = 0;
+      socklen_t length = sizeof(error);
+      ::getsockopt(connection.fd, SOL_SOCKET, SO_ERROR, &error, &length);
+      if (error != 0) {
+        fail(connection, std::strerror(error));
+        return;
+      }
+      if ((events & EPOLLOUT) == 0) {
+        return;
+      }
+      connection.state = FeedConnection::State::Handshaking;
+    }
+    if ((events & EPOLLOUT) != 0 && !flush(connection)) {
+      return;
+    }
+    if ((events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0) {
+      receive(connection);
+    }
+  }
+
+  // Sends pending output; false when the connection failed meanwhile.
+  bool flush(FeedConnection& connection) {
+    while (connection.output_sent < connection.output.size()) {
+      const auto sent = ::send(connection.fd, connection.output.data() + connection.output_sent,
+                               connection.output.size() - connection.output_sent, MSG_NOSIGNAL);
+      if (sent < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+          return watch(connection, true);
+        }
+        fail(connection, std::strerror(errno));
+        return false;
+      }
+      connection.output_sent += static_cast<std::size_t>(sent);
+    }
+    connection.output.clear();
+    connection.output_sent = 0;
+    return watch(connection, false);
+  }
+
+  // False when the connection failed meanwhile.
+  bool watch(FeedConnection& connection, bool want_write) {
+    if (connection.want_write == want_write) {
+      return true;
+    }
+    epoll_event event{};
+    event.events = EPOLLIN | (want_write ? EPOLLOUT : 0u);
+    event.data.ptr = &connection;
+    if (::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, connection.fd, &event) != 0) {
+      fail(connection, std::string("epoll_ctl: ") + std::strerror(errno));
+      return false;
+    }
+    connection.want_write = want_write;
+    return true;
+  }
+
+  void receive(FeedConnection& connection) {
+    auto& input = connection.input;
+    if (input.size() - connection.input_end < kReadChunk) {
+      std::memmove(input.data(), input.data() + connection.input_begin, connection.input_end - connection.input_begin);
+      connection.input_end -= connection.input_begin;
+      connection.input_begin = 0;
+      if (input.size() - connection.input_end < kReadChunk) {
+        input.resize(std::max(input.size() * 2, connection.input_end + kReadChunk));
+      }
+    }
+    // One read per readiness event keeps busy feeds from starving the rest
+    // of the loop; level-triggered epoll reports the remainder.
+    const auto received =
+        ::recv(connection.fd, input.data() + connection.input_end, input.size() - connection.input_end, 0);
+    if (received == 0) {
+      fail(connection, "connection closed by peer");
+      return;
+    }
+    if (received < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        fail(connection, std::strerror(errno));
+      }
+      return;
+    }
+    connection.input_end += static_cast<std::size_t>(received);
+
+    if (connection.state == FeedConnection::State::Handshaking && !handshake(connection)) {
+      return;
+    }
+    if (connection.state == FeedConnection::State::Open) {
+      connection.deadline = Clock::now() + kIdleTimeout;
+      decode(connection);
+    }
+  }
+
+  // Consumes the HTTP upgrade response; false until it is complete and valid.
+  bool handshake(FeedConnection& connection) {
+    const std::string_view buffered(connection.input.data() + connection.input_begin,
+                                    connection.input_end - connection.input_begin);
+    const auto end = buffered.find("\r\n\r\n");
+    if (end == std::string_view::npos) {
+      if (buffered.size() > kMaxHandshakeBytes) {
+        fail(connection, "oversized handshake response");
+      }
+      return false;
+    }
+    const auto headers = buffered.substr(0, end + 2);
+    const auto status_line = headers.substr(0, headers.find("\r\n"));
+    if (status_line.find(" 101") == std::string_view::npos) {
+      fail(connection, "handshake rejected: " + std::string(status_line));
+      return false;
+    }
+    if (headerValue(headers, "Sec-WebSocket-Accept") != connection.accept) {
+      fail(connection, "handshake returned a bad Sec-WebSocket-Accept");
+      return false;
+    }
+    connection.input_begin += end + 4;
+    connection.state = FeedConnection::State::Open;
+    return true;
+  }
+
+  void decode(FeedConnection& connection) {
+    auto& frame = connection.frame;
+    while (connection.state == FeedConnection::State::Open) {
+      const auto* data = reinterpret_cast<const unsigned char*>(connection.input.data() + connection.input_begin);
+      const auto available = connection.input_end - connection.input_begin;
+      if (!frame.active) {
+        if (available < 2) {
+          return;
+        }
+        std::size_t header = 2;
+        std::uint64_t length = data[1] & 0x7Fu;
+        if (length == 126) {
+          header = 4;
+          if (available < header) {
+            return;
+          }
+          length = (std::uint64_t{data[2]} << 8) | data[3];
+        } else if (length == 127) {
+          header = 10;
+          if (available < header) {
+            return;
+          }
+          length = 0;
+          for (std::size_t i = 2; i < 10; ++i) {
+            length = (length << 8) | data[i];
+          }
+        }
+        frame.masked = (data[1] & 0x80u) != 0;
+        if (frame.masked) {
+          if (available < header + 4) {
+            return;
+          }
+          std::copy_n(data + header, 4, frame.mask.begin());
+          header += 4;
+        }
+        frame.active = true;
+        frame.fin = (data[0] & 0x80u) != 0;
+        frame.opcode = static_cast<std::uint8_t>(data[0] & 0x0Fu);
+        frame.received = 0;
+        // A frame that alone exceeds the limit is skipped as it arrives
+        // rather than buffered; its message is dropped like the blocking
+        // feed drops an oversized one, without reconnecting.
+        frame.discard = length > connection.options.max_message_bytes;
+        frame.length = frame.discard ? 0 : static_cast<std::size_t>(length);
+        frame.skip = frame.discard ? length : 0;
+        // Payload bytes are copied straight into the assembler as they arrive,
+        // so the socket buffer stays small even for deep snapshots.
+        frame.target = frame.discard ? nullptr : &connection.assembler.prepare(frame.length);
+        connection.input_begin += header;
+        continue;
+      }
+
+      if (frame.discard) {
+        const auto skipped = static_cast<std::size_t>(std::min<std::uint64_t>(available, frame.skip));
+        frame.skip -= skipped;
+        connection.input_begin += skipped;
+        if (frame.skip != 0) {
+          return;
+        }
+        frame.active = false;
+        dispatch(connection, connection.assembler.onDiscardedFrame(frame.opcode, frame.fin));
+        continue;
+      }
+
+      const auto take = std::min(available, frame.length - frame.received);
+      if (take > 0) {
+        frame.target->append(connection.input.data() + connection.input_begin, take);
+        if (frame.masked) {
+          auto* payload = frame.target->begin() + frame.target->size() - take;
+          for (std::size_t i = 0; i < take; ++i) {
+            payload[i] = static_cast<char>(payload[i] ^ frame.mask[(frame.received + i) & 3]);
+          }
+        }
+        frame.received += take;
+        connection.input_begin += take;
+      }
+      if (frame.received < frame.length) {
+        return;
+      }
+      frame.active = false;
+      dispatch(connection, connection.assembler.onFrame(frame.opcode, frame.fin, frame.length));
+    }
+  }
+
+  void dispatch(FeedConnection& connection, FrameAssembler::Frame kind) {
+    switch (kind) {
+      case FrameAssembler::Frame::Message:
+        break;
+      case FrameAssembler::Frame::Ping:
+        sendControl(connection, FrameAssembler::kPong, connection.assembler.control());
+        return;
+      case FrameAssembler::Frame::Close:
+        sendControl(connection, FrameAssembler::kClose, connection.assembler.control());
+        fail(connection, "connection closed by peer");
+        return;
+      case FrameAssembler::Frame::Oversized:
+        spdlog::warn("Feed {} dropping message larger than {} bytes", connection.options.exchange,
+                     connection.assembler.maxMessageSize());
+        return;
+      default:
+        return;
+    }
+    try {
+      const auto now = std::chrono::system_clock::now();
+      const auto local_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+      const auto message = connection.assembler.message();
+      if (connection.parser.parse(message.data(), message.size(), local_ns, connection.event)) {
+        connection.callback(connection.event);
+      }
+    } catch (const std::exception& ex) {
+      spdlog::warn("Feed {} parse error: {}", connection.options.exchange, ex.what());
+    }
+  }
+
+  // Client frames must be masked (RFC 6455 5.3).
+  void sendControl(FeedConnection& connection, std::uint8_t opcode, std::string_view payload) {
+    payload = payload.substr(0, 125);
+    std::array<unsigned char, 4> mask{};
+    for (auto& byte : mask) {
+      byte = static_cast<unsigned char>(random_());
+    }
+    auto& output = connection.output;
+    output.push_back(static_cast<char>(0x80u | opcode));
+    output.push_back(static_cast<char>(0x80u | payload.size()));
+    output.append(reinterpret_cast<const char*>(mask.data()), mask.size());
+    for (std::size_t i = 0; i < payload.size(); ++i) {
+      output.push_back(static_cast<char>(payload[i] ^ static_cast<char>(mask[i & 3])));
+    }
+    flush(connection);
+  }
+
+  void fail(FeedConnection& connection, const std::string& reason) {
+    spdlog::warn("Feed {} connection error: {}", connection.options.exchange, reason);
+    closeSocket(connection);
+    connection.state = FeedConnection::State::Waiting;
+    connection.deadline = Clock::now() + std::max<Clock::duration>(connection.options.interval, kMinRetryDelay);
+  }
+
+  void closeSocket(FeedConnection& connection) {
+    if (connection.fd >= 0) {
+      ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, connection.fd, nullptr);
+      ::close(connection.fd);
+      connection.fd = -1;
+    }
+    connection.want_write = false;
+    connection.output.clear();
+    connection.output_sent = 0;
+    connection.frame.active = false;
+  }
+
+  int epoll_fd_{-1};
+  int wake_fd_{-1};
+  std::atomic<bool> running_{true};
+  std::mutex mutex_;
+  std::vector<std::packaged_task<void()>> tasks_;
+  std::vector<FeedConnection*> connections_;
+  std::minstd_rand random_{std::random_device{}()};
+  std::uint64_t next_attempt_{0};
+
+  struct Lookup {
+    FeedConnection* connection;
+    std::uint64_t attempt;
+    std::string host;
+    std::string port;
+  };
+  std::mutex resolve_mutex_;
+  std::condition_variable resolve_cv_;
+  std::vector<Lookup> lookups_;
+  bool resolve_stopping_{false};
+  std::thread resolver_;
+  std::thread thread_;
+};
+
+namespace {
+
+class ReactorFeed : public ExchangeFeed {
+ public:
+  ReactorFeed(FeedReactor::Loop& loop, FeedOptions options, Callback callback)
+      : loop_(loop), connection_(std::move(options), std::move(callback)) {}
+
+  ~ReactorFeed() override { stop(); }
+
+  void start() override {
+    if (running_.exchange(true)) {
+      return;
+    }
+    loop_.add(connection_);
+  }
+
+  void stop() override {
+    if (!running_.exchange(false)) {
+      return;
+    }
+    loop_.remove(connection_);
+  }
+
+ private:
+  FeedReactor::Loop& loop_;
+  FeedConnection connection_;
+  std::atomic<bool> running_{false};
+};
+
+}  // namespace
+
+FeedReactor::FeedReactor(std::size_t threads) {
+  loops_.reserve(std::max<std::size_t>(threads, 1));
+  for (std::size_t i = 0; i < std::max<std::size_t>(threads, 1); ++i) {
+    loops_.push_back(std::make_unique<Loop>());
+  }
+}
+
+FeedReactor::~FeedReactor() = default;
+
+std::unique_ptr<ExchangeFeed> FeedReactor::makeFeed(FeedOptions options, ExchangeFeed::Callback callback) {
+  auto& loop = *loops_[next_loop_.fetch_add(1) % loops_.size()];
+  return std::make_unique<ReactorFeed>(loop, std::move(options), std::move(callback));
+}
+
+}  // namespace hermeneutic::cex_type1
@@ -0,0 +1,119 @@
+#include "hermeneutic/cex_type1/frame_assembler.hpp"
+
+#include <bit>
+#include <cstring>
+
+#include "hermeneutic/cex_type1/feed_parser.hpp"
+#include "hermeneutic/common/assert.hpp"
+
+namespace hermeneutic::cex_type1 {
+
+FrameAssembler::FrameAssembler(std::size_t max_message_size, std::size_t initial_capacity)
+    : buffer_(std::bit_ceil(initial_capacity + FeedParser::kPadding)), max_message_size_(max_message_size) {
+  buffer_.resize(0);
+}
+
+Poco::Buffer<char>& FrameAssembler::prepare(std::size_t frame_length) {
+  if (!in_message_ || dropping_) {
+    buffer_.resize(0);
+  }
+  message_size_ = 0;
+  control_size_ = 0;
+  // Poco grows the buffer to the exact frame size; doubling ahead of a
+  // fragmented message keeps the number of reallocations logarithmic.
+  if (buffer_.capacity() < 2 * buffer_.size()) {
+    reserve(2 * buffer_.size());
+  }
+  if (frame_length != 0) {
+    reserve(buffer_.size() + frame_length + FeedParser::kPadding);
+  }
+  return buffer_;
+}
+
+void FrameAssembler::reset() {
+  buffer_.resize(0);
+  message_size_ = 0;
+  control_size_ = 0;
+  in_message_ = false;
+  dropping_ = false;
+}
+
+FrameAssembler::Frame FrameAssembler::onFrame(std::uint8_t opcode, bool fin, std::size_t length) {
+  HERMENEUTIC_ASSERT_DEBUG(length <= buffer_.size(), "frame longer than the assembled buffer");
+  const auto begin = buffer_.size() - length;
+
+  if ((opcode & 0x8) != 0) {
+    // Control frames may be interleaved with fragments; they are never part
+    // of the message, so cut them off again (the bytes stay readable).
+    control_offset_ = begin;
+    control_size_ = length;
+    buffer_.resize(begin);
+    switch (opcode) {
+      case kClose:
+        return Frame::Close;
+      case kPing:
+        return Frame::Ping;
+      default:
+        return Frame::Skipped;
+    }
+  }
+
+  if (opcode == kText || opcode == kBinary) {
+    if (begin != 0) {
+      // A new message abandons an unfinished one.
+      std::memmove(buffer_.begin(), buffer_.begin() + begin, length);
+      buffer_.resize(length);
+    }
+    in_message_ = true;
+    dropping_ = opcode == kBinary;
+  } else if (opcode != kContinuation || !in_message_) {
+    buffer_.resize(begin);
+    return Frame::Skipped;
+  }
+
+  auto result = Frame::Partial;
+  if (dropping_) {
+    buffer_.resize(0);
+    result = Frame::Skipped;
+  } else if (buffer_.size() > max_message_size_) {
+    buffer_.resize(0);
+    dropping_ = true;
+    result = Frame::Oversized;
+  }
+  if (!fin) {
+    return result;
+  }
+
+  in_message_ = false;
+  if (dropping_) {
+    dropping_ = false;
+    return result;
+  }
+  message_size_ = buffer_.size();
+  reserve(message_size_ + FeedParser::kPadding);
+  return Frame::Message;
+}
+
+FrameAssembler::Frame FrameAssembler::onDiscardedFrame(std::uint8_t opcode, bool fin) {
+  bool report = false;
+  if (opcode == kText || opcode == kBinary) {
+    report = opcode == kText;
+  } else if (opcode == kContinuation && in_message_) {
+    // Reported once per message, like an oversized fragmented one.
+    report = !dropping_;
+  } else {
+    return Frame::Skipped;
+  }
+  buffer_.resize(0);
+  in_message_ = !fin;
+  dropping_ = !fin;
+  return report ? Frame::Oversized : Frame::Skipped;
+}
+
+void FrameAssembler::reserve(std::size_t bytes) {
+  if (buffer_.capacity() < bytes) {
+    buffer_.setCapacity(std::bit_ceil(bytes));
+  }
+}
+
+}  // namespace hermeneutic::cex_type1
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <string>
@@ -11,14 +12,20 @@ namespace hermeneutic::cex_type1 {
 
 struct FeedOptions {
   std::string exchange;
+  // Instrument the feed's events are stamped with; empty is the default.
+  std::string symbol;
   std::string url;
   std::string auth_token;
   std::chrono::milliseconds interval{0};
+  // Larger (reassembled) messages are dropped with a warning.
+  std::size_t max_message_bytes{64 * 1024 * 1024};
 };
 
 class ExchangeFeed {
  public:
-  using Callback = std::function<void(common::BookEvent)>;
+  // The event is the feed's own and is reused for the next message, so its
+  // buffers keep their capacity; copy whatever must outlive the call.
+  using Callback = std::function<void(const common::BookEvent&)>;
   virtual ~ExchangeFeed() = default;
 
   virtual void start() = 0;
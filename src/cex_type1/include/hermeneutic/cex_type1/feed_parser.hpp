@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <simdjson.h>
+
+#include "hermeneutic/common/events.hpp"
+
+namespace hermeneutic::cex_type1 {
+
+// Turns cex_type1 JSON messages into BookEvents with simdjson On-Demand.
+// Fields are read in a single forward pass, decimals are parsed straight
+// from the document's string views, and the target event is reused, so
+// new/cancel messages parse without touching the heap once warmed up.
+class FeedParser {
+ public:
+  // Bytes a receive buffer must reserve past the payload for parse().
+  static constexpr std::size_t kPadding = simdjson::SIMDJSON_PADDING;
+
+  explicit FeedParser(std::string exchange = {}, std::string_view symbol = {});
+
+  // `data` must stay readable for `length + kPadding` bytes (e.g. a receive
+  // buffer sized frame + kPadding). Returns false for messages that carry no
+  // book event (unknown type, missing id/side); throws on malformed payloads.
+  // `local_timestamp_ns` stamps the event and stands in for a missing feed
+  // timestamp.
+  bool parse(const char* data, std::size_t length, std::int64_t local_timestamp_ns,
+             common::BookEvent& event);
+  // Convenience overload that first copies `payload` into a padded buffer.
+  bool parse(std::string_view payload, std::int64_t local_timestamp_ns, common::BookEvent& event);
+
+ private:
+  std::string exchange_;
+  // Interned once here so events carry only the ids.
+  common::ExchangeId exchange_id_;
+  common::SymbolId symbol_id_;
+  simdjson::ondemand::parser parser_;
+  std::string scratch_;
+};
+
+}  // namespace hermeneutic::cex_type1
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "hermeneutic/cex_type1/feed.hpp"
+
+namespace hermeneutic::cex_type1 {
+
+// Drives many WebSocket feeds from a few epoll event-loop threads instead of
+// one blocking thread per feed. Sockets are non-blocking: connect, the HTTP
+// upgrade, ping/pong, idle timeouts and reconnects all run inside the loop.
+// Feeds are spread round-robin over the loops and their callbacks are
+// invoked on the owning loop thread, one event at a time per feed. Feeds
+// keep the FeedOptions semantics of makeWebSocketFeed (ws:// URLs only;
+// `interval` is the reconnect delay). The reactor must outlive its feeds,
+// and a callback must not destroy its own feed (stop() is fine).
+class FeedReactor {
+ public:
+  explicit FeedReactor(std::size_t threads = 1);
+  ~FeedReactor();
+
+  FeedReactor(const FeedReactor&) = delete;
+  FeedReactor& operator=(const FeedReactor&) = delete;
+
+  std::unique_ptr<ExchangeFeed> makeFeed(FeedOptions options, ExchangeFeed::Callback callback);
+
+  std::size_t threads() const { return loops_.size(); }
+
+  class Loop;
+
+ private:
+  std::vector<std::unique_ptr<Loop>> loops_;
+  std::atomic<std::size_t> next_loop_{0};
+};
+
+}  // namespace hermeneutic::cex_type1
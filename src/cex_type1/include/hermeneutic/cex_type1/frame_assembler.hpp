@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include <Poco/Buffer.h>
+
+namespace hermeneutic::cex_type1 {
+
+// Reassembles WebSocket data messages that arrive split over continuation
+// frames. Frames are received straight into prepare() (Poco's
+// WebSocket::receiveFrame(Poco::Buffer<char>&, int&) appends to it) and then
+// classified with onFrame(). The buffer is reused across messages and grows
+// geometrically, so once it has held the deepest snapshot it is not
+// reallocated again; a completed text message always has
+// FeedParser::kPadding readable bytes behind it.
+class FrameAssembler {
+ public:
+  // RFC 6455 opcodes; Poco's FRAME_OP_* flags use the same values.
+  enum Opcode : std::uint8_t {
+    kContinuation = 0x0,
+    kText = 0x1,
+    kBinary = 0x2,
+    kClose = 0x8,
+    kPing = 0x9,
+    kPong = 0xA,
+  };
+
+  enum class Frame {
+    Partial,    // fragment buffered, message not finished yet
+    Message,    // message() holds a complete text message
+    Ping,       // control() holds the payload to echo in a pong
+    Close,      // peer sent a close frame
+    Skipped,    // binary/pong/stray continuation frame
+    Oversized,  // message exceeded the limit and is dropped up to its FIN
+  };
+
+  static constexpr std::size_t kDefaultInitialCapacity = 64 * 1024;
+  static constexpr std::size_t kDefaultMaxMessageSize = 64 * 1024 * 1024;
+
+  explicit FrameAssembler(std::size_t max_message_size = kDefaultMaxMessageSize,
+                          std::size_t initial_capacity = kDefaultInitialCapacity);
+
+  // Buffer the next frame must be appended to. Releases the previous
+  // message and makes room for the one being assembled; callers that
+  // already know the frame's length pass it to reserve room up front.
+  Poco::Buffer<char>& prepare(std::size_t frame_length = 0);
+  // Classifies the `length`-byte frame just appended to prepare().
+  Frame onFrame(std::uint8_t opcode, bool fin, std::size_t length);
+  // Classifies a frame whose payload the caller discarded unread because it
+  // alone exceeds the limit; its message is dropped up to its FIN.
+  Frame onDiscardedFrame(std::uint8_t opcode, bool fin);
+  // Forgets any unfinished message (e.g. after a reconnect).
+  void reset();
+
+  // Valid after onFrame() returned Message, until the next prepare().
+  std::string_view message() const { return {buffer_.begin(), message_size_}; }
+  // Valid after onFrame() returned Ping or Close, until the next prepare().
+  std::string_view control() const { return {buffer_.begin() + control_offset_, control_size_}; }
+
+  std::size_t capacity() const { return buffer_.capacity(); }
+  std::size_t maxMessageSize() const { return max_message_size_; }
+
+ private:
+  void reserve(std::size_t bytes);
+
+  Poco::Buffer<char> buffer_;
+  std::size_t max_message_size_;
+  std::size_t message_size_{0};
+  std::size_t control_offset_{0};
+  std::size_t control_size_{0};
+  bool in_message_{false};
+  // Remaining fragments of the current message are discarded (binary or oversized).
+  bool dropping_{false};
+};
+
+}  // namespace hermeneutic::cex_type1
@@ -0,0 +1,49 @@
+#include "hermeneutic/common/exchange_registry.hpp"
+
+#include <stdexcept>
+
+#include "hermeneutic/common/assert.hpp"
+
+namespace hermeneutic::common {
+
+ExchangeRegistry& ExchangeRegistry::instance() {
+  static ExchangeRegistry registry;
+  return registry;
+}
+
+ExchangeId ExchangeRegistry::intern(std::string_view name) {
+  HERMENEUTIC_ASSERT_DEBUG(!name.empty(), "exchange names must be non-empty");
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (auto it = ids_.find(name); it != ids_.end()) {
+    return it->second;
+  }
+  if (names_.size() >= kUnknownExchange) {
+    throw std::length_error("too many exchanges registered");
+  }
+  const auto id = static_cast<ExchangeId>(names_.size());
+  // Deque elements never move, so the key view stays valid.
+  const auto& stored = names_.emplace_back(name);
+  ids_.emplace(stored, id);
+  return id;
+}
+
+std::optional<ExchangeId> ExchangeRegistry::find(std::string_view name) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (auto it = ids_.find(name); it != ids_.end()) {
+    return it->second;
+  }
+  return std::nullopt;
+}
+
+const std::string& ExchangeRegistry::name(ExchangeId id) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  HERMENEUTIC_ASSERT_DEBUG(id < names_.size(), "unknown exchange id");
+  return names_.at(id);
+}
+
+std::size_t ExchangeRegistry::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return names_.size();
+}
+
+}  // namespace hermeneutic::common
@@ -20,12 +20,23 @@ enum class DecimalImplementation { Int128, Double, Wide };
 
 namespace detail {
 
+template <typename Storage>
+constexpr int scaleDigits(Storage scale) {
+  int digits = 0;
+  for (; scale > 1; scale /= 10) {
+    ++digits;
+  }
+  return digits;
+}
+
 template <typename Derived, typename Ops>
 class ScaledDecimalBase {
  public:
   using Storage = typename Ops::Storage;
   using WideType = typename Ops::WideType;
   static constexpr Storage kScale = Ops::scale;
+  // Decimal places kScale provides; toScaled()/fromScaled() accept up to this.
+  static constexpr int kScaleDigits = scaleDigits(kScale);
   // 10^18 fits within 60 bits (2^60 ≈ 1.15e18), so storing scaled values in
   // signed 128-bit integers leaves ample headroom.
 
@@ -77,14 +88,14 @@ class ScaledDecimalBase {
       ++index;
       while (index < text.size() &&
              std::isdigit(static_cast<unsigned char>(text[index]))) {
-        if (fractional_digits < 18) {
+        if (fractional_digits < kScaleDigits) {
           fractional = fractional * 10 +
                        static_cast<Storage>(text[index] - '0');
           ++fractional_digits;
         }
         ++index;
       }
-      while (fractional_digits < 18) {
+      while (fractional_digits < kScaleDigits) {
         fractional *= 10;
         ++fractional_digits;
       }
@@ -105,7 +116,7 @@ class ScaledDecimalBase {
   }
 
   std::string toString(int precision = 6) const {
-    precision = std::clamp(precision, 0, 18);
+    precision = std::clamp(precision, 0, kScaleDigits);
     if (value_ == 0) {
       if (precision == 0) {
         return "0";
@@ -121,13 +132,13 @@ class ScaledDecimalBase {
     if (precision == 0) {
       return negative ? "-" + integral_str : integral_str;
     }
-    std::string fractional_str(18, '0');
-    for (int i = 17; i >= 0; --i) {
+    std::string fractional_str(static_cast<std::size_t>(kScaleDigits), '0');
+    for (int i = kScaleDigits - 1; i >= 0; --i) {
       fractional_str[static_cast<std::size_t>(i)] =
           static_cast<char>('0' + static_cast<int>(fractional % 10));
       fractional /= 10;
     }
-    if (precision < 18) {
+    if (precision < kScaleDigits) {
       fractional_str.resize(static_cast<std::size_t>(precision));
     }
     std::string result = integral_str;
@@ -139,6 +150,25 @@ class ScaledDecimalBase {
     return result;
   }
 
+  // Integer count of 10^-digits units, truncated toward zero like
+  // toString(digits). Throws std::invalid_argument for digits outside
+  // [0, kScaleDigits] and std::overflow_error when the count does not fit
+  // in 64 bits.
+  std::int64_t toScaled(int digits) const {
+    const Storage scaled = value_ / unitOf(digits);
+    if (scaled > std::numeric_limits<std::int64_t>::max() ||
+        scaled < std::numeric_limits<std::int64_t>::min()) {
+      throw std::overflow_error("decimal does not fit 64 bits at " +
+                                std::to_string(digits) + " digits");
+    }
+    return static_cast<std::int64_t>(scaled);
+  }
+
+  // Every 64-bit count fits: |scaled| * 10^18 stays below 2^127.
+  static Derived fromScaled(std::int64_t scaled, int digits) {
+    return fromRaw(static_cast<Storage>(scaled) * unitOf(digits));
+  }
+
   Storage raw() const { return value_; }
 
   Derived &operator+=(Derived rhs) {
@@ -223,6 +253,24 @@ class ScaledDecimalBase {
     return fromWideMagnitude(quotient, negative);
   }
 
+  // Raw units per 10^-digits.
+  static Storage unitOf(int digits) {
+    if (digits < 0 || digits > kScaleDigits) {
+      throw std::invalid_argument("decimal digits " + std::to_string(digits) +
+                                  " outside [0, " +
+                                  std::to_string(kScaleDigits) + "]");
+    }
+    return kScale / powerOfTen(digits);
+  }
+
+  static constexpr Storage powerOfTen(int exponent) {
+    Storage result = 1;
+    for (int i = 0; i < exponent; ++i) {
+      result *= 10;
+    }
+    return result;
+  }
+
   static WideType magnitudeToWide(Storage value) {
     Storage magnitude = value < 0 ? -value : value;
     return Ops::from_storage(magnitude);
@@ -279,6 +327,8 @@ template <typename Derived>
 class DoubleDecimalBase {
  public:
   using Storage = double;
+  // Matches the integer backends' 10^-18 resolution.
+  static constexpr int kScaleDigits = 18;
 
   constexpr DoubleDecimalBase() = default;
 
@@ -315,7 +365,7 @@ class DoubleDecimalBase {
   double toDouble() const { return value_; }
 
   std::string toString(int precision = 6) const {
-    precision = std::clamp(precision, 0, 18);
+    precision = std::clamp(precision, 0, kScaleDigits);
     std::ostringstream oss;
     oss.setf(std::ios::fixed, std::ios::floatfield);
     oss.precision(precision);
@@ -323,6 +373,26 @@ class DoubleDecimalBase {
     return oss.str();
   }
 
+  // Same contract as the integer backends: truncated toward zero, with the
+  // same exceptions. A product within rounding noise of an integer counts
+  // as that integer, so 0.29 at two digits is 29 rather than 28.
+  std::int64_t toScaled(int digits) const {
+    const double product = value_ * unitsPerOne(digits);
+    const double nearest = std::nearbyint(product);
+    const double scaled =
+        std::abs(product - nearest) <= std::abs(product) * kRoundingNoise ? nearest : std::trunc(product);
+    // 2^63 is exact in a double; NaN fails both comparisons.
+    if (!(scaled < 9223372036854775808.0 && scaled >= -9223372036854775808.0)) {
+      throw std::overflow_error("decimal does not fit 64 bits at " +
+                                std::to_string(digits) + " digits");
+    }
+    return static_cast<std::int64_t>(scaled);
+  }
+
+  static Derived fromScaled(std::int64_t scaled, int digits) {
+    return fromRaw(static_cast<double>(scaled) / unitsPerOne(digits));
+  }
+
   double raw() const { return value_; }
 
   Derived &operator+=(Derived rhs) {
@@ -385,6 +455,18 @@ class DoubleDecimalBase {
   double value_{0.0};
 
  private:
+  // Relative error of about four ulps: below what a double can represent.
+  static constexpr double kRoundingNoise = 1e-15;
+
+  static double unitsPerOne(int digits) {
+    if (digits < 0 || digits > kScaleDigits) {
+      throw std::invalid_argument("decimal digits " + std::to_string(digits) +
+                                  " outside [0, " +
+                                  std::to_string(kScaleDigits) + "]");
+    }
+    return std::pow(10.0, digits);
+  }
+
   Derived &self() { return static_cast<Derived &>(*this); }
   const Derived &self() const { return static_cast<const Derived &>(*this); }
 };
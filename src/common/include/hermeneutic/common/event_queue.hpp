@@ -0,0 +1,98 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <utility>
+
+#include "hermeneutic/common/concurrent_queue.hpp"
+#include "hermeneutic/common/lockfree_queue.hpp"
+
+namespace hermeneutic::common {
+
+enum class QueueKind { Mutex, LockFree };
+
+// The build-time default comes from HERMENEUTIC_DEFAULT_QUEUE (CMake); a
+// caller can still override it per queue at run time.
+struct QueueOptions {
+#if HERMENEUTIC_DEFAULT_QUEUE_LOCKFREE
+  QueueKind kind{QueueKind::LockFree};
+#else
+  QueueKind kind{QueueKind::Mutex};
+#endif
+  WaitStrategy wait{WaitStrategy::Hybrid};
+  // Only meaningful for the lock-free ring; rounded up to a power of two.
+  std::size_t capacity{LockFreeQueue<int>::kDefaultCapacity};
+};
+
+inline bool parseQueueKind(std::string_view text, QueueKind& kind) {
+  if (text == "mutex") {
+    kind = QueueKind::Mutex;
+  } else if (text == "lockfree") {
+    kind = QueueKind::LockFree;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+inline bool parseWaitStrategy(std::string_view text, WaitStrategy& wait) {
+  if (text == "blocking") {
+    wait = WaitStrategy::Blocking;
+  } else if (text == "spinning") {
+    wait = WaitStrategy::Spinning;
+  } else if (text == "hybrid") {
+    wait = WaitStrategy::Hybrid;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Runtime-selected front for ConcurrentQueue / LockFreeQueue. Exactly one of
+// the two backends is allocated; the branch per call is perfectly predicted.
+template <typename T>
+class EventQueue {
+ public:
+  explicit EventQueue(QueueOptions options = {}) {
+    if (options.kind == QueueKind::LockFree) {
+      lockfree_ = std::make_unique<LockFreeQueue<T>>(options.capacity, options.wait);
+    } else {
+      mutex_ = std::make_unique<ConcurrentQueue<T>>();
+    }
+  }
+
+  QueueKind kind() const { return lockfree_ ? QueueKind::LockFree : QueueKind::Mutex; }
+
+  void push(T value) {
+    if (lockfree_) {
+      lockfree_->push(std::move(value));
+    } else {
+      mutex_->push(std::move(value));
+    }
+  }
+
+  bool try_pop(T& value) { return lockfree_ ? lockfree_->try_pop(value) : mutex_->try_pop(value); }
+
+  bool wait_pop(T& value) { return lockfree_ ? lockfree_->wait_pop(value) : mutex_->wait_pop(value); }
+
+  template <typename Rep, typename Period>
+  bool wait_pop_for(T& value, const std::chrono::duration<Rep, Period>& timeout) {
+    return lockfree_ ? lockfree_->wait_pop_for(value, timeout) : mutex_->wait_pop_for(value, timeout);
+  }
+
+  void close() {
+    if (lockfree_) {
+      lockfree_->close();
+    } else {
+      mutex_->close();
+    }
+  }
+
+ private:
+  std::unique_ptr<ConcurrentQueue<T>> mutex_;
+  std::unique_ptr<LockFreeQueue<T>> lockfree_;
+};
+
+}  // namespace hermeneutic::common
@@ -9,6 +9,8 @@
 
 #include "hermeneutic/common/decimal.hpp"
 #include "hermeneutic/common/enum.hpp"
+#include "hermeneutic/common/exchange_registry.hpp"
+#include "hermeneutic/common/symbol_registry.hpp"
 
 // TODO style: too much code/lines?
 namespace hermeneutic::common {
@@ -62,7 +64,15 @@ struct MarketOrder {
 
 // TODO: style ... 
 struct BookEvent {
+  // Feeds only set exchange_id; hand-built events may give just the name,
+  // which AggregationEngine::push interns.
   std::string exchange;
+  ExchangeId exchange_id{kUnknownExchange};
+  // Instrument the event belongs to; empty selects the aggregator's
+  // default. Like the exchange, feeds only set symbol_id and hand-built
+  // events may give just the name.
+  std::string symbol;
+  SymbolId symbol_id{kUnknownSymbol};
   BookEventKind kind{BookEventKind::NewOrder};
   std::uint64_t sequence{0};
   MarketOrder order;
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace hermeneutic::common {
+
+// Dense per-process exchange number; books, readiness flags and similar
+// per-exchange state can live in vectors indexed by it.
+using ExchangeId = std::uint16_t;
+inline constexpr ExchangeId kUnknownExchange = std::numeric_limits<ExchangeId>::max();
+
+// Process-wide name <-> ExchangeId table. Names are interned when feeds and
+// config are set up, so the per-event path only carries the integer. IDs
+// are handed out from 0 in first-seen order and never reused.
+class ExchangeRegistry {
+ public:
+  static ExchangeRegistry& instance();
+
+  ExchangeId intern(std::string_view name);
+  std::optional<ExchangeId> find(std::string_view name) const;
+  // Stable for the life of the process.
+  const std::string& name(ExchangeId id) const;
+  std::size_t size() const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::deque<std::string> names_;
+  std::unordered_map<std::string_view, ExchangeId> ids_;
+};
+
+}  // namespace hermeneutic::common
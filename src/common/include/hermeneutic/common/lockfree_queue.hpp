@@ -0,0 +1,380 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace hermeneutic::common {
+
+// How a consumer (or a producer facing a full ring) waits for progress.
+//  - Blocking tries the ring once and parks on a condition variable only
+//    when it is empty (or full); the other side wakes it once the ring has
+//    an index for it.
+//  - Spinning busy-waits, yielding the core now and then; lowest latency but
+//    burns a CPU per waiting thread.
+//  - Hybrid spins for a bounded number of iterations, then parks.
+enum class WaitStrategy { Blocking, Spinning, Hybrid };
+
+namespace detail {
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield" ::: "memory");
+#else
+  std::this_thread::yield();
+#endif
+}
+
+// C++ transcription of the SCQ ring from
+// lockfree-waitfree/lfqueue-*/lfring_cas1.h (Nikolaev, DISC'19). The vendored
+// header is written against C11 <stdatomic.h>, which C++20 cannot include, so
+// the algorithm is kept line-for-line but expressed with std::atomic. The ring
+// carries indices in [0, 2^order); callers must never hold more than 2^order
+// indices in flight, which is what makes enqueue infallible.
+class ScqRing {
+ public:
+  static constexpr std::size_t kEmpty = ~static_cast<std::size_t>(0);
+
+  ScqRing(std::size_t order, bool full)
+      : order_(order),
+        half_(std::size_t{1} << order),
+        n_(half_ * 2),
+        array_(std::make_unique<std::atomic<std::uint64_t>[]>(n_)) {
+    for (std::size_t i = 0; i != n_; ++i) {
+      array_[i].store(~std::uint64_t{0}, std::memory_order_relaxed);
+    }
+    if (full) {
+      for (std::size_t i = 0; i != half_; ++i) {
+        array_[map(i)].store(n_ + rawMap(i, order_, half_), std::memory_order_relaxed);
+      }
+      threshold_.store(threshold3(), std::memory_order_relaxed);
+      tail_.store(half_, std::memory_order_relaxed);
+    }
+  }
+
+  void enqueue(std::size_t index) {
+    const std::uint64_t eidx = index ^ (n_ - 1);
+    for (;;) {
+      const auto tail = tail_.fetch_add(1, std::memory_order_acq_rel);
+      const auto tcycle = (tail << 1) | (2 * n_ - 1);
+      auto& slot = array_[map(tail)];
+      auto entry = slot.load(std::memory_order_acquire);
+      for (;;) {
+        const auto ecycle = entry | (2 * n_ - 1);
+        const bool usable =
+            cmpLess(ecycle, tcycle) &&
+            (entry == ecycle ||
+             (entry == (ecycle ^ n_) && cmpLessEqual(head_.load(std::memory_order_acquire), tail)));
+        if (!usable) {
+          break;
+        }
+        if (!slot.compare_exchange_weak(entry, tcycle ^ eidx, std::memory_order_acq_rel,
+                                        std::memory_order_acquire)) {
+          continue;
+        }
+        if (threshold_.load() != threshold3()) {
+          threshold_.store(threshold3());
+        }
+        return;
+      }
+    }
+  }
+
+  std::size_t dequeue() {
+    if (threshold_.load() < 0) {
+      return kEmpty;
+    }
+    for (;;) {
+      const auto head = head_.fetch_add(1, std::memory_order_acq_rel);
+      const auto hcycle = (head << 1) | (2 * n_ - 1);
+      auto& slot = array_[map(head)];
+      std::size_t attempt = 0;
+    again:
+      auto entry = slot.load(std::memory_order_acquire);
+      std::uint64_t ecycle = 0;
+      do {
+        ecycle = entry | (2 * n_ - 1);
+        if (ecycle == hcycle) {
+          slot.fetch_or(n_ - 1, std::memory_order_acq_rel);
+          return static_cast<std::size_t>(entry & (n_ - 1));
+        }
+        std::uint64_t entry_new = 0;
+        if ((entry | n_) != ecycle) {
+          entry_new = entry & ~static_cast<std::uint64_t>(n_);
+          if (entry == entry_new) {
+            break;
+          }
+        } else {
+          if (++attempt <= 10000) {
+            goto again;
+          }
+          entry_new = hcycle ^ ((~entry) & n_);
+        }
+        if (!cmpLess(ecycle, hcycle) ||
+            slot.compare_exchange_weak(entry, entry_new, std::memory_order_acq_rel,
+                                       std::memory_order_acquire)) {
+          break;
+        }
+      } while (true);
+
+      const auto tail = tail_.load(std::memory_order_acquire);
+      if (cmpLessEqual(tail, head + 1)) {
+        catchup(tail, head + 1);
+        threshold_.fetch_sub(1, std::memory_order_acq_rel);
+        return kEmpty;
+      }
+      if (threshold_.fetch_sub(1, std::memory_order_acq_rel) <= 0) {
+        return kEmpty;
+      }
+    }
+  }
+
+  // Smallest order the index-spreading map supports (one cache line of slots).
+  static constexpr std::size_t kMinOrder = 4;
+
+ private:
+  static constexpr std::size_t kCacheShift = 7;
+  static constexpr std::size_t kRingMin = kCacheShift - 3;
+
+  static bool cmpLess(std::uint64_t x, std::uint64_t y) {
+    return static_cast<std::int64_t>(x - y) < 0;
+  }
+  static bool cmpLessEqual(std::uint64_t x, std::uint64_t y) {
+    return static_cast<std::int64_t>(x - y) <= 0;
+  }
+
+  static std::size_t rawMap(std::uint64_t idx, std::size_t order, std::size_t n) {
+    return static_cast<std::size_t>(((idx & (n - 1)) >> (order - kRingMin)) |
+                                    ((idx << kRingMin) & (n - 1)));
+  }
+
+  std::size_t map(std::uint64_t idx) const { return rawMap(idx, order_ + 1, n_); }
+
+  std::int64_t threshold3() const { return static_cast<std::int64_t>(half_ + n_ - 1); }
+
+  void catchup(std::uint64_t tail, std::uint64_t head) {
+    while (!tail_.compare_exchange_weak(tail, head, std::memory_order_acq_rel,
+                                        std::memory_order_acquire)) {
+      head = head_.load(std::memory_order_acquire);
+      tail = tail_.load(std::memory_order_acquire);
+      if (!cmpLess(tail, head)) {
+        break;
+      }
+    }
+  }
+
+  std::size_t order_;
+  std::size_t half_;
+  std::size_t n_;
+  alignas(128) std::atomic<std::uint64_t> head_{0};
+  alignas(128) std::atomic<std::int64_t> threshold_{-1};
+  alignas(128) std::atomic<std::uint64_t> tail_{0};
+  std::unique_ptr<std::atomic<std::uint64_t>[]> array_;
+};
+
+}  // namespace detail
+
+// Bounded MPMC queue built from two SCQ rings (the "SCQD" layout from the
+// vendored lfqueue README): one ring hands out free slot indices, the other
+// carries filled ones, and values live in a preallocated slot array. The
+// public surface mirrors ConcurrentQueue so the two are interchangeable.
+template <typename T>
+class LockFreeQueue {
+ public:
+  static constexpr std::size_t kDefaultCapacity = 1 << 16;
+
+  explicit LockFreeQueue(std::size_t capacity = kDefaultCapacity,
+                         WaitStrategy strategy = WaitStrategy::Hybrid)
+      : order_(orderFor(capacity)),
+        strategy_(strategy),
+        spin_limit_(strategy == WaitStrategy::Blocking ? 1 : kSpinIterations),
+        free_(order_, true),
+        filled_(order_, false),
+        slots_(std::make_unique<T[]>(std::size_t{1} << order_)) {}
+
+  LockFreeQueue(const LockFreeQueue&) = delete;
+  LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+  std::size_t capacity() const { return std::size_t{1} << order_; }
+
+  // Waits (per the wait strategy) while the queue is full; values pushed
+  // after close() are dropped, matching ConcurrentQueue.
+  void push(T value) {
+    std::size_t spins = 0;
+    while (strategy_ == WaitStrategy::Spinning || spins < spin_limit_) {
+      if (closed_.load(std::memory_order_acquire) || try_push(value)) {
+        return;
+      }
+      detail::cpuRelax();
+      if ((++spins & 63) == 0) {
+        std::this_thread::yield();
+      }
+    }
+    std::unique_lock<std::mutex> lock(space_mutex_);
+    full_sleepers_.fetch_add(1);
+    bool pushed = false;
+    space_cv_.wait(lock, [&] {
+      if (closed_.load(std::memory_order_acquire)) {
+        return true;
+      }
+      pushed = pushSlot(value);
+      return pushed;
+    });
+    full_sleepers_.fetch_sub(1);
+    lock.unlock();
+    if (pushed) {
+      wakeConsumer();
+    }
+  }
+
+  bool try_push(T& value) {
+    if (!pushSlot(value)) {
+      return false;
+    }
+    wakeConsumer();
+    return true;
+  }
+
+  bool try_pop(T& value) {
+    if (!popSlot(value)) {
+      return false;
+    }
+    wakeProducer();
+    return true;
+  }
+
+  bool wait_pop(T& value) {
+    return waitPopUntil(value, std::chrono::steady_clock::time_point::max());
+  }
+
+  template <typename Rep, typename Period>
+  bool wait_pop_for(T& value, const std::chrono::duration<Rep, Period>& timeout) {
+    return waitPopUntil(value, std::chrono::steady_clock::now() + timeout);
+  }
+
+  void close() {
+    closed_.store(true, std::memory_order_release);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      cond_var_.notify_all();
+    }
+    std::lock_guard<std::mutex> lock(space_mutex_);
+    space_cv_.notify_all();
+  }
+
+ private:
+  static constexpr std::size_t kSpinIterations = 4096;
+
+  static std::size_t orderFor(std::size_t capacity) {
+    std::size_t order = detail::ScqRing::kMinOrder;
+    while ((std::size_t{1} << order) < capacity) {
+      ++order;
+    }
+    return order;
+  }
+
+  // The ring operations without the wake-ups, for use under either mutex:
+  // waking the other side from there would take the two locks in both orders.
+  bool pushSlot(T& value) {
+    const auto index = free_.dequeue();
+    if (index == detail::ScqRing::kEmpty) {
+      return false;
+    }
+    slots_[index] = std::move(value);
+    filled_.enqueue(index);
+    return true;
+  }
+
+  bool popSlot(T& value) {
+    const auto index = filled_.dequeue();
+    if (index == detail::ScqRing::kEmpty) {
+      return false;
+    }
+    value = std::move(slots_[index]);
+    free_.enqueue(index);
+    return true;
+  }
+
+  // Pairs with the increment in waitPopUntil: either the sleeper sees the
+  // index on its re-check under the lock, or we see the sleeper here.
+  void wakeConsumer() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers_.load() > 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      cond_var_.notify_one();
+    }
+  }
+
+  // The same handshake with producers parked on a full ring in push().
+  void wakeProducer() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (full_sleepers_.load() > 0) {
+      std::lock_guard<std::mutex> lock(space_mutex_);
+      space_cv_.notify_one();
+    }
+  }
+
+  bool waitPopUntil(T& value, std::chrono::steady_clock::time_point deadline) {
+    std::size_t spins = 0;
+    while (strategy_ == WaitStrategy::Spinning || spins < spin_limit_) {
+      if (try_pop(value)) {
+        return true;
+      }
+      if (closed_.load(std::memory_order_acquire)) {
+        return try_pop(value);
+      }
+      detail::cpuRelax();
+      if ((++spins & 63) == 0) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+          return false;
+        }
+        std::this_thread::yield();
+      }
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    sleepers_.fetch_add(1);
+    bool popped = false;
+    const auto ready = [&] {
+      popped = popSlot(value);
+      return popped || closed_.load(std::memory_order_acquire);
+    };
+    if (deadline == std::chrono::steady_clock::time_point::max()) {
+      cond_var_.wait(lock, ready);
+    } else {
+      cond_var_.wait_until(lock, deadline, ready);
+    }
+    sleepers_.fetch_sub(1);
+    lock.unlock();
+    if (popped) {
+      wakeProducer();
+    }
+    return popped;
+  }
+
+  const std::size_t order_;
+  const WaitStrategy strategy_;
+  // Ring attempts before parking; Blocking makes one so only a full or
+  // empty ring takes the lock.
+  const std::size_t spin_limit_;
+  detail::ScqRing free_;
+  detail::ScqRing filled_;
+  std::unique_ptr<T[]> slots_;
+  std::atomic<bool> closed_{false};
+  std::atomic<std::size_t> sleepers_{0};
+  std::mutex mutex_;
+  std::condition_variable cond_var_;
+  // Producers parked on a full ring wait here, apart from the consumers.
+  std::atomic<std::size_t> full_sleepers_{0};
+  std::mutex space_mutex_;
+  std::condition_variable space_cv_;
+};
+
+}  // namespace hermeneutic::common
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace hermeneutic::common {
+
+// Dense per-process instrument number, the symbol counterpart of
+// ExchangeId: shards and per-symbol books are picked by it without hashing
+// the name on every event.
+using SymbolId = std::uint16_t;
+inline constexpr SymbolId kUnknownSymbol = std::numeric_limits<SymbolId>::max();
+// The empty symbol, which selects an aggregator's default book.
+inline constexpr SymbolId kDefaultSymbol = 0;
+
+// Process-wide name <-> SymbolId table, filled as configs and feeds are set
+// up. IDs are handed out from 0 in first-seen order and never reused; the
+// empty name is always kDefaultSymbol.
+class SymbolRegistry {
+ public:
+  static SymbolRegistry& instance();
+
+  SymbolId intern(std::string_view name);
+  std::optional<SymbolId> find(std::string_view name) const;
+  // Stable for the life of the process.
+  const std::string& name(SymbolId id) const;
+  std::size_t size() const;
+
+ private:
+  SymbolRegistry();
+
+  mutable std::mutex mutex_;
+  std::deque<std::string> names_;
+  std::unordered_map<std::string_view, SymbolId> ids_;
+};
+
+}  // namespace hermeneutic::common
@@ -0,0 +1,52 @@
+#include "hermeneutic/common/symbol_registry.hpp"
+
+#include <stdexcept>
+
+#include "hermeneutic/common/assert.hpp"
+
+namespace hermeneutic::common {
+
+SymbolRegistry& SymbolRegistry::instance() {
+  static SymbolRegistry registry;
+  return registry;
+}
+
+SymbolRegistry::SymbolRegistry() {
+  intern({});
+}
+
+SymbolId SymbolRegistry::intern(std::string_view name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (auto it = ids_.find(name); it != ids_.end()) {
+    return it->second;
+  }
+  if (names_.size() >= kUnknownSymbol) {
+    throw std::length_error("too many symbols registered");
+  }
+  const auto id = static_cast<SymbolId>(names_.size());
+  // Deque elements never move, so the key view stays valid.
+  const auto& stored = names_.emplace_back(name);
+  ids_.emplace(stored, id);
+  return id;
+}
+
+std::optional<SymbolId> SymbolRegistry::find(std::string_view name) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (auto it = ids_.find(name); it != ids_.end()) {
+    return it->second;
+  }
+  return std::nullopt;
+}
+
+const std::string& SymbolRegistry::name(SymbolId id) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  HERMENEUTIC_ASSERT_DEBUG(id < names_.size(), "unknown symbol id");
+  return names_.at(id);
+}
+
+std::size_t SymbolRegistry::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return names_.size();
+}
+
+}  // namespace hermeneutic::common
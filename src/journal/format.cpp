@@ -0,0 +1,38 @@
+#include "hermeneutic/journal/format.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <system_error>
+
+namespace hermeneutic::journal {
+
+std::string segmentFileName(std::uint32_t index) {
+  char name[32];
+  std::snprintf(name, sizeof(name), "%s%08u%s", kSegmentPrefix, index, kSegmentSuffix);
+  return name;
+}
+
+std::vector<std::filesystem::path> listSegments(const std::filesystem::path& path) {
+  std::vector<std::filesystem::path> segments;
+  if (std::filesystem::is_regular_file(path)) {
+    segments.push_back(path);
+    return segments;
+  }
+  if (!std::filesystem::is_directory(path)) {
+    return segments;
+  }
+  const std::string_view prefix(kSegmentPrefix);
+  const std::string_view suffix(kSegmentSuffix);
+  for (const auto& entry : std::filesystem::directory_iterator(path)) {
+    const auto name = entry.path().filename().string();
+    if (entry.is_regular_file() && name.size() > prefix.size() + suffix.size() && name.starts_with(prefix) &&
+        name.ends_with(suffix)) {
+      segments.push_back(entry.path());
+    }
+  }
+  // Zero-padded indices sort in write order.
+  std::sort(segments.begin(), segments.end());
+  return segments;
+}
+
+}  // namespace hermeneutic::journal
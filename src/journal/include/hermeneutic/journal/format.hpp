@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "hermeneutic/common/decimal.hpp"
+
+namespace hermeneutic::journal {
+
+// On-disk layout of a binary event journal. A journal is a directory of
+// segment files written in host byte order. Each segment opens with a
+// SegmentHeader followed by fixed-size Records only, so a mapped segment
+// can be walked like an array. Segments are self-contained: the names an
+// event refers to are declared again in every segment that uses them.
+//
+// One BookEvent is one record, except snapshots, which are followed by
+// one Level record per bid and then per ask.
+
+inline constexpr std::array<char, 8> kMagic{'H', 'M', 'J', 'R', 'N', 'L', '\0', '\0'};
+inline constexpr std::uint16_t kFormatVersion = 1;
+inline constexpr const char* kSegmentPrefix = "events-";
+inline constexpr const char* kSegmentSuffix = ".journal";
+
+enum class RecordType : std::uint8_t {
+  // Declares `name` for an exchange or symbol id used by later records.
+  Exchange = 1,
+  Symbol = 2,
+  NewOrder = 3,
+  CancelOrder = 4,
+  Snapshot = 5,
+  Level = 6,
+};
+
+// Decimal::raw() bytes as stored by the writing build; readers refuse
+// journals from a different Decimal backend.
+using RawDecimal = std::array<unsigned char, 16>;
+
+inline RawDecimal encodeDecimal(const common::Decimal& value) {
+  static_assert(sizeof(value.raw()) <= sizeof(RawDecimal));
+  RawDecimal bytes{};
+  const auto raw = value.raw();
+  std::memcpy(bytes.data(), &raw, sizeof(raw));
+  return bytes;
+}
+
+inline common::Decimal decodeDecimal(const RawDecimal& bytes) {
+  decltype(common::Decimal{}.raw()) raw{};
+  std::memcpy(&raw, bytes.data(), sizeof(raw));
+  return common::Decimal::fromRaw(raw);
+}
+
+struct RecordHeader {
+  RecordType type;
+  // 0 = bid, 1 = ask for NewOrder and Level.
+  std::uint8_t side;
+  // The writing process's ExchangeId, declared by an Exchange record.
+  std::uint16_t exchange;
+  // The writing process's SymbolId, declared by a Symbol record.
+  std::uint16_t symbol;
+  // Name length for Exchange and Symbol records.
+  std::uint16_t length;
+};
+
+struct OrderBody {
+  std::uint64_t sequence;
+  std::uint64_t order_id;
+  std::int64_t feed_timestamp_ns;
+  std::int64_t local_timestamp_ns;
+  RawDecimal price;
+  RawDecimal quantity;
+};
+
+struct SnapshotBody {
+  std::uint64_t sequence;
+  std::uint32_t bid_levels;
+  std::uint32_t ask_levels;
+  std::int64_t feed_timestamp_ns;
+  std::int64_t local_timestamp_ns;
+};
+
+struct LevelBody {
+  RawDecimal price;
+  RawDecimal quantity;
+};
+
+// Longer exchange and symbol names are truncated.
+inline constexpr std::size_t kMaxNameLength = sizeof(OrderBody);
+
+struct Record {
+  RecordHeader header;
+  union {
+    OrderBody order;
+    SnapshotBody snapshot;
+    LevelBody level;
+    char name[kMaxNameLength];
+  };
+};
+
+struct SegmentHeader {
+  std::array<char, 8> magic;
+  std::uint16_t version;
+  std::uint16_t record_size;
+  std::uint8_t decimal_implementation;
+  std::uint8_t decimal_bytes;
+  std::uint16_t reserved0;
+  std::uint32_t segment_index;
+  std::uint32_t reserved1;
+  std::int64_t created_ns;
+  unsigned char reserved2[sizeof(Record) - 32];
+};
+
+static_assert(sizeof(Record) == 72, "journal records are 72 bytes");
+static_assert(sizeof(SegmentHeader) == sizeof(Record), "the segment header fills one record slot");
+static_assert(std::is_trivially_copyable_v<Record> && std::is_trivially_copyable_v<SegmentHeader>);
+
+// Segment file name for `index`, e.g. events-00000003.journal.
+std::string segmentFileName(std::uint32_t index);
+
+// Segments of the journal at `path` in write order. `path` may also name a
+// single segment file.
+std::vector<std::filesystem::path> listSegments(const std::filesystem::path& path);
+
+}  // namespace hermeneutic::journal
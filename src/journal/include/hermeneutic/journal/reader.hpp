@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "hermeneutic/common/events.hpp"
+#include "hermeneutic/journal/format.hpp"
+
+namespace hermeneutic::journal {
+
+// Replays a journal written by JournalWriter. Segments are mapped one at
+// a time and records are decoded straight from the mapping into the
+// caller's BookEvent, whose vectors and strings keep their capacity, so a
+// replay loop does no I/O calls or allocation per event once warmed up.
+// Exchange names are interned into this process's ExchangeRegistry.
+class JournalReader {
+ public:
+  // `path` is a journal directory or a single segment. Throws
+  // std::runtime_error when there are no segments, and when a segment
+  // comes from another format version or Decimal backend.
+  explicit JournalReader(const std::filesystem::path& path);
+  ~JournalReader();
+
+  JournalReader(const JournalReader&) = delete;
+  JournalReader& operator=(const JournalReader&) = delete;
+
+  // Decodes the next event; false once the journal is exhausted. A record
+  // cut short at the end of a segment (a writer that died mid-write) ends
+  // that segment.
+  bool next(common::BookEvent& event);
+
+  std::uint64_t eventsRead() const { return events_read_; }
+  const std::vector<std::filesystem::path>& segments() const { return segments_; }
+  // Symbols seen so far, in first-seen order.
+  const std::vector<std::string>& symbols() const { return seen_symbols_; }
+
+ private:
+  void openSegment(std::size_t index);
+  void closeSegment();
+  bool readRecord(Record& record);
+  void declare(const Record& record);
+
+  std::vector<std::filesystem::path> segments_;
+  std::size_t segment_{0};
+  const unsigned char* data_{nullptr};
+  std::size_t size_{0};
+  std::size_t offset_{0};
+  // Journal ids of the current segment to names and local ids.
+  std::vector<common::ExchangeId> exchanges_;
+  std::vector<common::SymbolId> symbols_;
+  std::vector<std::string> seen_symbols_;
+  std::uint64_t events_read_{0};
+};
+
+}  // namespace hermeneutic::journal
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hermeneutic/common/events.hpp"
+#include "hermeneutic/journal/format.hpp"
+
+namespace hermeneutic::journal {
+
+struct JournalOptions {
+  std::string directory;
+  // A new segment starts once the current one would grow past this; a
+  // snapshot is never split, so one can overshoot it.
+  std::uint64_t segment_bytes{256ULL << 20};
+  // The writer thread wakes early once this many bytes are pending.
+  std::size_t buffer_bytes{1 << 20};
+  // Otherwise it writes whatever is pending this often.
+  std::chrono::milliseconds flush_interval{200};
+  // Events that would grow the pending buffer past this while the disk
+  // lags are dropped and counted rather than buffered without bound.
+  std::size_t max_pending_bytes{64 << 20};
+};
+
+struct JournalStats {
+  std::uint64_t events{0};
+  std::uint64_t records{0};
+  std::uint64_t bytes{0};
+  std::uint32_t segments{0};
+  // Events refused because max_pending_bytes were already waiting.
+  std::uint64_t dropped{0};
+  // Set after an I/O error; later events are dropped.
+  bool failed{false};
+};
+
+// Appends normalised BookEvents to a segment-rotated binary journal (see
+// format.hpp). Safe to call from several feed threads; events from one
+// thread keep their order. append() only encodes into a pending buffer; a
+// dedicated thread swaps that buffer out, writes it and opens the next
+// segment file, so feeds never wait on the disk. A write error is logged
+// once and ends the journal instead of reaching the caller, so recording
+// never takes feeds down.
+class JournalWriter {
+ public:
+  // Creates the directory if needed and opens a segment numbered after any
+  // already in it. Throws std::system_error if that fails.
+  explicit JournalWriter(JournalOptions options);
+  // Writes everything appended so far before returning.
+  ~JournalWriter();
+
+  JournalWriter(const JournalWriter&) = delete;
+  JournalWriter& operator=(const JournalWriter&) = delete;
+
+  void append(const common::BookEvent& event);
+  // Blocks until every event appended before the call has been handed to
+  // the OS (or the journal has failed).
+  void flush();
+  JournalStats stats() const;
+
+ private:
+  // Where a rotated segment begins in the pending bytes.
+  struct SegmentStart {
+    std::size_t offset;
+    std::uint32_t index;
+  };
+
+  void startSegment();
+  void pushRecord(const Record& record);
+  // Names are only looked up the first time a segment declares an id.
+  void declareExchange(common::ExchangeId id);
+  void declareSymbol(common::SymbolId id);
+
+  // Writer thread only.
+  void writerLoop();
+  void writeChunk(const std::vector<unsigned char>& chunk, const std::vector<SegmentStart>& starts);
+  bool openFile(std::uint32_t index);
+  bool writeAll(const unsigned char* data, std::size_t size);
+  void fail(const char* what, int error);
+
+  JournalOptions options_;
+  mutable std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable flushed_;
+  bool stopping_{false};
+  // Bytes ever appended, ever written, and the mark flush() waits for.
+  std::uint64_t appended_{0};
+  std::uint64_t written_{0};
+  std::uint64_t flush_target_{0};
+  std::vector<unsigned char> pending_;
+  std::vector<SegmentStart> pending_starts_;
+  std::uint32_t next_segment_{0};
+  std::uint64_t segment_bytes_{0};
+  // Which exchange ids and symbols the current segment has declared.
+  std::vector<bool> exchanges_declared_;
+  std::vector<bool> symbols_declared_;
+  bool warned_full_{false};
+  JournalStats stats_;
+
+  int fd_{-1};
+  std::thread thread_;
+};
+
+}  // namespace hermeneutic::journal
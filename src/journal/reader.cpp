@@ -0,0 +1,208 @@
+#include "hermeneutic/journal/reader.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+#include <system_error>
+
+namespace hermeneutic::journal {
+
+using common::BookEvent;
+using common::BookEventKind;
+using common::DecimalImplementation;
+using common::Side;
+
+namespace {
+
+// The int128 and wide backends share the same 10^18-scaled storage.
+bool decimalCompatible(const SegmentHeader& header) {
+  const auto stored = static_cast<DecimalImplementation>(header.decimal_implementation);
+  const auto local = common::kDefaultDecimalImplementation;
+  return header.decimal_bytes == sizeof(common::Decimal{}.raw()) &&
+         (stored == DecimalImplementation::Double) == (local == DecimalImplementation::Double);
+}
+
+common::PriceLevel decodeLevel(const Record& record) {
+  return {decodeDecimal(record.level.price), decodeDecimal(record.level.quantity)};
+}
+
+}  // namespace
+
+JournalReader::JournalReader(const std::filesystem::path& path) : segments_(listSegments(path)) {
+  if (segments_.empty()) {
+    throw std::runtime_error("no journal segments at " + path.string());
+  }
+  openSegment(0);
+}
+
+JournalReader::~JournalReader() {
+  closeSegment();
+}
+
+bool JournalReader::next(BookEvent& event) {
+  Record record;
+  for (;;) {
+    if (!readRecord(record)) {
+      if (segment_ + 1 >= segments_.size()) {
+        return false;
+      }
+      openSegment(segment_ + 1);
+      continue;
+    }
+
+    switch (record.header.type) {
+      case RecordType::Exchange:
+      case RecordType::Symbol:
+        declare(record);
+        continue;
+      case RecordType::NewOrder:
+      case RecordType::CancelOrder:
+        event.kind = record.header.type == RecordType::NewOrder ? BookEventKind::NewOrder : BookEventKind::CancelOrder;
+        event.sequence = record.order.sequence;
+        event.order.order_id = record.order.order_id;
+        event.order.side = record.header.side != 0 ? Side::Ask : Side::Bid;
+        event.order.price = decodeDecimal(record.order.price);
+        event.order.quantity = decodeDecimal(record.order.quantity);
+        event.feed_timestamp_ns = record.order.feed_timestamp_ns;
+        event.local_timestamp_ns = record.order.local_timestamp_ns;
+        break;
+      case RecordType::Snapshot: {
+        const std::size_t levels = std::size_t{record.snapshot.bid_levels} + record.snapshot.ask_levels;
+        if (levels > (size_ - offset_) / sizeof(Record)) {
+          spdlog::warn("Journal snapshot cut short in {}", segments_[segment_].string());
+          offset_ = size_;
+          continue;
+        }
+        event.kind = BookEventKind::Snapshot;
+        event.sequence = record.snapshot.sequence;
+        event.feed_timestamp_ns = record.snapshot.feed_timestamp_ns;
+        event.local_timestamp_ns = record.snapshot.local_timestamp_ns;
+        event.snapshot.bids.clear();
+        event.snapshot.asks.clear();
+        const auto bid_levels = record.snapshot.bid_levels;
+        Record level;
+        for (std::size_t i = 0; i < levels; ++i) {
+          readRecord(level);
+          (i < bid_levels ? event.snapshot.bids : event.snapshot.asks).push_back(decodeLevel(level));
+        }
+        break;
+      }
+      default:
+        throw std::runtime_error("corrupt journal record in " + segments_[segment_].string());
+    }
+
+    const auto exchange = record.header.exchange;
+    if (exchange >= exchanges_.size() || exchanges_[exchange] == common::kUnknownExchange ||
+        record.header.symbol >= symbols_.size() || symbols_[record.header.symbol] == common::kUnknownSymbol) {
+      throw std::runtime_error("journal event refers to an undeclared exchange or symbol in " +
+                               segments_[segment_].string());
+    }
+    event.exchange.clear();
+    event.exchange_id = exchanges_[exchange];
+    event.symbol.clear();
+    event.symbol_id = symbols_[record.header.symbol];
+    event.timestamp = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::nanoseconds(event.local_timestamp_ns)));
+    ++events_read_;
+    return true;
+  }
+}
+
+void JournalReader::openSegment(std::size_t index) {
+  closeSegment();
+  segment_ = index;
+  exchanges_.clear();
+  symbols_.clear();
+  const auto& path = segments_[index];
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::system_error(errno, std::generic_category(), "cannot open journal segment " + path.string());
+  }
+  struct stat info {};
+  if (::fstat(fd, &info) != 0) {
+    const int error = errno;
+    ::close(fd);
+    throw std::system_error(error, std::generic_category(), "cannot stat journal segment " + path.string());
+  }
+  const auto size = static_cast<std::size_t>(info.st_size);
+  if (size < sizeof(SegmentHeader)) {
+    // A writer that never flushed its first records.
+    ::close(fd);
+    spdlog::warn("Skipping empty journal segment {}", path.string());
+    return;
+  }
+  void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  const int error = errno;
+  ::close(fd);
+  if (mapped == MAP_FAILED) {
+    throw std::system_error(error, std::generic_category(), "cannot map journal segment " + path.string());
+  }
+  ::madvise(mapped, size, MADV_SEQUENTIAL);
+  data_ = static_cast<const unsigned char*>(mapped);
+  size_ = size;
+
+  SegmentHeader header;
+  std::memcpy(&header, data_, sizeof(header));
+  if (header.magic != kMagic || header.version != kFormatVersion || header.record_size != sizeof(Record)) {
+    closeSegment();
+    throw std::runtime_error(path.string() + " is not a version " + std::to_string(kFormatVersion) +
+                             " event journal");
+  }
+  if (!decimalCompatible(header)) {
+    closeSegment();
+    throw std::runtime_error(path.string() + " was written by a build with a different Decimal backend");
+  }
+  offset_ = sizeof(header);
+  if ((size_ - offset_) % sizeof(Record) != 0) {
+    spdlog::warn("Journal segment {} ends in a partial record", path.string());
+  }
+}
+
+void JournalReader::closeSegment() {
+  if (data_ != nullptr) {
+    ::munmap(const_cast<unsigned char*>(data_), size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+  offset_ = 0;
+}
+
+bool JournalReader::readRecord(Record& record) {
+  if (data_ == nullptr || size_ - offset_ < sizeof(Record)) {
+    return false;
+  }
+  std::memcpy(&record, data_ + offset_, sizeof(Record));
+  offset_ += sizeof(Record);
+  return true;
+}
+
+void JournalReader::declare(const Record& record) {
+  const std::string name(record.name, std::min<std::size_t>(record.header.length, kMaxNameLength));
+  if (record.header.type == RecordType::Exchange) {
+    const auto id = record.header.exchange;
+    if (id >= exchanges_.size()) {
+      exchanges_.resize(id + 1u, common::kUnknownExchange);
+    }
+    exchanges_[id] = common::ExchangeRegistry::instance().intern(name);
+    return;
+  }
+  const auto id = record.header.symbol;
+  if (id >= symbols_.size()) {
+    symbols_.resize(id + 1u, common::kUnknownSymbol);
+  }
+  if (std::find(seen_symbols_.begin(), seen_symbols_.end(), name) == seen_symbols_.end()) {
+    seen_symbols_.push_back(name);
+  }
+  symbols_[id] = common::SymbolRegistry::instance().intern(name);
+}
+
+}  // namespace hermeneutic::journal
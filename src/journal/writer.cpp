@@ -0,0 +1,303 @@
+#include "hermeneutic/journal/writer.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <spdlog/spdlog.h>
+#include <system_error>
+
+namespace hermeneutic::journal {
+
+using common::BookEvent;
+using common::BookEventKind;
+using common::Side;
+
+namespace {
+
+std::int64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+Record nameRecord(RecordType type, std::uint16_t id, const std::string& name) {
+  Record record{};
+  record.header.type = type;
+  if (type == RecordType::Exchange) {
+    record.header.exchange = id;
+  } else {
+    record.header.symbol = id;
+  }
+  const auto length = std::min(name.size(), kMaxNameLength);
+  record.header.length = static_cast<std::uint16_t>(length);
+  std::memcpy(record.name, name.data(), length);
+  return record;
+}
+
+Record levelRecord(Side side, const common::PriceLevel& level) {
+  Record record{};
+  record.header.type = RecordType::Level;
+  record.header.side = side == Side::Ask ? 1 : 0;
+  record.level.price = encodeDecimal(level.price);
+  record.level.quantity = encodeDecimal(level.quantity);
+  return record;
+}
+
+}  // namespace
+
+JournalWriter::JournalWriter(JournalOptions options) : options_(std::move(options)) {
+  std::filesystem::create_directories(options_.directory);
+  const auto existing = listSegments(options_.directory);
+  if (!existing.empty()) {
+    const auto name = existing.back().filename().string();
+    next_segment_ = static_cast<std::uint32_t>(
+        std::strtoul(name.c_str() + std::strlen(kSegmentPrefix), nullptr, 10) + 1);
+  }
+  pending_.reserve(options_.buffer_bytes);
+  // The first segment is opened here so a bad directory fails loudly.
+  const auto path = std::filesystem::path(options_.directory) / segmentFileName(next_segment_);
+  if (!openFile(next_segment_)) {
+    throw std::system_error(errno, std::generic_category(), "cannot create journal segment " + path.string());
+  }
+  startSegment();
+  // Already open, so the writer thread has no file to switch to.
+  pending_starts_.clear();
+  thread_ = std::thread([this] { writerLoop(); });
+}
+
+JournalWriter::~JournalWriter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_one();
+  thread_.join();
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+}
+
+void JournalWriter::append(const BookEvent& event) {
+  const auto records =
+      event.kind == BookEventKind::Snapshot ? 1 + event.snapshot.bids.size() + event.snapshot.asks.size() : 1;
+  const auto bytes = records * sizeof(Record);
+  bool wake = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stats_.failed) {
+      return;
+    }
+    if (pending_.size() + bytes > options_.max_pending_bytes) {
+      ++stats_.dropped;
+      if (!warned_full_) {
+        warned_full_ = true;
+        spdlog::warn("Journal in {} is {} bytes behind; dropping events until it catches up", options_.directory,
+                     pending_.size());
+      }
+      return;
+    }
+    if (segment_bytes_ > sizeof(SegmentHeader) && segment_bytes_ + bytes > options_.segment_bytes) {
+      startSegment();
+    }
+
+    const auto exchange = event.exchange_id != common::kUnknownExchange
+                              ? event.exchange_id
+                              : common::ExchangeRegistry::instance().intern(event.exchange);
+    declareExchange(exchange);
+    const auto symbol = event.symbol_id != common::kUnknownSymbol
+                            ? event.symbol_id
+                            : common::SymbolRegistry::instance().intern(event.symbol);
+    declareSymbol(symbol);
+
+    Record record{};
+    record.header.exchange = exchange;
+    record.header.symbol = symbol;
+    if (event.kind == BookEventKind::Snapshot) {
+      record.header.type = RecordType::Snapshot;
+      record.snapshot.sequence = event.sequence;
+      record.snapshot.bid_levels = static_cast<std::uint32_t>(event.snapshot.bids.size());
+      record.snapshot.ask_levels = static_cast<std::uint32_t>(event.snapshot.asks.size());
+      record.snapshot.feed_timestamp_ns = event.feed_timestamp_ns;
+      record.snapshot.local_timestamp_ns = event.local_timestamp_ns;
+      pushRecord(record);
+      for (const auto& level : event.snapshot.bids) {
+        pushRecord(levelRecord(Side::Bid, level));
+      }
+      for (const auto& level : event.snapshot.asks) {
+        pushRecord(levelRecord(Side::Ask, level));
+      }
+    } else {
+      record.header.type = event.kind == BookEventKind::NewOrder ? RecordType::NewOrder : RecordType::CancelOrder;
+      record.header.side = event.order.side == Side::Ask ? 1 : 0;
+      record.order.sequence = event.sequence;
+      record.order.order_id = event.order.order_id;
+      record.order.feed_timestamp_ns = event.feed_timestamp_ns;
+      record.order.local_timestamp_ns = event.local_timestamp_ns;
+      record.order.price = encodeDecimal(event.order.price);
+      record.order.quantity = encodeDecimal(event.order.quantity);
+      pushRecord(record);
+    }
+    ++stats_.events;
+    wake = pending_.size() >= options_.buffer_bytes;
+  }
+  if (wake) {
+    wake_.notify_one();
+  }
+}
+
+void JournalWriter::flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const auto target = appended_;
+  flush_target_ = std::max(flush_target_, target);
+  wake_.notify_one();
+  flushed_.wait(lock, [&] { return written_ >= target || stats_.failed; });
+}
+
+JournalStats JournalWriter::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void JournalWriter::startSegment() {
+  pending_starts_.push_back({pending_.size(), next_segment_});
+  SegmentHeader header{};
+  header.magic = kMagic;
+  header.version = kFormatVersion;
+  header.record_size = sizeof(Record);
+  header.decimal_implementation = static_cast<std::uint8_t>(common::kDefaultDecimalImplementation);
+  header.decimal_bytes = sizeof(common::Decimal{}.raw());
+  header.segment_index = next_segment_;
+  header.created_ns = nowNs();
+  const auto* bytes = reinterpret_cast<const unsigned char*>(&header);
+  pending_.insert(pending_.end(), bytes, bytes + sizeof(header));
+  appended_ += sizeof(header);
+  segment_bytes_ = sizeof(header);
+  stats_.bytes += sizeof(header);
+  ++stats_.segments;
+  ++next_segment_;
+  std::fill(exchanges_declared_.begin(), exchanges_declared_.end(), false);
+  std::fill(symbols_declared_.begin(), symbols_declared_.end(), false);
+}
+
+void JournalWriter::pushRecord(const Record& record) {
+  const auto* bytes = reinterpret_cast<const unsigned char*>(&record);
+  pending_.insert(pending_.end(), bytes, bytes + sizeof(record));
+  appended_ += sizeof(record);
+  segment_bytes_ += sizeof(record);
+  stats_.bytes += sizeof(record);
+  ++stats_.records;
+}
+
+void JournalWriter::declareExchange(common::ExchangeId id) {
+  if (id >= exchanges_declared_.size()) {
+    exchanges_declared_.resize(id + 1u, false);
+  }
+  if (!exchanges_declared_[id]) {
+    exchanges_declared_[id] = true;
+    pushRecord(nameRecord(RecordType::Exchange, id, common::ExchangeRegistry::instance().name(id)));
+  }
+}
+
+void JournalWriter::declareSymbol(common::SymbolId id) {
+  if (id >= symbols_declared_.size()) {
+    symbols_declared_.resize(id + 1u, false);
+  }
+  if (!symbols_declared_[id]) {
+    symbols_declared_[id] = true;
+    pushRecord(nameRecord(RecordType::Symbol, id, common::SymbolRegistry::instance().name(id)));
+  }
+}
+
+void JournalWriter::writerLoop() {
+  // The spare buffer swaps with pending_, so both keep their capacity.
+  std::vector<unsigned char> chunk;
+  chunk.reserve(options_.buffer_bytes);
+  std::vector<SegmentStart> starts;
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    wake_.wait_for(lock, options_.flush_interval, [this] {
+      return stopping_ || written_ < flush_target_ || pending_.size() >= options_.buffer_bytes;
+    });
+    if (pending_.empty()) {
+      if (stopping_) {
+        break;
+      }
+      continue;
+    }
+    pending_.swap(chunk);
+    pending_starts_.swap(starts);
+    const auto target = appended_;
+    lock.unlock();
+    writeChunk(chunk, starts);
+    chunk.clear();
+    starts.clear();
+    lock.lock();
+    written_ = target;
+    warned_full_ = false;
+    flushed_.notify_all();
+  }
+}
+
+void JournalWriter::writeChunk(const std::vector<unsigned char>& chunk, const std::vector<SegmentStart>& starts) {
+  std::size_t offset = 0;
+  for (const auto& start : starts) {
+    if (!writeAll(chunk.data() + offset, start.offset - offset)) {
+      return;
+    }
+    ::close(fd_);
+    fd_ = -1;
+    if (!openFile(start.index)) {
+      fail("cannot create journal segment", errno);
+      return;
+    }
+    offset = start.offset;
+  }
+  writeAll(chunk.data() + offset, chunk.size() - offset);
+}
+
+bool JournalWriter::openFile(std::uint32_t index) {
+  const auto path = std::filesystem::path(options_.directory) / segmentFileName(index);
+  // O_EXCL: never append to or clobber a segment another writer owns.
+  fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    return false;
+  }
+  spdlog::info("Journaling events to {}", path.string());
+  return true;
+}
+
+bool JournalWriter::writeAll(const unsigned char* data, std::size_t size) {
+  std::size_t offset = 0;
+  while (fd_ >= 0 && offset < size) {
+    const auto written = ::write(fd_, data + offset, size - offset);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      fail("journal write failed", errno);
+      return false;
+    }
+    offset += static_cast<std::size_t>(written);
+  }
+  return fd_ >= 0;
+}
+
+void JournalWriter::fail(const char* what, int error) {
+  spdlog::error("{} in {}: {}; journaling stopped", what, options_.directory, std::strerror(error));
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.failed = true;
+  pending_.clear();
+  pending_starts_.clear();
+  flushed_.notify_all();
+}
+
+}  // namespace hermeneutic::journal
@@ -3,37 +3,78 @@
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
-#include <map>
+#include <deque>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "hermeneutic/common/assert.hpp"
 #include "hermeneutic/common/events.hpp"
+#include "hermeneutic/lob/order_index.hpp"
+#include "hermeneutic/lob/price_ladder.hpp"
 
 namespace hermeneutic::lob {
 
+// Net change applied to a single aggregated price level. `previous_quantity`
+// and `quantity` are zero when the level did not exist before/after the event.
+struct LevelDelta {
+  common::Side side{common::Side::Bid};
+  common::Decimal price{};
+  common::Decimal previous_quantity{};
+  common::Decimal quantity{};
+};
+
+using LevelDeltas = std::vector<LevelDelta>;
+
+struct BookStats {
+  std::size_t bid_levels{0};
+  std::size_t ask_levels{0};
+  std::size_t resting_orders{0};
+  // Orders the index holds before it has to grow.
+  std::size_t order_capacity{0};
+  // Ladders plus order index; the map ladder's share is an estimate.
+  std::size_t memory_bytes{0};
+  // Sequence tracking. A gap marks the book stale until a snapshot arrives;
+  // resync times are measured on the local receive clock.
+  bool stale{false};
+  std::size_t buffered_events{0};
+  std::uint64_t sequence_gaps{0};
+  std::uint64_t resyncs{0};
+  // Deltas lost to a full buffer or unsequenced while stale.
+  std::uint64_t dropped_events{0};
+  std::int64_t last_resync_ns{0};
+  std::int64_t max_resync_ns{0};
+};
+
 class LimitOrderBook {
  public:
-  using BidMap = std::map<common::Decimal, common::Decimal, std::greater<common::Decimal>>;
-  using AskMap = std::map<common::Decimal, common::Decimal, std::less<common::Decimal>>;
-  using OrderMap = std::unordered_map<std::uint64_t, common::MarketOrder>;
+  using BidLadder = PriceLadder<std::greater<common::Decimal>>;
+  using AskLadder = PriceLadder<std::less<common::Decimal>>;
+
+  LimitOrderBook() = default;
+  // Picks the price ladder backend; see BookOptions.
+  explicit LimitOrderBook(const BookOptions& options);
 
+  // Sequenced deltas must arrive without gaps. On a forward gap the book
+  // turns stale: its levels are reported as removed, later deltas are
+  // buffered, and the next snapshot resyncs it and replays the buffer.
   void apply(const common::BookEvent& event);
+  // Same as apply(event) but appends every level that changed to `deltas` so
+  // downstream consumers can maintain derived ladders incrementally.
+  void apply(const common::BookEvent& event, LevelDeltas& deltas);
 
   common::PriceLevel bestBid() const;
   common::PriceLevel bestAsk() const;
 
   // Level iterators keep callers at the aggregated price/quantity view.
-  using BidLevelIterator = BidMap::const_iterator;
-  using AskLevelIterator = AskMap::const_iterator;
+  using BidLevelIterator = BidLadder::const_iterator;
+  using AskLevelIterator = AskLadder::const_iterator;
   BidLevelIterator bidLevelsBegin() const;
   BidLevelIterator bidLevelsEnd() const;
   AskLevelIterator askLevelsBegin() const;
   AskLevelIterator askLevelsEnd() const;
 
   // Expose limit-order iteration for callers that need per-order details.
-  using OrderIterator = OrderMap::const_iterator;
+  using OrderIterator = OrderIndex::const_iterator;
   OrderIterator limitOrdersBegin() const;
   OrderIterator limitOrdersEnd() const;
 
@@ -42,17 +83,42 @@ class LimitOrderBook {
 
   common::OrderBookSnapshot snapshot(std::size_t depth) const;
   bool empty() const;
+  // True between a sequence gap and the snapshot that resyncs the book. The
+  // levels are not trustworthy meanwhile, so bestBid/bestAsk, the level
+  // iterators and snapshot() report an empty book until then.
+  bool stale() const { return stale_; }
+  BookStats stats() const;
   const std::string& exchange() const { return exchange_name_; }
   void setExchange(std::string name) { exchange_name_ = std::move(name); }
 
  private:
+  void applyEvent(const common::BookEvent& event, LevelDeltas* deltas);
+  void applyBody(const common::BookEvent& event, LevelDeltas* deltas);
+  void markStale(std::uint64_t received, std::int64_t local_ns, LevelDeltas* deltas);
+  void buffer(const common::BookEvent& event);
+  // Applies buffered deltas that follow the snapshot without a gap.
+  void replayBuffered(std::int64_t local_ns, LevelDeltas* deltas);
   void validateInvariants() const;
+  // Both ladders share one tick grid; logs and returns false for prices off
+  // it, or too far from `side`'s resting levels for the flat ladder's
+  // max_ticks.
+  bool acceptsPrice(common::Side side, const common::Decimal& price) const;
 
-  BidMap bids_;
-  AskMap asks_;
-  OrderMap orders_;
+  BidLadder bids_;
+  AskLadder asks_;
+  OrderIndex orders_;
   std::uint64_t last_sequence_{0};
+  std::size_t max_buffered_events_{BookOptions{}.max_buffered_events};
+  bool stale_{false};
+  std::int64_t stale_since_ns_{0};
+  std::deque<common::BookEvent> buffered_;
+  std::uint64_t sequence_gaps_{0};
+  std::uint64_t resyncs_{0};
+  std::uint64_t dropped_events_{0};
+  std::int64_t last_resync_ns_{0};
+  std::int64_t max_resync_ns_{0};
   std::string exchange_name_;
+  common::ExchangeId exchange_id_{common::kUnknownExchange};
   std::int64_t last_feed_timestamp_ns_{0};
   std::int64_t last_local_timestamp_ns_{0};
 };
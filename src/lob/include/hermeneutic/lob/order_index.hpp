@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "hermeneutic/common/events.hpp"
+
+namespace hermeneutic::lob {
+
+// Resting orders keyed by order id. Orders live densely in a preallocated
+// slab; an open-addressing table (linear probing, backward-shift deletion)
+// maps ids to slab positions. Nothing is allocated until the table has to
+// grow, and clear() is O(1): table slots are stamped with an epoch and a
+// reset simply starts a new one.
+class OrderIndex {
+ public:
+  using value_type = std::pair<std::uint64_t, common::MarketOrder>;
+  using const_iterator = std::vector<value_type>::const_iterator;
+
+  static constexpr std::size_t kDefaultCapacity = 1024;
+
+  explicit OrderIndex(std::size_t expected_orders = kDefaultCapacity);
+
+  // Returns nullptr when the id is not resting.
+  const common::MarketOrder* find(std::uint64_t order_id) const;
+  // Inserts or overwrites the order stored under order.order_id.
+  void insert(const common::MarketOrder& order);
+  bool erase(std::uint64_t order_id);
+  void clear();
+
+  bool empty() const { return orders_.empty(); }
+  std::size_t size() const { return orders_.size(); }
+  // Orders that fit before the next rehash.
+  std::size_t capacity() const { return slots_.size() / 2; }
+  std::size_t memoryBytes() const {
+    return slots_.capacity() * sizeof(Slot) + orders_.capacity() * sizeof(value_type);
+  }
+
+  const_iterator begin() const { return orders_.begin(); }
+  const_iterator end() const { return orders_.end(); }
+
+ private:
+  struct Slot {
+    std::uint64_t order_id{0};
+    std::uint32_t epoch{0};
+    std::uint32_t position{0};
+  };
+
+  std::size_t home(std::uint64_t order_id) const;
+  bool live(const Slot& slot) const { return slot.epoch == epoch_; }
+  // Slot holding `order_id`, or the empty slot where it would be inserted.
+  std::size_t probe(std::uint64_t order_id) const;
+  void rehash(std::size_t slot_count);
+
+  std::vector<Slot> slots_;
+  std::vector<value_type> orders_;
+  std::size_t mask_{0};
+  int shift_{0};
+  std::uint32_t epoch_{1};
+};
+
+}  // namespace hermeneutic::lob
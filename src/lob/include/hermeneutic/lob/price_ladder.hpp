@@ -0,0 +1,222 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "hermeneutic/common/decimal.hpp"
+
+namespace hermeneutic::lob {
+
+enum class LadderKind { Map, Flat };
+
+struct BookOptions {
+  LadderKind ladder{LadderKind::Map};
+  // Price grid of the flat ladder. Prices off the grid are rejected by the
+  // book; the map ladder ignores it.
+  common::Decimal tick_size{common::Decimal::fromString("0.01")};
+  // Ticks covered before the flat ladder has to recentre or grow.
+  std::size_t initial_ticks{4096};
+  // Widest span of ticks one side of the flat ladder may cover. A price that
+  // would stretch it further is logged and dropped instead of growing the
+  // array without bound.
+  std::size_t max_ticks{std::size_t{1} << 20};
+  // Resting orders the order index holds before it has to grow.
+  std::size_t expected_orders{1024};
+  // Deltas buffered while the book waits for a snapshot after a sequence
+  // gap; beyond this the oldest are dropped.
+  std::size_t max_buffered_events{65536};
+};
+
+// Contiguous quantity array indexed by (price / tick - base) with an
+// occupancy bitmap for best-price and neighbour scans. When a price falls
+// outside the window the ladder is recentred around the occupied range, in
+// place, and doubled if that range no longer fits, up to `max_ticks`.
+class FlatLadder {
+ public:
+  static constexpr std::size_t npos = ~static_cast<std::size_t>(0);
+
+  FlatLadder(common::Decimal tick, std::size_t initial_ticks, std::size_t max_ticks);
+
+  bool onGrid(common::Decimal price) const;
+  // Whether `price` can be stored without the occupied span exceeding
+  // `max_ticks`.
+  bool reaches(common::Decimal price) const;
+  // Price as stored on the grid; identical to `price` for on-grid input.
+  common::Decimal canonical(common::Decimal price) const { return priceOfTick(tickOf(price)); }
+  common::Decimal quantity(common::Decimal price) const;
+  // A non-positive quantity removes the level.
+  void set(common::Decimal price, common::Decimal quantity);
+  void clear();
+
+  bool empty() const { return count_ == 0; }
+  std::size_t size() const { return count_; }
+
+  std::size_t lowest() const { return low_; }
+  std::size_t highest() const { return high_; }
+  std::size_t nextAbove(std::size_t slot) const;
+  std::size_t nextBelow(std::size_t slot) const;
+  common::Decimal priceAt(std::size_t slot) const {
+    return priceOfTick(base_ + static_cast<std::int64_t>(slot));
+  }
+  common::Decimal quantityAt(std::size_t slot) const { return quantities_[slot]; }
+  std::size_t memoryBytes() const {
+    return quantities_.capacity() * sizeof(common::Decimal) + occupied_.capacity() * sizeof(std::uint64_t);
+  }
+
+ private:
+  std::int64_t tickOf(common::Decimal price) const;
+  common::Decimal priceOfTick(std::int64_t tick) const;
+  void recentre(std::int64_t tick);
+
+  common::Decimal tick_;
+  std::size_t max_ticks_;
+  std::int64_t base_{0};
+  std::vector<common::Decimal> quantities_;
+  std::vector<std::uint64_t> occupied_;
+  std::size_t count_{0};
+  std::size_t low_{npos};
+  std::size_t high_{npos};
+};
+
+// Price -> aggregated quantity for one side of a book, ordered best-first by
+// `Compare`. Backed by a std::map unless the book was built with a flat
+// ladder; the branch is fixed per book so it predicts perfectly.
+template <typename Compare>
+class PriceLadder {
+  static constexpr bool kDescending = std::is_same_v<Compare, std::greater<common::Decimal>>;
+  using Map = std::map<common::Decimal, common::Decimal, Compare>;
+
+ public:
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<common::Decimal, common::Decimal>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    const_iterator() = default;
+
+    reference operator*() const { return level_; }
+    pointer operator->() const { return &level_; }
+
+    const_iterator& operator++() {
+      if (flat_ != nullptr) {
+        slot_ = kDescending ? flat_->nextBelow(slot_) : flat_->nextAbove(slot_);
+      } else {
+        ++it_;
+      }
+      load();
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      auto copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) {
+      return lhs.flat_ != nullptr ? lhs.slot_ == rhs.slot_ : lhs.it_ == rhs.it_;
+    }
+
+   private:
+    friend class PriceLadder;
+
+    const_iterator(const Map* map, typename Map::const_iterator it) : map_(map), it_(it) { load(); }
+    const_iterator(const FlatLadder* flat, std::size_t slot) : flat_(flat), slot_(slot) { load(); }
+
+    void load() {
+      if (flat_ != nullptr) {
+        if (slot_ != FlatLadder::npos) {
+          level_ = {flat_->priceAt(slot_), flat_->quantityAt(slot_)};
+        }
+      } else if (it_ != map_->end()) {
+        level_ = *it_;
+      }
+    }
+
+    const Map* map_{nullptr};
+    typename Map::const_iterator it_{};
+    const FlatLadder* flat_{nullptr};
+    std::size_t slot_{FlatLadder::npos};
+    value_type level_{};
+  };
+
+  PriceLadder() = default;
+  explicit PriceLadder(const BookOptions& options) {
+    if (options.ladder == LadderKind::Flat) {
+      flat_.emplace(options.tick_size, options.initial_ticks, options.max_ticks);
+    }
+  }
+
+  bool accepts(common::Decimal price) const { return !flat_ || flat_->onGrid(price); }
+  bool reaches(common::Decimal price) const { return !flat_ || flat_->reaches(price); }
+  common::Decimal canonical(common::Decimal price) const {
+    return flat_ ? flat_->canonical(price) : price;
+  }
+
+  common::Decimal quantity(common::Decimal price) const {
+    if (flat_) {
+      return flat_->quantity(price);
+    }
+    auto it = map_.find(price);
+    return it != map_.end() ? it->second : common::Decimal::fromRaw(0);
+  }
+
+  void set(common::Decimal price, common::Decimal quantity) {
+    if (flat_) {
+      flat_->set(price, quantity);
+    } else if (quantity <= common::Decimal::fromRaw(0)) {
+      map_.erase(price);
+    } else {
+      map_.insert_or_assign(price, quantity);
+    }
+  }
+
+  void clear() {
+    if (flat_) {
+      flat_->clear();
+    } else {
+      map_.clear();
+    }
+  }
+
+  bool empty() const { return flat_ ? flat_->empty() : map_.empty(); }
+  std::size_t size() const { return flat_ ? flat_->size() : map_.size(); }
+  // Exact for the flat ladder; for the map it assumes a red-black node of
+  // four pointer-sized header words plus the value.
+  std::size_t memoryBytes() const {
+    if (flat_) {
+      return flat_->memoryBytes();
+    }
+    return map_.size() * (4 * sizeof(void*) + sizeof(typename Map::value_type));
+  }
+
+  const_iterator begin() const {
+    if (flat_) {
+      return const_iterator(&*flat_, kDescending ? flat_->highest() : flat_->lowest());
+    }
+    return const_iterator(&map_, map_.begin());
+  }
+
+  const_iterator end() const {
+    if (flat_) {
+      return const_iterator(&*flat_, FlatLadder::npos);
+    }
+    return const_iterator(&map_, map_.end());
+  }
+
+ private:
+  Map map_;
+  std::optional<FlatLadder> flat_;
+};
+
+}  // namespace hermeneutic::lob
@@ -1,5 +1,6 @@
 #include "hermeneutic/lob/order_book.hpp"
 
+#include <algorithm>
 #include <stdexcept>
 
 #include <spdlog/spdlog.h>
@@ -15,44 +16,74 @@ using common::PriceLevel;
 namespace {
 const Decimal kZero = Decimal::fromRaw(0);
 
+template <typename Ladder>
+void applyLevelDelta(common::Side side,
+                     common::Decimal price,
+                     common::Decimal delta,
+                     Ladder& levels,
+                     LevelDeltas* deltas) {
+  const Decimal previous = levels.quantity(price);
+  const Decimal next = previous + delta;
+  if (next <= kZero) {
+    if (previous <= kZero) {
+      return;
+    }
+    levels.set(price, kZero);
+    if (deltas != nullptr) {
+      deltas->push_back(LevelDelta{side, levels.canonical(price), previous, kZero});
+    }
+    return;
+  }
+  levels.set(price, next);
+  if (deltas != nullptr) {
+    deltas->push_back(LevelDelta{side, levels.canonical(price), previous, next});
+  }
+}
+
 void applyDelta(common::Side side,
                 common::Decimal price,
                 common::Decimal delta,
-                std::map<common::Decimal, common::Decimal, std::greater<common::Decimal>>& bids,
-                std::map<common::Decimal, common::Decimal, std::less<common::Decimal>>& asks) {
+                LimitOrderBook::BidLadder& bids,
+                LimitOrderBook::AskLadder& asks,
+                LevelDeltas* deltas) {
   HERMENEUTIC_ASSERT_DEBUG(price >= kZero, "price must be non-negative");
   if (side == common::Side::Bid) {
-    auto it = bids.find(price);
-    Decimal next = delta;
-    if (it != bids.end()) {
-      next = it->second + delta;
-    }
-    if (next <= kZero) {
-      if (it != bids.end()) {
-        bids.erase(it);
-      }
-      return;
-    }
-    bids[price] = next;
+    applyLevelDelta(side, price, delta, bids, deltas);
     return;
   }
+  applyLevelDelta(side, price, delta, asks, deltas);
+}
 
-  auto it = asks.find(price);
-  Decimal next = delta;
-  if (it != asks.end()) {
-    next = it->second + delta;
+template <typename Ladder>
+void setSnapshotLevel(common::Side side,
+                      const PriceLevel& level,
+                      Ladder& levels,
+                      LevelDeltas* deltas) {
+  const Decimal previous = levels.quantity(level.price);
+  levels.set(level.price, level.quantity);
+  if (deltas != nullptr) {
+    deltas->push_back(LevelDelta{side, levels.canonical(level.price), previous, level.quantity});
   }
-  if (next <= kZero) {
-    if (it != asks.end()) {
-      asks.erase(it);
-    }
+}
+
+template <typename Ladder>
+void recordCleared(common::Side side, const Ladder& levels, LevelDeltas* deltas) {
+  if (deltas == nullptr) {
     return;
   }
-  asks[price] = next;
+  for (const auto& [price, qty] : levels) {
+    deltas->push_back(LevelDelta{side, price, qty, kZero});
+  }
 }
 
 }  // namespace
 
+LimitOrderBook::LimitOrderBook(const BookOptions& options)
+    : bids_(options),
+      asks_(options),
+      orders_(options.expected_orders),
+      max_buffered_events_(options.max_buffered_events) {}
+
 void LimitOrderBook::validateInvariants() const {
 #if defined(HERMENEUTIC_ENABLE_DEBUG_ASSERTS) && HERMENEUTIC_ENABLE_DEBUG_ASSERTS
   bool first = true;
@@ -82,8 +113,8 @@ void LimitOrderBook::validateInvariants() const {
   }
 
   if (!bids_.empty() && !asks_.empty()) {
-    const auto& best_bid = bids_.begin()->first;
-    const auto& best_ask = asks_.begin()->first;
+    const auto best_bid = bids_.begin()->first;
+    const auto best_ask = asks_.begin()->first;
     if (!(best_ask > best_bid)) {
       spdlog::critical("Order book '{}' crossed: best_bid={} best_ask={}",
                        exchange_name_, best_bid.toString(6), best_ask.toString(6));
@@ -93,12 +124,49 @@ void LimitOrderBook::validateInvariants() const {
 #endif
 }
 
-void LimitOrderBook::apply(const BookEvent& event) {
-  if (!exchange_name_.empty() && exchange_name_ != event.exchange) {
-    throw std::invalid_argument("update exchange mismatch");
+bool LimitOrderBook::acceptsPrice(common::Side side, const Decimal& price) const {
+  if (!bids_.accepts(price)) {
+    spdlog::warn("Ignoring price {} on '{}': not on the book's tick grid",
+                 price.toString(6), exchange_name_);
+    return false;
+  }
+  if (!(side == common::Side::Bid ? bids_.reaches(price) : asks_.reaches(price))) {
+    spdlog::warn("Ignoring price {} on '{}': beyond the flat ladder's max_ticks from the resting {}",
+                 price.toString(6), exchange_name_, side == common::Side::Bid ? "bids" : "asks");
+    return false;
   }
-  if (exchange_name_.empty()) {
-    exchange_name_ = event.exchange;
+  return true;
+}
+
+void LimitOrderBook::apply(const BookEvent& event) {
+  applyEvent(event, nullptr);
+}
+
+void LimitOrderBook::apply(const BookEvent& event, LevelDeltas& deltas) {
+  applyEvent(event, &deltas);
+}
+
+void LimitOrderBook::applyEvent(const BookEvent& event, LevelDeltas* deltas) {
+  if (event.exchange_id != common::kUnknownExchange) {
+    if (exchange_id_ == common::kUnknownExchange) {
+      // The name may already be set, by setExchange() or a name-only event.
+      const auto& name = common::ExchangeRegistry::instance().name(event.exchange_id);
+      if (!exchange_name_.empty() && exchange_name_ != name) {
+        throw std::invalid_argument("update exchange mismatch");
+      }
+      exchange_id_ = event.exchange_id;
+      exchange_name_ = name;
+    } else if (exchange_id_ != event.exchange_id) {
+      throw std::invalid_argument("update exchange mismatch");
+    }
+  } else {
+    // Events built by hand may only carry the name.
+    if (!exchange_name_.empty() && exchange_name_ != event.exchange) {
+      throw std::invalid_argument("update exchange mismatch");
+    }
+    if (exchange_name_.empty()) {
+      exchange_name_ = event.exchange;
+    }
   }
 
   auto now = std::chrono::system_clock::now();
@@ -120,25 +188,106 @@ void LimitOrderBook::apply(const BookEvent& event) {
   if (event.sequence != 0 && event.sequence <= last_sequence_) {
     return;
   }
+
+  if (event.kind == BookEventKind::Snapshot) {
+    if (event.sequence != 0) {
+      last_sequence_ = event.sequence;
+    }
+    const bool resync = stale_;
+    applyBody(event, deltas);
+    if (resync) {
+      stale_ = false;
+      ++resyncs_;
+      last_resync_ns_ = local_ns - stale_since_ns_;
+      max_resync_ns_ = std::max(max_resync_ns_, last_resync_ns_);
+      spdlog::info("Order book '{}' resynced at sequence {} after {} us with {} buffered events",
+                   exchange_name_, last_sequence_, last_resync_ns_ / 1000, buffered_.size());
+      replayBuffered(local_ns, deltas);
+    }
+    return;
+  }
+
+  if (stale_) {
+    buffer(event);
+    return;
+  }
   if (event.sequence != 0) {
+    if (last_sequence_ != 0 && event.sequence != last_sequence_ + 1) {
+      markStale(event.sequence, local_ns, deltas);
+      buffer(event);
+      return;
+    }
     last_sequence_ = event.sequence;
   }
+  applyBody(event, deltas);
+}
+
+void LimitOrderBook::markStale(std::uint64_t received, std::int64_t local_ns, LevelDeltas* deltas) {
+  spdlog::warn("Sequence gap on '{}': expected {} but got {}; book is stale until the next snapshot",
+               exchange_name_, last_sequence_ + 1, received);
+  stale_ = true;
+  stale_since_ns_ = local_ns;
+  ++sequence_gaps_;
+  // Withdraw the book from downstream ladders; the next snapshot re-adds it.
+  recordCleared(common::Side::Bid, bids_, deltas);
+  recordCleared(common::Side::Ask, asks_, deltas);
+}
 
+void LimitOrderBook::buffer(const BookEvent& event) {
+  if (event.sequence == 0 || max_buffered_events_ == 0) {
+    // Unsequenced deltas cannot be placed relative to the snapshot.
+    ++dropped_events_;
+    return;
+  }
+  if (buffered_.size() >= max_buffered_events_) {
+    buffered_.pop_front();
+    ++dropped_events_;
+  }
+  buffered_.push_back(event);
+}
+
+void LimitOrderBook::replayBuffered(std::int64_t local_ns, LevelDeltas* deltas) {
+  std::stable_sort(buffered_.begin(), buffered_.end(),
+                   [](const BookEvent& lhs, const BookEvent& rhs) { return lhs.sequence < rhs.sequence; });
+  while (!buffered_.empty()) {
+    const auto& next = buffered_.front();
+    if (next.sequence <= last_sequence_) {
+      buffered_.pop_front();
+      continue;
+    }
+    if (last_sequence_ != 0 && next.sequence != last_sequence_ + 1) {
+      // Still missing deltas between the snapshot and the buffer; keep the
+      // rest for the next snapshot.
+      markStale(next.sequence, local_ns, deltas);
+      return;
+    }
+    last_sequence_ = next.sequence;
+    applyBody(next, deltas);
+    buffered_.pop_front();
+  }
+}
+
+void LimitOrderBook::applyBody(const BookEvent& event, LevelDeltas* deltas) {
   switch (event.kind) {
     case BookEventKind::Snapshot: {
       HERMENEUTIC_LOG_DEBUG("snapshot");
 
+      // A stale book's levels were already withdrawn when the gap was seen.
+      if (!stale_) {
+        recordCleared(common::Side::Bid, bids_, deltas);
+        recordCleared(common::Side::Ask, asks_, deltas);
+      }
       bids_.clear();
       asks_.clear();
       orders_.clear();
       for (const auto& level : event.snapshot.bids) {
-        if (level.quantity > kZero) {
-          bids_[level.price] = level.quantity;
+        if (level.quantity > kZero && acceptsPrice(common::Side::Bid, level.price)) {
+          setSnapshotLevel(common::Side::Bid, level, bids_, deltas);
         }
       }
       for (const auto& level : event.snapshot.asks) {
-        if (level.quantity > kZero) {
-          asks_[level.price] = level.quantity;
+        if (level.quantity > kZero && acceptsPrice(common::Side::Ask, level.price)) {
+          setSnapshotLevel(common::Side::Ask, level, asks_, deltas);
         }
       }
       break;
@@ -147,14 +296,13 @@ void LimitOrderBook::apply(const BookEvent& event) {
       HERMENEUTIC_LOG_DEBUG("new order");
 
       const auto& order = event.order;
-      if (order.order_id == 0) {
+      if (order.order_id == 0 || !acceptsPrice(order.side, order.price)) {
         break;
       }
-      auto existing = orders_.find(order.order_id);
-      if (existing != orders_.end()) {
-        auto removal = common::Decimal::fromRaw(0) - existing->second.quantity;
-        applyDelta(existing->second.side, existing->second.price, removal, bids_, asks_);
-        orders_.erase(existing);
+      if (const auto* existing = orders_.find(order.order_id)) {
+        auto removal = common::Decimal::fromRaw(0) - existing->quantity;
+        applyDelta(existing->side, existing->price, removal, bids_, asks_, deltas);
+        orders_.erase(order.order_id);
       }
       const auto reject_crossed = [&](common::Side side, const Decimal& price) {
         if (side == common::Side::Bid) {
@@ -179,8 +327,8 @@ void LimitOrderBook::apply(const BookEvent& event) {
       if (reject_crossed(order.side, order.price)) {
         break;
       }
-      orders_.emplace(order.order_id, order);
-      applyDelta(order.side, order.price, order.quantity, bids_, asks_);
+      orders_.insert(order);
+      applyDelta(order.side, order.price, order.quantity, bids_, asks_, deltas);
       break;
     }
     case BookEventKind::CancelOrder: {
@@ -189,13 +337,13 @@ void LimitOrderBook::apply(const BookEvent& event) {
       if (event.order.order_id == 0) {
         break;
       }
-      auto existing = orders_.find(event.order.order_id);
-      if (existing == orders_.end()) {
+      const auto* existing = orders_.find(event.order.order_id);
+      if (existing == nullptr) {
         break;
       }
-      auto removal = common::Decimal::fromRaw(0) - existing->second.quantity;
-      applyDelta(existing->second.side, existing->second.price, removal, bids_, asks_);
-      orders_.erase(existing);
+      auto removal = common::Decimal::fromRaw(0) - existing->quantity;
+      applyDelta(existing->side, existing->price, removal, bids_, asks_, deltas);
+      orders_.erase(event.order.order_id);
       break;
     }
   }
@@ -203,47 +351,50 @@ void LimitOrderBook::apply(const BookEvent& event) {
 }
 
 common::PriceLevel LimitOrderBook::bestBid() const {
-  if (bids_.empty()) {
+  if (stale_ || bids_.empty()) {
     return PriceLevel{Decimal::fromRaw(0), Decimal::fromRaw(0)};
   }
-  auto& level = *bids_.begin();
+  const auto level = *bids_.begin();
   return PriceLevel{level.first, level.second};
 }
 
 common::PriceLevel LimitOrderBook::bestAsk() const {
-  if (asks_.empty()) {
+  if (stale_ || asks_.empty()) {
     return PriceLevel{Decimal::fromRaw(0), Decimal::fromRaw(0)};
   }
-  auto& level = *asks_.begin();
+  const auto level = *asks_.begin();
   return PriceLevel{level.first, level.second};
 }
 
 LimitOrderBook::BidLevelIterator LimitOrderBook::bidLevelsBegin() const {
-  return bids_.cbegin();
+  return stale_ ? bids_.end() : bids_.begin();
 }
 
 LimitOrderBook::BidLevelIterator LimitOrderBook::bidLevelsEnd() const {
-  return bids_.cend();
+  return bids_.end();
 }
 
 LimitOrderBook::AskLevelIterator LimitOrderBook::askLevelsBegin() const {
-  return asks_.cbegin();
+  return stale_ ? asks_.end() : asks_.begin();
 }
 
 LimitOrderBook::AskLevelIterator LimitOrderBook::askLevelsEnd() const {
-  return asks_.cend();
+  return asks_.end();
 }
 
 LimitOrderBook::OrderIterator LimitOrderBook::limitOrdersBegin() const {
-  return orders_.cbegin();
+  return orders_.begin();
 }
 
 LimitOrderBook::OrderIterator LimitOrderBook::limitOrdersEnd() const {
-  return orders_.cend();
+  return orders_.end();
 }
 
 common::OrderBookSnapshot LimitOrderBook::snapshot(std::size_t depth) const {
   common::OrderBookSnapshot snap;
+  if (stale_) {
+    return snap;
+  }
   snap.bids.reserve(depth);
   snap.asks.reserve(depth);
 
@@ -265,6 +416,23 @@ common::OrderBookSnapshot LimitOrderBook::snapshot(std::size_t depth) const {
   return snap;
 }
 
+BookStats LimitOrderBook::stats() const {
+  return BookStats{
+      .bid_levels = bids_.size(),
+      .ask_levels = asks_.size(),
+      .resting_orders = orders_.size(),
+      .order_capacity = orders_.capacity(),
+      .memory_bytes = bids_.memoryBytes() + asks_.memoryBytes() + orders_.memoryBytes(),
+      .stale = stale_,
+      .buffered_events = buffered_.size(),
+      .sequence_gaps = sequence_gaps_,
+      .resyncs = resyncs_,
+      .dropped_events = dropped_events_,
+      .last_resync_ns = last_resync_ns_,
+      .max_resync_ns = max_resync_ns_,
+  };
+}
+
 bool LimitOrderBook::empty() const {
   return bids_.empty() && asks_.empty();
 }
@@ -0,0 +1,99 @@
+#include "hermeneutic/lob/order_index.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "hermeneutic/common/assert.hpp"
+
+namespace hermeneutic::lob {
+
+namespace {
+constexpr std::uint64_t kFibonacciMultiplier = 0x9E3779B97F4A7C15ULL;
+}  // namespace
+
+OrderIndex::OrderIndex(std::size_t expected_orders) {
+  rehash(std::bit_ceil(std::max<std::size_t>(expected_orders, 8) * 2));
+}
+
+std::size_t OrderIndex::home(std::uint64_t order_id) const {
+  // Exchange ids are often sequential; Fibonacci hashing spreads them.
+  return static_cast<std::size_t>((order_id * kFibonacciMultiplier) >> shift_);
+}
+
+std::size_t OrderIndex::probe(std::uint64_t order_id) const {
+  auto index = home(order_id);
+  while (live(slots_[index]) && slots_[index].order_id != order_id) {
+    index = (index + 1) & mask_;
+  }
+  return index;
+}
+
+const common::MarketOrder* OrderIndex::find(std::uint64_t order_id) const {
+  const auto& slot = slots_[probe(order_id)];
+  return live(slot) ? &orders_[slot.position].second : nullptr;
+}
+
+void OrderIndex::insert(const common::MarketOrder& order) {
+  auto index = probe(order.order_id);
+  if (live(slots_[index])) {
+    orders_[slots_[index].position].second = order;
+    return;
+  }
+  if (orders_.size() + 1 > capacity()) {
+    rehash(slots_.size() * 2);
+    index = probe(order.order_id);
+  }
+  slots_[index] = Slot{order.order_id, epoch_, static_cast<std::uint32_t>(orders_.size())};
+  orders_.emplace_back(order.order_id, order);
+}
+
+bool OrderIndex::erase(std::uint64_t order_id) {
+  auto hole = probe(order_id);
+  if (!live(slots_[hole])) {
+    return false;
+  }
+  const auto position = slots_[hole].position;
+  if (position + 1 != orders_.size()) {
+    // Keep the slab dense: move the last order into the vacated position.
+    orders_[position] = orders_.back();
+    slots_[probe(orders_[position].first)].position = position;
+  }
+  orders_.pop_back();
+
+  // Backward-shift deletion keeps probe sequences intact without tombstones.
+  slots_[hole].epoch = 0;
+  for (auto next = (hole + 1) & mask_; live(slots_[next]); next = (next + 1) & mask_) {
+    const auto ideal = home(slots_[next].order_id);
+    const bool movable = hole <= next ? (ideal <= hole || ideal > next) : (ideal <= hole && ideal > next);
+    if (movable) {
+      slots_[hole] = slots_[next];
+      slots_[next].epoch = 0;
+      hole = next;
+    }
+  }
+  return true;
+}
+
+void OrderIndex::clear() {
+  orders_.clear();
+  if (++epoch_ == 0) {
+    // Epoch wrapped: stale stamps could alias the new epoch, so wipe them.
+    std::fill(slots_.begin(), slots_.end(), Slot{});
+    epoch_ = 1;
+  }
+}
+
+void OrderIndex::rehash(std::size_t slot_count) {
+  HERMENEUTIC_ASSERT_DEBUG(std::has_single_bit(slot_count), "order index size must be a power of two");
+  slots_.assign(slot_count, Slot{});
+  mask_ = slot_count - 1;
+  shift_ = 64 - std::countr_zero(slot_count);
+  epoch_ = 1;
+  orders_.reserve(capacity());
+  for (std::size_t position = 0; position < orders_.size(); ++position) {
+    const auto index = probe(orders_[position].first);
+    slots_[index] = Slot{orders_[position].first, epoch_, static_cast<std::uint32_t>(position)};
+  }
+}
+
+}  // namespace hermeneutic::lob
@@ -0,0 +1,243 @@
+#include "hermeneutic/lob/price_ladder.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+
+#include "hermeneutic/common/assert.hpp"
+
+namespace hermeneutic::lob {
+
+using common::Decimal;
+
+namespace {
+const Decimal kZero = Decimal::fromRaw(0);
+using Storage = decltype(Decimal{}.raw());
+
+// Tick arithmetic is exact on the integer Decimal backends; the double
+// backend rounds to the nearest tick and accepts a tiny relative error.
+template <typename Raw>
+std::int64_t ticksIn(Raw raw, Raw tick) {
+  if constexpr (std::is_floating_point_v<Raw>) {
+    return std::llround(raw / tick);
+  } else {
+    return static_cast<std::int64_t>(raw / tick);
+  }
+}
+
+template <typename Raw>
+bool ticksOnGrid(Raw raw, Raw tick) {
+  if constexpr (std::is_floating_point_v<Raw>) {
+    return std::fabs(raw - std::round(raw / tick) * tick) <= tick * 1e-6;
+  } else {
+    return raw % tick == 0;
+  }
+}
+
+std::size_t roundUpPow2(std::size_t value) {
+  return std::bit_ceil(std::max<std::size_t>(value, 64));
+}
+}  // namespace
+
+FlatLadder::FlatLadder(Decimal tick, std::size_t initial_ticks, std::size_t max_ticks)
+    : tick_(tick),
+      max_ticks_(std::max<std::size_t>(max_ticks, 1)),
+      quantities_(roundUpPow2(std::min(initial_ticks, max_ticks_)), kZero),
+      occupied_(quantities_.size() / 64, 0) {
+  if (!(tick > kZero)) {
+    throw std::invalid_argument("flat ladder tick size must be positive");
+  }
+}
+
+bool FlatLadder::onGrid(Decimal price) const {
+  return ticksOnGrid(price.raw(), tick_.raw());
+}
+
+bool FlatLadder::reaches(Decimal price) const {
+  if (count_ == 0) {
+    return true;
+  }
+  const auto tick = tickOf(price);
+  const auto low_tick = std::min(tick, base_ + static_cast<std::int64_t>(low_));
+  const auto high_tick = std::max(tick, base_ + static_cast<std::int64_t>(high_));
+  return static_cast<std::uint64_t>(high_tick - low_tick) < max_ticks_;
+}
+
+std::int64_t FlatLadder::tickOf(Decimal price) const {
+  return ticksIn(price.raw(), tick_.raw());
+}
+
+Decimal FlatLadder::priceOfTick(std::int64_t tick) const {
+  return Decimal::fromRaw(static_cast<Storage>(tick) * tick_.raw());
+}
+
+Decimal FlatLadder::quantity(Decimal price) const {
+  const auto offset = tickOf(price) - base_;
+  if (offset < 0 || static_cast<std::size_t>(offset) >= quantities_.size()) {
+    return kZero;
+  }
+  return quantities_[static_cast<std::size_t>(offset)];
+}
+
+void FlatLadder::set(Decimal price, Decimal quantity) {
+  HERMENEUTIC_ASSERT_DEBUG(onGrid(price), "flat ladder price off the tick grid");
+  HERMENEUTIC_ASSERT_DEBUG(quantity <= kZero || reaches(price), "flat ladder span exceeds max_ticks");
+  const auto tick = tickOf(price);
+  auto offset = tick - base_;
+  if (offset < 0 || static_cast<std::size_t>(offset) >= quantities_.size()) {
+    if (quantity <= kZero) {
+      return;
+    }
+    recentre(tick);
+    offset = tick - base_;
+  }
+  const auto slot = static_cast<std::size_t>(offset);
+  auto& word = occupied_[slot >> 6];
+  const auto bit = std::uint64_t{1} << (slot & 63);
+  const bool was_set = (word & bit) != 0;
+
+  if (quantity <= kZero) {
+    if (!was_set) {
+      return;
+    }
+    quantities_[slot] = kZero;
+    word &= ~bit;
+    --count_;
+    if (count_ == 0) {
+      low_ = high_ = npos;
+    } else if (slot == low_) {
+      low_ = nextAbove(slot);
+    } else if (slot == high_) {
+      high_ = nextBelow(slot);
+    }
+    return;
+  }
+
+  quantities_[slot] = quantity;
+  if (was_set) {
+    return;
+  }
+  word |= bit;
+  ++count_;
+  if (low_ == npos || slot < low_) {
+    low_ = slot;
+  }
+  if (high_ == npos || slot > high_) {
+    high_ = slot;
+  }
+}
+
+void FlatLadder::clear() {
+  if (count_ == 0) {
+    return;
+  }
+  for (std::size_t w = low_ >> 6; w <= (high_ >> 6); ++w) {
+    occupied_[w] = 0;
+  }
+  std::fill(quantities_.begin() + static_cast<std::ptrdiff_t>(low_),
+            quantities_.begin() + static_cast<std::ptrdiff_t>(high_) + 1, kZero);
+  count_ = 0;
+  low_ = high_ = npos;
+}
+
+std::size_t FlatLadder::nextAbove(std::size_t slot) const {
+  const auto from = slot + 1;
+  if (from >= quantities_.size()) {
+    return npos;
+  }
+  std::size_t w = from >> 6;
+  std::uint64_t word = occupied_[w] & (~std::uint64_t{0} << (from & 63));
+  while (word == 0) {
+    if (++w == occupied_.size()) {
+      return npos;
+    }
+    word = occupied_[w];
+  }
+  return (w << 6) + static_cast<std::size_t>(std::countr_zero(word));
+}
+
+std::size_t FlatLadder::nextBelow(std::size_t slot) const {
+  if (slot == 0 || slot == npos) {
+    return npos;
+  }
+  const auto from = slot - 1;
+  std::size_t w = from >> 6;
+  std::uint64_t word = occupied_[w] & (~std::uint64_t{0} >> (63 - (from & 63)));
+  while (word == 0) {
+    if (w-- == 0) {
+      return npos;
+    }
+    word = occupied_[w];
+  }
+  return (w << 6) + 63 - static_cast<std::size_t>(std::countl_zero(word));
+}
+
+void FlatLadder::recentre(std::int64_t tick) {
+  std::int64_t low_tick = tick;
+  std::int64_t high_tick = tick;
+  if (count_ != 0) {
+    low_tick = std::min(low_tick, base_ + static_cast<std::int64_t>(low_));
+    high_tick = std::max(high_tick, base_ + static_cast<std::int64_t>(high_));
+  }
+  const auto span = static_cast<std::size_t>(high_tick - low_tick) + 1;
+  // Double for headroom, but never past the pow2 that covers max_ticks; the
+  // book has already refused any price that would not fit in that.
+  const auto max_capacity = std::max(roundUpPow2(max_ticks_), quantities_.size());
+  auto capacity = quantities_.size();
+  while (capacity < 2 * span && capacity < max_capacity) {
+    capacity *= 2;
+  }
+  // Leave equal headroom on both sides so drift in either direction is cheap.
+  const auto new_base = low_tick - static_cast<std::int64_t>((capacity - span) / 2);
+
+  if (capacity == quantities_.size()) {
+    // Same size: slide the levels in place so a drifting price never
+    // allocates. Walk from the end they move towards, so a level is never
+    // written over one that has yet to move.
+    const auto shift = base_ - new_base;
+    base_ = new_base;
+    if (count_ == 0 || shift == 0) {
+      return;
+    }
+    const auto move = [&](std::size_t slot) {
+      const auto moved = static_cast<std::size_t>(static_cast<std::int64_t>(slot) + shift);
+      quantities_[moved] = quantities_[slot];
+      quantities_[slot] = kZero;
+      occupied_[slot >> 6] &= ~(std::uint64_t{1} << (slot & 63));
+      occupied_[moved >> 6] |= std::uint64_t{1} << (moved & 63);
+    };
+    if (shift > 0) {
+      for (auto slot = high_; slot != npos; slot = nextBelow(slot)) {
+        move(slot);
+      }
+    } else {
+      for (auto slot = low_; slot != npos; slot = nextAbove(slot)) {
+        move(slot);
+      }
+    }
+    low_ = static_cast<std::size_t>(static_cast<std::int64_t>(low_) + shift);
+    high_ = static_cast<std::size_t>(static_cast<std::int64_t>(high_) + shift);
+    return;
+  }
+
+  std::vector<Decimal> quantities(capacity, kZero);
+  std::vector<std::uint64_t> occupied(capacity / 64, 0);
+  std::size_t new_low = npos;
+  std::size_t new_high = npos;
+  for (auto slot = low_; slot != npos; slot = nextAbove(slot)) {
+    const auto moved = static_cast<std::size_t>(base_ + static_cast<std::int64_t>(slot) - new_base);
+    quantities[moved] = quantities_[slot];
+    occupied[moved >> 6] |= std::uint64_t{1} << (moved & 63);
+    new_low = std::min(new_low, moved);
+    new_high = new_high == npos ? moved : std::max(new_high, moved);
+  }
+  quantities_ = std::move(quantities);
+  occupied_ = std::move(occupied);
+  base_ = new_base;
+  low_ = new_low;
+  high_ = new_high;
+}
+
+}  // namespace hermeneutic::lob
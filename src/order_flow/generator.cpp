@@ -0,0 +1,177 @@
+#include "hermeneutic/order_flow/generator.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "hermeneutic/common/exchange_registry.hpp"
+
+namespace hermeneutic::order_flow {
+
+using common::BookEvent;
+using common::BookEventKind;
+using common::Decimal;
+using common::Side;
+
+namespace {
+
+std::uint64_t splitmix64(std::uint64_t& state) {
+  std::uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+std::uint64_t rotl(std::uint64_t x, int k) {
+  return (x << k) | (x >> (64 - k));
+}
+
+bool isProbability(double value) {
+  return value >= 0.0 && value <= 1.0;
+}
+
+}  // namespace
+
+OrderFlowGenerator::OrderFlowGenerator(FlowOptions options)
+    : options_(std::move(options)),
+      exchange_id_(common::ExchangeRegistry::instance().intern(options_.exchange)),
+      mid_ticks_(options_.start_mid_ticks) {
+  if (options_.depth == 0 || options_.max_quantity <= 0 || options_.max_resting == 0) {
+    throw std::invalid_argument("order flow depth, max_quantity and max_resting must be positive");
+  }
+  if (!isProbability(options_.cancel_ratio) || !isProbability(options_.walk_probability) ||
+      !isProbability(options_.cross_probability)) {
+    throw std::invalid_argument("order flow ratios must lie in [0, 1]");
+  }
+  if (options_.price_digits < 0 || options_.price_digits > 18) {
+    throw std::invalid_argument("order flow price_digits must lie in [0, 18]");
+  }
+  // Keep every level of the ladder above zero.
+  mid_ticks_ = std::max<std::int64_t>(mid_ticks_, static_cast<std::int64_t>(options_.depth) + 1);
+  auto seed = options_.seed;
+  for (auto& word : state_) {
+    word = splitmix64(seed);
+  }
+  resting_.reserve(std::min<std::size_t>(options_.max_resting, 1 << 20));
+}
+
+void OrderFlowGenerator::snapshot(BookEvent& event) {
+  event.exchange_id = exchange_id_;
+  event.kind = BookEventKind::Snapshot;
+  event.sequence = ++sequence_;
+  event.snapshot.bids.clear();
+  event.snapshot.asks.clear();
+  const auto quantity = Decimal::fromInteger(options_.max_quantity);
+  for (std::size_t level = 1; level <= options_.depth; ++level) {
+    const auto offset = static_cast<std::int64_t>(level);
+    event.snapshot.bids.push_back({ticks(mid_ticks_ - offset), quantity});
+    event.snapshot.asks.push_back({ticks(mid_ticks_ + offset), quantity});
+  }
+}
+
+void OrderFlowGenerator::next(BookEvent& event) {
+  event.exchange_id = exchange_id_;
+  event.sequence = ++sequence_;
+
+  if (options_.walk_probability > 0 && uniform() < options_.walk_probability) {
+    mid_ticks_ += (nextRandom() & 1) != 0 ? 1 : -1;
+    mid_ticks_ = std::max<std::int64_t>(mid_ticks_, static_cast<std::int64_t>(options_.depth) + 1);
+  }
+
+  if (!resting_.empty() && (resting_.size() >= options_.max_resting || uniform() < options_.cancel_ratio)) {
+    // Swap-remove keeps cancelling a random resting order O(1).
+    const auto index = static_cast<std::size_t>(below(resting_.size()));
+    event.kind = BookEventKind::CancelOrder;
+    event.order.order_id = resting_[index];
+    resting_[index] = resting_.back();
+    resting_.pop_back();
+    return;
+  }
+
+  const auto bits = nextRandom();
+  const auto side = (bits & 1) != 0 ? Side::Bid : Side::Ask;
+  auto offset = static_cast<std::int64_t>(below(options_.depth)) + 1;
+  if (options_.cross_probability > 0 && uniform() < options_.cross_probability) {
+    offset = -offset;
+  }
+  event.kind = BookEventKind::NewOrder;
+  event.order.order_id = next_order_id_++;
+  event.order.side = side;
+  event.order.price = ticks(side == Side::Bid ? mid_ticks_ - offset : mid_ticks_ + offset);
+  const auto quantity = below(static_cast<std::uint64_t>(options_.max_quantity)) + 1;
+  event.order.quantity = Decimal::fromInteger(static_cast<std::int64_t>(quantity));
+  resting_.push_back(event.order.order_id);
+}
+
+std::uint64_t OrderFlowGenerator::nextRandom() {
+  const auto result = rotl(state_[1] * 5, 7) * 9;
+  const auto t = state_[1] << 17;
+  state_[2] ^= state_[0];
+  state_[3] ^= state_[1];
+  state_[1] ^= state_[2];
+  state_[0] ^= state_[3];
+  state_[2] ^= t;
+  state_[3] = rotl(state_[3], 45);
+  return result;
+}
+
+double OrderFlowGenerator::uniform() {
+  return static_cast<double>(nextRandom() >> 11) * 0x1.0p-53;
+}
+
+std::uint64_t OrderFlowGenerator::below(std::uint64_t bound) {
+  // Lemire's multiply-shift on the top 32 bits; bounds here (depth,
+  // quantity, resting orders) stay far below 2^32, where the bias is
+  // negligible.
+  return ((nextRandom() >> 32) * bound) >> 32;
+}
+
+Decimal OrderFlowGenerator::ticks(std::int64_t count) const {
+  return Decimal::fromScaled(count, options_.price_digits);
+}
+
+void appendNdjson(const BookEvent& event, int price_digits, std::string& out) {
+  out += R"({"type":")";
+  switch (event.kind) {
+    case BookEventKind::Snapshot: {
+      out += R"(snapshot","sequence":)";
+      out += std::to_string(event.sequence);
+      auto levels = [&](const char* name, const std::vector<common::PriceLevel>& side) {
+        out += R"(,")";
+        out += name;
+        out += R"(":[)";
+        for (std::size_t i = 0; i < side.size(); ++i) {
+          out += i == 0 ? R"({"price":")" : R"(,{"price":")";
+          out += side[i].price.toString(price_digits);
+          out += R"(","quantity":")";
+          out += side[i].quantity.toString(price_digits);
+          out += R"("})";
+        }
+        out += ']';
+      };
+      levels("bids", event.snapshot.bids);
+      levels("asks", event.snapshot.asks);
+      break;
+    }
+    case BookEventKind::NewOrder:
+      out += R"(new_order","sequence":)";
+      out += std::to_string(event.sequence);
+      out += R"(,"order_id":)";
+      out += std::to_string(event.order.order_id);
+      out += event.order.side == Side::Bid ? R"(,"side":"bid","price":")" : R"(,"side":"ask","price":")";
+      out += event.order.price.toString(price_digits);
+      out += R"(","quantity":")";
+      out += event.order.quantity.toString(price_digits);
+      out += '"';
+      break;
+    case BookEventKind::CancelOrder:
+      out += R"(cancel_order","sequence":)";
+      out += std::to_string(event.sequence);
+      out += R"(,"order_id":)";
+      out += std::to_string(event.order.order_id);
+      break;
+  }
+  out += "}\n";
+}
+
+}  // namespace hermeneutic::order_flow
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "hermeneutic/common/events.hpp"
+
+namespace hermeneutic::order_flow {
+
+struct FlowOptions {
+  // Interned into every event's exchange_id.
+  std::string exchange{"synthetic"};
+  std::uint64_t seed{1};
+  // Levels either side of the mid: the snapshot fills all of them and new
+  // orders land on one of them.
+  std::size_t depth{20};
+  // Prices are integer ticks of 10^-price_digits.
+  std::int64_t start_mid_ticks{10'000};
+  int price_digits{2};
+  // Share of events that cancel a resting order (while any rest).
+  double cancel_ratio{0.45};
+  // Per-event chance that the mid steps one tick up or down.
+  double walk_probability{0.01};
+  // Share of new orders priced through the mid onto the other side's
+  // levels, which LimitOrderBook rejects as crossed. With no walk, zero
+  // never crosses; a walking mid can still price orders through stale ones.
+  double cross_probability{0.0};
+  // New order sizes are uniform in [1, max_quantity] whole units.
+  std::int64_t max_quantity{10};
+  // Once this many orders rest, every event cancels until it drops.
+  std::size_t max_resting{100'000};
+};
+
+// Deterministic synthetic order flow for one exchange: a snapshot and then
+// an endless stream of new and cancel orders around a random-walk mid.
+// Events are written into caller-owned BookEvents, so a loop that reuses
+// one event allocates nothing; generation runs at tens of millions of
+// events per second. The same options and seed always give the same flow.
+class OrderFlowGenerator {
+ public:
+  // Throws std::invalid_argument for out-of-range options.
+  explicit OrderFlowGenerator(FlowOptions options);
+
+  // Snapshot of `depth` levels per side around the current mid. Resting
+  // orders are kept, so a snapshot can also resync a book mid-stream.
+  void snapshot(common::BookEvent& event);
+  // Next new or cancel order.
+  void next(common::BookEvent& event);
+
+  const FlowOptions& options() const { return options_; }
+  common::ExchangeId exchangeId() const { return exchange_id_; }
+  std::uint64_t sequence() const { return sequence_; }
+  std::int64_t midTicks() const { return mid_ticks_; }
+  std::size_t restingOrders() const { return resting_.size(); }
+
+ private:
+  // xoshiro256**; std::mt19937_64 plus distributions would dominate the
+  // cost of an event.
+  std::uint64_t nextRandom();
+  double uniform();
+  std::uint64_t below(std::uint64_t bound);
+  common::Decimal ticks(std::int64_t count) const;
+
+  FlowOptions options_;
+  common::ExchangeId exchange_id_;
+  std::uint64_t state_[4];
+  std::uint64_t sequence_{0};
+  std::uint64_t next_order_id_{1};
+  std::int64_t mid_ticks_;
+  std::vector<std::uint64_t> resting_;
+};
+
+// Appends `event` as one NDJSON line in the cex_type1 feed format, so
+// generated flow can be served by cex_type1_service.
+void appendNdjson(const common::BookEvent& event, int price_digits, std::string& out);
+
+}  // namespace hermeneutic::order_flow
@@ -6,6 +6,7 @@
 #include <condition_variable>
 #include <cstdint>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -113,10 +114,10 @@ TEST_CASE("aggregator waits for expected exchanges before publishing") {
   std::condition_variable cv;
   std::vector<hermeneutic::common::AggregatedBookView> updates;
 
-  auto id = engine.subscribe([&](const hermeneutic::common::AggregatedBookView& view) {
+  auto id = engine.subscribe([&](const hermeneutic::aggregator::BookSnapshot& view) {
     {
       std::lock_guard<std::mutex> lock(mutex);
-      updates.push_back(view);
+      updates.push_back(*view);
     }
     cv.notify_one();
   });
@@ -139,7 +140,7 @@ TEST_CASE("aggregator waits for expected exchanges before publishing") {
     CHECK(updates.back().best_ask.price > updates.back().best_bid.price);
   }
 
-  engine.push(makeNewOrder("ex1", 4, Side::Bid, "103.00", "3", 4));
+  engine.push(makeNewOrder("ex1", 4, Side::Bid, "103.00", "3", 3));
   {
     std::unique_lock<std::mutex> lock(mutex);
     CHECK(cv.wait_for(lock, std::chrono::milliseconds(200), [&] { return updates.size() >= 2; }));
@@ -158,7 +159,7 @@ TEST_CASE("aggregator publishes asynchronously even with slow subscribers") {
   engine.start();
 
   std::atomic<int> callback_count{0};
-  auto id = engine.subscribe([&](const hermeneutic::common::AggregatedBookView&) {
+  auto id = engine.subscribe([&](const hermeneutic::aggregator::BookSnapshot&) {
     callback_count.fetch_add(1);
     std::this_thread::sleep_for(std::chrono::milliseconds(50));
   });
@@ -188,3 +189,313 @@ TEST_CASE("aggregator publishes asynchronously even with slow subscribers") {
   engine.unsubscribe(id);
   engine.stop();
 }
+
+TEST_CASE("aggregator conflates bursts into one snapshot per publish interval") {
+  hermeneutic::aggregator::AggregationEngine engine;
+  engine.setPublishOptions({.interval = std::chrono::milliseconds(100)});
+  engine.start();
+
+  std::mutex mutex;
+  std::vector<hermeneutic::common::AggregatedBookView> updates;
+  auto id = engine.subscribe([&](const hermeneutic::aggregator::BookSnapshot& view) {
+    std::lock_guard<std::mutex> lock(mutex);
+    updates.push_back(*view);
+  });
+
+  for (std::uint64_t i = 1; i <= 50; ++i) {
+    engine.push(makeNewOrder("ex1", i, Side::Bid, std::to_string(100 + i) + ".00", "1", i));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(350));
+  engine.unsubscribe(id);
+  engine.stop();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  CHECK(!updates.empty());
+  CHECK(updates.size() < 10);
+  CHECK(updates.back().best_bid.price.toString(2) == "150.00");
+}
+
+TEST_CASE("aggregator shares immutable snapshots with subscribers and readers") {
+  hermeneutic::aggregator::AggregationEngine engine;
+  engine.start();
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<hermeneutic::aggregator::BookSnapshot> published;
+  auto id = engine.subscribe([&](const hermeneutic::aggregator::BookSnapshot& view) {
+    std::lock_guard<std::mutex> lock(mutex);
+    published.push_back(view);
+    cv.notify_all();
+  });
+
+  engine.push(makeNewOrder("ex1", 1, Side::Bid, "100.00", "1", 1));
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    CHECK(cv.wait_for(lock, std::chrono::seconds(1), [&] { return published.size() == 1; }));
+  }
+  const auto first = engine.snapshot();
+  CHECK(first == published.front());
+
+  engine.push(makeNewOrder("ex1", 2, Side::Bid, "101.00", "1", 2));
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    CHECK(cv.wait_for(lock, std::chrono::seconds(1), [&] { return published.size() == 2; }));
+  }
+  engine.unsubscribe(id);
+  engine.stop();
+
+  // Earlier snapshots are left as published.
+  CHECK(first->bid_levels.size() == 1);
+  CHECK(engine.snapshot()->bid_levels.size() == 2);
+  CHECK(engine.snapshot() == published.back());
+  CHECK(engine.snapshot("SOLUSDT")->exchange_count == 0);
+}
+
+TEST_CASE("aggregator keeps snapshot() current when nothing is published") {
+  hermeneutic::aggregator::AggregationEngine engine;
+  engine.setPublishOptions({.bbo_changes_only = true, .view_refresh = std::chrono::milliseconds(5)});
+  std::atomic<int> callback_count{0};
+  auto id = engine.subscribe([&](const hermeneutic::aggregator::BookSnapshot&) { callback_count.fetch_add(1); });
+  engine.start();
+
+  engine.push(makeNewOrder("ex1", 1, Side::Bid, "100.00", "1", 1));
+  // Below the best bid: the book changes but nothing is published.
+  engine.push(makeNewOrder("ex1", 2, Side::Bid, "99.00", "1", 2));
+  engine.push(makeNewOrder("ex2", 3, Side::Bid, "98.00", "1", 1));
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  while (engine.snapshot()->bid_levels.size() < 3 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  CHECK(engine.snapshot()->bid_levels.size() == 3);
+  CHECK(engine.snapshot()->exchange_count == 2);
+  CHECK(callback_count.load() == 1);
+
+  engine.unsubscribe(id);
+  engine.stop();
+}
+
+TEST_CASE("aggregator applies queued events in batches") {
+  for (const std::size_t max_batch : {std::size_t{64}, std::size_t{10}}) {
+    CAPTURE(max_batch);
+    hermeneutic::aggregator::AggregationEngine engine;
+    engine.setPublishOptions({.max_batch = max_batch});
+    std::mutex mutex;
+    std::vector<std::string> best_bids;
+    auto id = engine.subscribe([&](const hermeneutic::aggregator::BookSnapshot& view) {
+      std::lock_guard<std::mutex> lock(mutex);
+      best_bids.push_back(view->best_bid.price.toString(2));
+    });
+    // Queued before the worker starts, so it drains them in full batches.
+    for (std::uint64_t i = 1; i <= 50; ++i) {
+      engine.push(makeNewOrder("ex1", i, Side::Bid, std::to_string(100 + i) + ".00", "1", i));
+    }
+    engine.start();
+    const std::size_t expected = (50 + max_batch - 1) / max_batch;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+    while (std::chrono::steady_clock::now() < deadline) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (best_bids.size() >= expected) {
+          break;
+        }
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    engine.unsubscribe(id);
+    engine.stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    CHECK(best_bids.size() == expected);
+    CHECK(!best_bids.empty());
+    if (!best_bids.empty()) {
+      CHECK(best_bids.back() == "150.00");
+    }
+    CHECK(engine.latest().bid_levels.size() == 50);
+  }
+}
+
+TEST_CASE("aggregator can publish only when the best bid or ask changes") {
+  hermeneutic::aggregator::AggregationEngine engine;
+  engine.setPublishOptions({.bbo_changes_only = true});
+  engine.start();
+
+  std::atomic<int> callback_count{0};
+  auto id = engine.subscribe([&](const hermeneutic::aggregator::BookSnapshot&) {
+    callback_count.fetch_add(1);
+  });
+
+  engine.push(makeNewOrder("ex1", 1, Side::Bid, "100.00", "1", 1));
+  engine.push(makeNewOrder("ex1", 2, Side::Ask, "105.00", "1", 2));
+  // Deeper levels leave the top of book untouched and must not publish.
+  engine.push(makeNewOrder("ex1", 3, Side::Bid, "99.00", "1", 3));
+  engine.push(makeNewOrder("ex1", 4, Side::Ask, "106.00", "1", 4));
+  engine.push(makeNewOrder("ex2", 5, Side::Bid, "100.00", "2", 1));
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+  while (std::chrono::steady_clock::now() < deadline && callback_count.load() < 3) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  CHECK(callback_count.load() == 3);
+  CHECK(engine.latest().bid_levels.size() == 2);
+
+  engine.unsubscribe(id);
+  engine.stop();
+}
+
+TEST_CASE("aggregator compares the best bid and ask against the last offered book") {
+  hermeneutic::aggregator::AggregationEngine engine;
+  engine.setPublishOptions({.bbo_changes_only = true});
+  engine.start();
+
+  // Nobody listens yet, so this top of book is never offered.
+  engine.push(makeNewOrder("ex1", 1, Side::Bid, "100.00", "1", 1));
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  while (engine.snapshot()->bid_levels.empty() && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  std::atomic<int> callback_count{0};
+  auto id = engine.subscribe([&](const hermeneutic::aggregator::BookSnapshot&) { callback_count.fetch_add(1); });
+  // Leaves the top alone, but the first subscriber has not seen it yet.
+  engine.push(makeNewOrder("ex1", 2, Side::Bid, "99.00", "1", 2));
+  while (callback_count.load() == 0 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  CHECK(callback_count.load() == 1);
+
+  engine.unsubscribe(id);
+  engine.stop();
+}
+
+TEST_CASE("aggregator ingests from several producers over the lock-free queue") {
+  hermeneutic::aggregator::AggregationEngine engine(hermeneutic::common::QueueOptions{
+      .kind = hermeneutic::common::QueueKind::LockFree,
+      .wait = hermeneutic::common::WaitStrategy::Hybrid,
+      .capacity = 256,
+  });
+  engine.start();
+
+  constexpr std::uint64_t kPerFeed = 500;
+  std::vector<std::thread> feeds;
+  for (const char* exchange : {"ex1", "ex2", "ex3"}) {
+    feeds.emplace_back([&engine, exchange] {
+      for (std::uint64_t i = 1; i <= kPerFeed; ++i) {
+        engine.push(makeNewOrder(exchange, i, Side::Bid, "100.00", "1", i));
+      }
+    });
+  }
+  for (auto& feed : feeds) {
+    feed.join();
+  }
+
+  const auto expected = std::to_string(3 * kPerFeed);
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(1000);
+  auto view = engine.latest();
+  while (std::chrono::steady_clock::now() < deadline && view.best_bid.quantity.toString(0) != expected) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    view = engine.latest();
+  }
+  CHECK(view.best_bid.price.toString(2) == "100.00");
+  CHECK(view.best_bid.quantity.toString(0) == expected);
+  engine.stop();
+}
+
+TEST_CASE("aggregator mixes map and flat ladder books per exchange") {
+  hermeneutic::aggregator::AggregationEngine engine;
+  engine.setBookOptions("flat", hermeneutic::lob::BookOptions{
+                                    .ladder = hermeneutic::lob::LadderKind::Flat,
+                                    .tick_size = Decimal::fromString("0.01"),
+                                });
+  engine.start();
+  engine.push(makeNewOrder("flat", 1, Side::Bid, "100.00", "1", 1, timeFromNanoseconds(100)));
+  engine.push(makeNewOrder("map", 2, Side::Bid, "100.00", "2", 2, timeFromNanoseconds(200)));
+  engine.push(makeNewOrder("flat", 3, Side::Ask, "101.50", "4", 2, timeFromNanoseconds(300)));
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+  auto view = engine.latest();
+  while (std::chrono::steady_clock::now() < deadline &&
+         (view.best_bid.quantity.toString(0) != "3" || view.ask_levels.empty())) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    view = engine.latest();
+  }
+  CHECK(view.best_bid.price.toString(2) == "100.00");
+  CHECK(view.best_bid.quantity.toString(0) == "3");
+  CHECK(view.best_ask.price.toString(2) == "101.50");
+  engine.stop();
+}
+
+TEST_CASE("aggregator leaves a gapped book out of the view until it resyncs") {
+  hermeneutic::aggregator::AggregationEngine engine;
+  engine.start();
+  engine.push(makeNewOrder("steady", 1, Side::Bid, "100.00", "1", 1));
+  engine.push(makeNewOrder("gappy", 2, Side::Bid, "101.00", "2", 1));
+  engine.push(makeNewOrder("gappy", 3, Side::Bid, "102.00", "2", 3));
+
+  const auto await_view = [&](auto predicate) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+    auto view = engine.latest();
+    while (std::chrono::steady_clock::now() < deadline && !predicate(view)) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      view = engine.latest();
+    }
+    return view;
+  };
+  auto view = await_view([](const auto& v) { return v.best_bid.price.toString(2) == "100.00"; });
+  CHECK(view.best_bid.price.toString(2) == "100.00");
+  CHECK(view.bid_levels.size() == 1);
+  auto stats = engine.bookStats();
+  CHECK(stats["gappy"].stale);
+  CHECK(stats["gappy"].sequence_gaps == 1);
+  CHECK(!stats["steady"].stale);
+
+  hermeneutic::common::BookEvent snapshot;
+  snapshot.exchange = "gappy";
+  snapshot.kind = hermeneutic::common::BookEventKind::Snapshot;
+  snapshot.sequence = 2;
+  snapshot.snapshot.bids.push_back({Decimal::fromString("101.00"), Decimal::fromString("2")});
+  engine.push(snapshot);
+
+  view = await_view([](const auto& v) { return v.best_bid.price.toString(2) == "102.00"; });
+  CHECK(view.best_bid.price.toString(2) == "102.00");
+  CHECK(view.bid_levels.size() == 3);
+  stats = engine.bookStats();
+  CHECK(!stats["gappy"].stale);
+  CHECK(stats["gappy"].resyncs == 1);
+  engine.stop();
+}
+
+TEST_CASE("aggregator keeps separate books per symbol") {
+  hermeneutic::aggregator::AggregationEngine engine;
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<std::string> eth_best_bids;
+  engine.subscribe("ETHUSDT", [&](const hermeneutic::aggregator::BookSnapshot& view) {
+    std::lock_guard<std::mutex> lock(mutex);
+    eth_best_bids.push_back(view->best_bid.price.toString(2));
+    cv.notify_all();
+  });
+  engine.start();
+  auto eth = makeNewOrder("ex1", 1, Side::Bid, "2000.00", "1", 1);
+  eth.symbol = "ETHUSDT";
+  engine.push(makeNewOrder("ex1", 1, Side::Bid, "100.00", "1", 1));
+  engine.push(std::move(eth));
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    CHECK(cv.wait_for(lock, std::chrono::seconds(1), [&] { return !eth_best_bids.empty(); }));
+  }
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+  while (engine.latest().bid_levels.empty() && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+  engine.stop();
+
+  // The same exchange and sequence numbers on two symbols are two books.
+  CHECK(engine.latest().best_bid.price.toString(2) == "100.00");
+  CHECK(engine.latest("ETHUSDT").best_bid.price.toString(2) == "2000.00");
+  CHECK(engine.latest("ETHUSDT").exchange_count == 1);
+  CHECK(engine.latest("SOLUSDT").exchange_count == 0);
+  CHECK(engine.bookStats("ETHUSDT").count("ex1") == 1);
+  std::lock_guard<std::mutex> lock(mutex);
+  CHECK(eth_best_bids == std::vector<std::string>{"2000.00"});
+}
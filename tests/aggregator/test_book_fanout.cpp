@@ -0,0 +1,280 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "hermeneutic/aggregator/aggregator.hpp"
+#include "hermeneutic/aggregator/book_fanout.hpp"
+#include "services/common/grpc_helpers.hpp"
+#include "tests/support/test_data_factory.hpp"
+
+using hermeneutic::aggregator::AggregationEngine;
+using hermeneutic::aggregator::BookFanout;
+using hermeneutic::aggregator::BookFrame;
+using hermeneutic::tests::support::makeNewOrder;
+
+namespace {
+
+struct Collector {
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<std::shared_ptr<const BookFrame>> frames;
+
+  BookFanout::Listener listener() {
+    return [this](const std::shared_ptr<const BookFrame>& frame) {
+      std::lock_guard<std::mutex> lock(mutex);
+      frames.push_back(frame);
+      cv.notify_all();
+    };
+  }
+
+  bool waitFor(std::size_t count) {
+    std::unique_lock<std::mutex> lock(mutex);
+    return cv.wait_for(lock, std::chrono::seconds(2), [&] { return frames.size() >= count; });
+  }
+};
+
+template <typename Message>
+Message parse(const ::grpc::ByteBuffer& buffer) {
+  Message message;
+  ::grpc::ByteBuffer copy(buffer);
+  CHECK(::grpc::SerializationTraits<Message>::Deserialize(&copy, &message).ok());
+  return message;
+}
+
+}  // namespace
+
+TEST_CASE("book fanout hands every listener the same serialized frame") {
+  AggregationEngine engine;
+  engine.start();
+  BookFanout fanout(engine);
+  Collector first;
+  Collector second;
+  const auto first_id = fanout.add(first.listener());
+  const auto second_id = fanout.add(second.listener());
+
+  engine.push(makeNewOrder("ex1", 1, hermeneutic::common::Side::Bid, "100.00", "2", 1));
+  engine.push(makeNewOrder("ex1", 2, hermeneutic::common::Side::Ask, "101.00", "1", 2));
+  CHECK(first.waitFor(2));
+  CHECK(second.waitFor(2));
+  fanout.remove(first_id);
+  fanout.remove(second_id);
+  engine.stop();
+
+  std::lock_guard<std::mutex> first_lock(first.mutex);
+  std::lock_guard<std::mutex> second_lock(second.mutex);
+  CHECK(first.frames.size() == 2);
+  CHECK(second.frames.size() == 2);
+  if (first.frames.size() == 2 && second.frames.size() == 2) {
+    CHECK(first.frames[0] == second.frames[0]);
+    const auto& frame = *first.frames[1];
+    CHECK(frame.sequence() == first.frames[0]->sequence() + 1);
+    // Payloads are built once and then shared.
+    const auto encoding = hermeneutic::grpc::BOOK_ENCODING_FIXED_POINT;
+    CHECK(&frame.book(encoding) == &second.frames[1]->book(encoding));
+
+    const auto book = parse<hermeneutic::grpc::AggregatedBook>(frame.book(encoding));
+    CHECK(book.fixed().best_size() == 4);
+    const auto delta = parse<hermeneutic::grpc::BookUpdate>(frame.deltaUpdate(encoding));
+    CHECK(!delta.snapshot());
+    CHECK(delta.sequence() == frame.sequence());
+    CHECK(delta.deltas_size() == 1);
+    const auto snapshot = parse<hermeneutic::grpc::BookUpdate>(frame.snapshotUpdate(encoding));
+    CHECK(snapshot.snapshot());
+    CHECK(snapshot.book().fixed().ask_levels_size() == 2);
+  }
+}
+
+TEST_CASE("book fanout seeds late listeners with the current book") {
+  AggregationEngine engine;
+  engine.start();
+  engine.push(makeNewOrder("ex1", 1, hermeneutic::common::Side::Bid, "100.00", "2", 1));
+  engine.push(makeNewOrder("ex1", 2, hermeneutic::common::Side::Ask, "101.00", "1", 2));
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (engine.latest().ask_levels.empty() && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+
+  BookFanout fanout(engine);
+  Collector first;
+  Collector second;
+  const auto first_id = fanout.add(first.listener());
+  const auto second_id = fanout.add(second.listener());
+  fanout.remove(first_id);
+  fanout.remove(second_id);
+  engine.stop();
+
+  std::lock_guard<std::mutex> first_lock(first.mutex);
+  std::lock_guard<std::mutex> second_lock(second.mutex);
+  CHECK(first.frames.size() == 1);
+  CHECK(second.frames.size() == 1);
+  if (first.frames.size() == 1 && second.frames.size() == 1) {
+    CHECK(first.frames[0] == second.frames[0]);
+    CHECK(first.frames[0]->view().bid_levels.size() == 1);
+    CHECK(first.frames[0]->view().ask_levels.size() == 1);
+    // Nothing to diff against yet, so deltas degrade to a snapshot.
+    const auto encoding = hermeneutic::grpc::BOOK_ENCODING_FIXED_POINT;
+    CHECK(parse<hermeneutic::grpc::BookUpdate>(first.frames[0]->deltaUpdate(encoding)).snapshot());
+  }
+}
+
+TEST_CASE("book fanout listeners may add and remove listeners while handling a frame") {
+  AggregationEngine engine;
+  engine.start();
+  BookFanout fanout(engine);
+  Collector late;
+  std::atomic<bool> reacted{false};
+  std::atomic<BookFanout::ListenerId> self{0};
+  std::atomic<BookFanout::ListenerId> late_id{0};
+  // Frames are delivered outside the fanout lock, so a listener reacting
+  // inline (as a gRPC stream may) can call back into the fanout.
+  self = fanout.add([&](const std::shared_ptr<const BookFrame>&) {
+    if (!reacted.exchange(true)) {
+      late_id = fanout.add(late.listener());
+      fanout.remove(self);
+    }
+  });
+
+  engine.push(makeNewOrder("ex1", 1, hermeneutic::common::Side::Bid, "100.00", "2", 1));
+  CHECK(late.waitFor(1));
+  engine.push(makeNewOrder("ex1", 2, hermeneutic::common::Side::Ask, "101.00", "1", 2));
+  CHECK(late.waitFor(2));
+  fanout.remove(late_id);
+  engine.stop();
+
+  std::lock_guard<std::mutex> lock(late.mutex);
+  CHECK(late.frames.size() == 2);
+  if (late.frames.size() == 2) {
+    CHECK(late.frames[1]->sequence() == late.frames[0]->sequence() + 1);
+  }
+}
+
+TEST_CASE("book fanout does not seed listeners before the engine is ready") {
+  AggregationEngine engine;
+  engine.setExpectedExchanges({"ex1", "ex2"});
+  engine.start();
+  engine.push(makeNewOrder("ex1", 1, hermeneutic::common::Side::Bid, "100.00", "2", 1));
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (engine.latest().bid_levels.empty() && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  CHECK(!engine.ready(""));
+
+  BookFanout fanout(engine);
+  Collector collector;
+  const auto id = fanout.add(collector.listener());
+  {
+    std::lock_guard<std::mutex> lock(collector.mutex);
+    CHECK(collector.frames.empty());
+  }
+  engine.push(makeNewOrder("ex2", 2, hermeneutic::common::Side::Ask, "101.00", "1", 1));
+  CHECK(collector.waitFor(1));
+  fanout.remove(id);
+  engine.stop();
+
+  std::lock_guard<std::mutex> lock(collector.mutex);
+  CHECK(collector.frames.size() == 1);
+  if (!collector.frames.empty()) {
+    CHECK(collector.frames[0]->view().exchange_count == 2);
+  }
+}
+
+TEST_CASE("frame queue applies the slow consumer policy") {
+  using hermeneutic::aggregator::FrameQueue;
+  using hermeneutic::aggregator::SlowConsumerPolicy;
+  auto view = std::make_shared<const hermeneutic::common::AggregatedBookView>();
+  auto frame = [&](std::uint64_t sequence) { return std::make_shared<const BookFrame>(sequence, view, nullptr); };
+
+  FrameQueue drop_oldest({.max_pending = 2, .slow_consumer = SlowConsumerPolicy::DropOldest});
+  for (std::uint64_t sequence = 1; sequence <= 4; ++sequence) {
+    CHECK(drop_oldest.push(frame(sequence)));
+  }
+  CHECK(drop_oldest.stats().lag == 2);
+  CHECK(drop_oldest.stats().dropped == 2);
+  CHECK(drop_oldest.pop()->sequence() == 3);
+  CHECK(drop_oldest.pop()->sequence() == 4);
+  CHECK(drop_oldest.pop() == nullptr);
+  CHECK(drop_oldest.stats().sent == 2);
+  CHECK(drop_oldest.stats().max_lag == 2);
+
+  FrameQueue conflate({.max_pending = 8, .slow_consumer = SlowConsumerPolicy::Conflate});
+  for (std::uint64_t sequence = 1; sequence <= 3; ++sequence) {
+    CHECK(conflate.push(frame(sequence)));
+  }
+  CHECK(conflate.stats().lag == 1);
+  CHECK(conflate.stats().dropped == 2);
+  CHECK(conflate.pop()->sequence() == 3);
+
+  FrameQueue disconnect({.max_pending = 2, .slow_consumer = SlowConsumerPolicy::Disconnect});
+  CHECK(disconnect.push(frame(1)));
+  CHECK(disconnect.push(frame(2)));
+  CHECK(!disconnect.push(frame(3)));
+  CHECK(disconnect.stats().lag == 2);
+  disconnect.clear();
+  CHECK(disconnect.empty());
+  CHECK(disconnect.stats().dropped == 2);
+}
+
+TEST_CASE("book frames trim ladders per filter and share the trimmed payloads") {
+  using hermeneutic::aggregator::BookFilter;
+  using hermeneutic::common::Decimal;
+  auto level = [](const char* price) {
+    return hermeneutic::common::PriceLevel{Decimal::fromString(price), Decimal::fromInteger(1)};
+  };
+  auto previous = std::make_shared<hermeneutic::common::AggregatedBookView>();
+  previous->bid_levels = {level("100"), level("99.5"), level("98")};
+  previous->ask_levels = {level("101"), level("101.5"), level("110")};
+  auto current = std::make_shared<hermeneutic::common::AggregatedBookView>(*previous);
+  // Only the 98 bid changes: outside both filters below, so no deltas.
+  current->bid_levels[2].quantity = Decimal::fromInteger(5);
+  current->ask_levels.insert(current->ask_levels.begin() + 1, level("101.2"));
+
+  const auto window = hermeneutic::aggregator::filterBook(*current, BookFilter{.window_bps = 100});
+  CHECK(window.bid_levels.size() == 2);
+  CHECK(window.ask_levels.size() == 3);
+  const auto both = hermeneutic::aggregator::filterBook(*current, BookFilter{.max_depth = 2, .window_bps = 100});
+  CHECK(both.bid_levels.size() == 2);
+  CHECK(both.ask_levels.size() == 2);
+
+  BookFrame frame(2, current, previous);
+  const auto encoding = hermeneutic::grpc::BOOK_ENCODING_FIXED_POINT;
+  const BookFilter top{.max_depth = 1};
+  CHECK(&frame.book(encoding, top) == &frame.book(encoding, BookFilter{.max_depth = 1}));
+  CHECK(&frame.book(encoding, top) != &frame.book(encoding));
+  const auto book = parse<hermeneutic::grpc::AggregatedBook>(frame.book(encoding, top));
+  CHECK(book.fixed().bid_levels_size() == 2);
+  CHECK(book.fixed().ask_levels_size() == 2);
+
+  const auto top_delta = parse<hermeneutic::grpc::BookUpdate>(frame.deltaUpdate(encoding, top));
+  CHECK(!top_delta.snapshot());
+  CHECK(top_delta.deltas_size() == 0);
+  const auto window_delta =
+      parse<hermeneutic::grpc::BookUpdate>(frame.deltaUpdate(encoding, BookFilter{.window_bps = 100}));
+  CHECK(window_delta.deltas_size() == 1);
+  if (window_delta.deltas_size() == 1) {
+    CHECK(window_delta.deltas(0).action() == hermeneutic::grpc::LEVEL_ACTION_INSERT);
+    CHECK(window_delta.deltas(0).price() == 10120000000);
+  }
+  const auto full_delta = parse<hermeneutic::grpc::BookUpdate>(frame.deltaUpdate(encoding));
+  CHECK(full_delta.deltas_size() == 2);
+}
+
+TEST_CASE("book frames fall back to decimal strings when fixed point overflows") {
+  using hermeneutic::common::Decimal;
+  auto view = std::make_shared<hermeneutic::common::AggregatedBookView>();
+  // 10^12 at eight decimals is beyond a 64-bit count.
+  view->bid_levels = {{Decimal::fromString("1000000000000"), Decimal::fromInteger(1)}};
+  view->best_bid = {view->bid_levels[0].price, view->bid_levels[0].quantity};
+  BookFrame frame(1, view, nullptr);
+  const auto book = parse<hermeneutic::grpc::AggregatedBook>(frame.book(hermeneutic::grpc::BOOK_ENCODING_FIXED_POINT));
+  CHECK(!book.has_fixed());
+  const auto round_trip = hermeneutic::services::grpc_helpers::ToDomain(book);
+  CHECK(round_trip.bid_levels.size() == 1);
+  CHECK(round_trip.best_bid.price == view->best_bid.price);
+}
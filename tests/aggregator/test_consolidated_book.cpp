@@ -0,0 +1,91 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <vector>
+
+#include "hermeneutic/aggregator/consolidated_book.hpp"
+#include "hermeneutic/lob/order_book.hpp"
+#include "tests/support/test_data_factory.hpp"
+
+using hermeneutic::aggregator::ConsolidatedBook;
+using hermeneutic::common::BookEvent;
+using hermeneutic::common::BookEventKind;
+using hermeneutic::common::Decimal;
+using hermeneutic::common::PriceLevel;
+using hermeneutic::common::Side;
+using hermeneutic::lob::LevelDeltas;
+using hermeneutic::lob::LimitOrderBook;
+using hermeneutic::tests::support::makeNewOrder;
+
+namespace {
+
+void applyTo(LimitOrderBook& book, ConsolidatedBook& ladder, const BookEvent& event) {
+  LevelDeltas deltas;
+  book.apply(event, deltas);
+  ladder.apply(deltas);
+}
+
+}  // namespace
+
+TEST_CASE("consolidated book sums levels across exchanges") {
+  LimitOrderBook ex1;
+  LimitOrderBook ex2;
+  ConsolidatedBook ladder;
+  applyTo(ex1, ladder, makeNewOrder("ex1", 1, Side::Bid, "100.00", "1", 1));
+  applyTo(ex2, ladder, makeNewOrder("ex2", 1, Side::Bid, "100.00", "3", 1));
+  applyTo(ex2, ladder, makeNewOrder("ex2", 2, Side::Ask, "101.00", "2", 2));
+
+  std::vector<PriceLevel> bids;
+  std::vector<PriceLevel> asks;
+  ladder.materialize(bids, asks);
+  CHECK(bids.size() == 1);
+  CHECK(bids[0].quantity.toString(0) == "4");
+  CHECK(ladder.bids().begin()->second.sources == 2);
+  CHECK(asks.size() == 1);
+  CHECK(asks[0].price.toString(2) == "101.00");
+}
+
+TEST_CASE("consolidated book drops a level once every source leaves") {
+  LimitOrderBook ex1;
+  LimitOrderBook ex2;
+  ConsolidatedBook ladder;
+  applyTo(ex1, ladder, makeNewOrder("ex1", 1, Side::Bid, "100.00", "1", 1));
+  applyTo(ex2, ladder, makeNewOrder("ex2", 7, Side::Bid, "100.00", "2", 1));
+
+  BookEvent cancel;
+  cancel.exchange = "ex1";
+  cancel.kind = BookEventKind::CancelOrder;
+  cancel.sequence = 2;
+  cancel.order.order_id = 1;
+  applyTo(ex1, ladder, cancel);
+  CHECK(ladder.bids().size() == 1);
+  CHECK(ladder.bids().begin()->second.quantity.toString(0) == "2");
+  CHECK(ladder.bids().begin()->second.sources == 1);
+
+  cancel.exchange = "ex2";
+  cancel.order.order_id = 7;
+  applyTo(ex2, ladder, cancel);
+  CHECK(ladder.empty());
+}
+
+TEST_CASE("consolidated book tracks snapshot replacement") {
+  LimitOrderBook ex1;
+  ConsolidatedBook ladder;
+  applyTo(ex1, ladder, makeNewOrder("ex1", 1, Side::Bid, "99.00", "1", 1));
+
+  BookEvent snapshot;
+  snapshot.exchange = "ex1";
+  snapshot.kind = BookEventKind::Snapshot;
+  snapshot.sequence = 2;
+  snapshot.snapshot.bids.push_back({Decimal::fromString("98.00"), Decimal::fromString("5")});
+  snapshot.snapshot.asks.push_back({Decimal::fromString("102.00"), Decimal::fromString("1")});
+  applyTo(ex1, ladder, snapshot);
+
+  std::vector<PriceLevel> bids;
+  std::vector<PriceLevel> asks;
+  ladder.materialize(bids, asks);
+  CHECK(bids.size() == 1);
+  CHECK(bids[0].price.toString(2) == "98.00");
+  CHECK(asks.size() == 1);
+  CHECK(asks[0].price.toString(2) == "102.00");
+}
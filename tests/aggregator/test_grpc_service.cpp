@@ -3,13 +3,16 @@
 
 #include <chrono>
 #include <memory>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include <grpcpp/grpcpp.h>
 
 #include "aggregator.grpc.pb.h"
 #include "hermeneutic/aggregator/aggregator.hpp"
 #include "hermeneutic/aggregator/grpc_service.hpp"
+#include "hermeneutic/aggregator/sharded_aggregator.hpp"
 #include "hermeneutic/common/events.hpp"
 #include "tests/support/test_data_factory.hpp"
 
@@ -128,3 +131,150 @@ TEST_CASE("Aggregator gRPC service streams snapshots for authorized clients") {
 
   engine.stop();
 }
+
+TEST_CASE("Aggregator gRPC service streams a snapshot then level deltas") {
+  AggregationEngine engine;
+  engine.start();
+  AggregatorGrpcService service(engine, "secret-token", "BTCUSDT");
+  std::shared_ptr<grpc::Channel> channel;
+  auto server = startServer(service, channel);
+  auto stub = makeStub(channel);
+
+  grpc::ClientContext ctx;
+  ctx.AddMetadata("authorization", "Bearer secret-token");
+  ctx.set_deadline(std::chrono::system_clock::now() + std::chrono::seconds(2));
+  hermeneutic::grpc::SubscribeRequest request;
+  request.set_encoding(hermeneutic::grpc::BOOK_ENCODING_FIXED_POINT);
+  auto reader = stub->StreamBookUpdates(&ctx, request);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  engine.push(makeNewOrder("ex1", 1, hermeneutic::common::Side::Bid, "100.00", "2", 1,
+                           timeFromNanoseconds(10)));
+  engine.push(makeNewOrder("ex2", 2, hermeneutic::common::Side::Ask, "101.00", "1", 1,
+                           timeFromNanoseconds(20)));
+  engine.push(makeNewOrder("ex1", 3, hermeneutic::common::Side::Bid, "99.00", "1", 2,
+                           timeFromNanoseconds(30)));
+
+  std::vector<hermeneutic::grpc::BookUpdate> updates;
+  hermeneutic::grpc::BookUpdate update;
+  while (updates.size() < 3 && reader->Read(&update)) {
+    updates.push_back(update);
+  }
+  const auto subscribers = service.subscriberStats();
+  ctx.TryCancel();
+  reader->Finish();
+  shutdownServer(server);
+  engine.stop();
+
+  CHECK(subscribers.size() == 1);
+  if (subscribers.size() == 1) {
+    CHECK(subscribers[0].method == "StreamBookUpdates");
+    CHECK(subscribers[0].stream.sent >= 3);
+    CHECK(subscribers[0].stream.dropped == 0);
+    CHECK(subscribers[0].stream.resyncs == 0);
+  }
+  CHECK(service.subscriberStats().empty());
+  CHECK(updates.size() == 3);
+  if (updates.size() == 3) {
+    CHECK(updates[0].sequence() == 1);
+    CHECK(updates[0].snapshot());
+    CHECK(updates[0].book().fixed().bid_levels_size() == 2);
+    CHECK(updates[1].sequence() == 2);
+    CHECK(!updates[1].snapshot());
+    CHECK(updates[1].deltas_size() == 1);
+    CHECK(updates[1].deltas(0).side() == hermeneutic::grpc::BOOK_SIDE_ASK);
+    CHECK(updates[1].deltas(0).action() == hermeneutic::grpc::LEVEL_ACTION_INSERT);
+    CHECK(updates[2].deltas_size() == 1);
+    CHECK(updates[2].deltas(0).price() == 9900000000);
+    CHECK(updates[2].book().fixed().best(0) == 10000000000);
+    CHECK(updates[2].book().fixed().bid_levels_size() == 0);
+  }
+}
+
+TEST_CASE("Aggregator gRPC service trims depth per subscription") {
+  AggregationEngine engine;
+  engine.start();
+  AggregatorGrpcService service(engine, "secret-token", "BTCUSDT");
+  std::shared_ptr<grpc::Channel> channel;
+  auto server = startServer(service, channel);
+  auto stub = makeStub(channel);
+
+  grpc::ClientContext ctx;
+  ctx.AddMetadata("authorization", "Bearer secret-token");
+  ctx.set_deadline(std::chrono::system_clock::now() + std::chrono::seconds(2));
+  hermeneutic::grpc::SubscribeRequest request;
+  request.set_max_depth(1);
+  auto reader = stub->StreamBooks(&ctx, request);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  engine.push(makeNewOrder("ex1", 1, hermeneutic::common::Side::Bid, "100.00", "2", 1,
+                           timeFromNanoseconds(10)));
+  engine.push(makeNewOrder("ex1", 2, hermeneutic::common::Side::Bid, "99.00", "1", 2,
+                           timeFromNanoseconds(20)));
+
+  hermeneutic::grpc::AggregatedBook book;
+  bool deep = false;
+  int received = 0;
+  while (received < 2 && reader->Read(&book)) {
+    ++received;
+    deep = deep || book.bid_levels_size() > 1;
+  }
+  ctx.TryCancel();
+  reader->Finish();
+  shutdownServer(server);
+  engine.stop();
+
+  CHECK(received == 2);
+  CHECK(!deep);
+  CHECK(book.bid_levels_size() == 1);
+  CHECK(book.best_bid().price() == "100.00000000");
+}
+
+TEST_CASE("Aggregator gRPC service serves every configured symbol") {
+  hermeneutic::aggregator::ShardedAggregator aggregator(2);
+  aggregator.start();
+  AggregatorGrpcService service(aggregator, "secret-token", {"BTCUSDT", "ETHUSDT"});
+  std::shared_ptr<grpc::Channel> channel;
+  auto server = startServer(service, channel);
+  auto stub = makeStub(channel);
+
+  auto btc = makeNewOrder("ex1", 1, hermeneutic::common::Side::Bid, "100.00", "1", 1);
+  btc.symbol = "BTCUSDT";
+  auto eth = makeNewOrder("ex1", 1, hermeneutic::common::Side::Bid, "2000.00", "1", 1);
+  eth.symbol = "ETHUSDT";
+  aggregator.push(std::move(btc));
+  aggregator.push(std::move(eth));
+
+  auto firstBook = [&](const std::string& symbol, hermeneutic::grpc::AggregatedBook& book) {
+    grpc::ClientContext ctx;
+    ctx.AddMetadata("authorization", "Bearer secret-token");
+    ctx.set_deadline(std::chrono::system_clock::now() + std::chrono::seconds(2));
+    hermeneutic::grpc::SubscribeRequest request;
+    request.set_symbol(symbol);
+    auto reader = stub->StreamBooks(&ctx, request);
+    const bool received = reader->Read(&book);
+    if (received) {
+      ctx.TryCancel();
+    }
+    const auto status = reader->Finish();
+    return received ? grpc::Status::OK : status;
+  };
+  hermeneutic::grpc::AggregatedBook btc_book;
+  hermeneutic::grpc::AggregatedBook eth_book;
+  hermeneutic::grpc::AggregatedBook default_book;
+  hermeneutic::grpc::AggregatedBook unknown_book;
+  const auto btc_status = firstBook("BTCUSDT", btc_book);
+  const auto eth_status = firstBook("ETHUSDT", eth_book);
+  const auto default_status = firstBook("", default_book);
+  const auto unknown_status = firstBook("SOLUSDT", unknown_book);
+  shutdownServer(server);
+  aggregator.stop();
+
+  CHECK(btc_status.ok());
+  CHECK(btc_book.best_bid().price() == "100.00000000");
+  CHECK(eth_status.ok());
+  CHECK(eth_book.best_bid().price() == "2000.00000000");
+  CHECK(default_status.ok());
+  CHECK(default_book.best_bid().price() == "100.00000000");
+  CHECK(unknown_status.error_code() == grpc::StatusCode::INVALID_ARGUMENT);
+}
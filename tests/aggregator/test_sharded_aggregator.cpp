@@ -0,0 +1,78 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hermeneutic/aggregator/sharded_aggregator.hpp"
+#include "hermeneutic/common/events.hpp"
+#include "tests/support/test_data_factory.hpp"
+
+using hermeneutic::aggregator::ShardedAggregator;
+using hermeneutic::common::Side;
+using hermeneutic::tests::support::makeNewOrder;
+
+TEST_CASE("sharded aggregator routes each symbol to one shard") {
+  ShardedAggregator aggregator(4);
+  CHECK(aggregator.shardCount() == 4);
+  std::set<std::size_t> used;
+  for (int i = 0; i < 64; ++i) {
+    const auto symbol = "SYM" + std::to_string(i);
+    CHECK(aggregator.shardIndex(symbol) == aggregator.shardIndex(symbol));
+    CHECK(&aggregator.engineFor(symbol) == &aggregator.engineFor(symbol));
+    used.insert(aggregator.shardIndex(symbol));
+  }
+  CHECK(used.size() == 4);
+}
+
+TEST_CASE("sharded aggregator consolidates every symbol on its own shard") {
+  ShardedAggregator aggregator(3);
+  const std::vector<std::string> symbols = {"BTCUSDT", "ETHUSDT", "SOLUSDT", "XRPUSDT", "ADAUSDT"};
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::map<std::string, std::string> best_bids;
+  std::map<std::string, std::set<std::thread::id>> threads;
+  for (const auto& symbol : symbols) {
+    aggregator.engineFor(symbol).subscribe(symbol, [&, symbol](const hermeneutic::aggregator::BookSnapshot& view) {
+      std::lock_guard<std::mutex> lock(mutex);
+      best_bids[symbol] = view->best_bid.price.toString(0);
+      threads[symbol].insert(std::this_thread::get_id());
+      cv.notify_all();
+    });
+  }
+  aggregator.start();
+  for (std::uint64_t order = 1; order <= 20; ++order) {
+    for (std::size_t i = 0; i < symbols.size(); ++i) {
+      auto event = makeNewOrder("ex1", order, Side::Bid, std::to_string(100 * (i + 1) + order), "1", order);
+      event.symbol = symbols[i];
+      aggregator.push(std::move(event));
+    }
+  }
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    CHECK(cv.wait_for(lock, std::chrono::seconds(2), [&] {
+      for (std::size_t i = 0; i < symbols.size(); ++i) {
+        auto it = best_bids.find(symbols[i]);
+        if (it == best_bids.end() || it->second != std::to_string(100 * (i + 1) + 20)) {
+          return false;
+        }
+      }
+      return true;
+    }));
+  }
+  aggregator.stop();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  for (std::size_t i = 0; i < symbols.size(); ++i) {
+    CAPTURE(symbols[i]);
+    CHECK(aggregator.engineFor(symbols[i]).latest(symbols[i]).bid_levels.size() == 20);
+    // Each symbol is published by its shard's single publisher thread.
+    CHECK(threads[symbols[i]].size() == 1);
+  }
+}
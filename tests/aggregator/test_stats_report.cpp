@@ -0,0 +1,89 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "tests/include/doctest_config.hpp"
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <spdlog/sinks/ostream_sink.h>
+#include <spdlog/spdlog.h>
+
+#include "services/aggregator_service/stats_report.hpp"
+
+using hermeneutic::aggregator::StreamStats;
+using hermeneutic::aggregator::SubscriberStats;
+using hermeneutic::lob::BookStats;
+using hermeneutic::services::aggregator_service::StatsReporter;
+
+namespace {
+
+struct ScopedLogCapture {
+  ScopedLogCapture() {
+    auto sink = std::make_shared<spdlog::sinks::ostream_sink_mt>(stream);
+    auto logger = std::make_shared<spdlog::logger>("test-stats", sink);
+    logger->set_pattern("%v");
+    previous = spdlog::default_logger();
+    spdlog::set_default_logger(logger);
+  }
+
+  ~ScopedLogCapture() { spdlog::set_default_logger(previous); }
+
+  std::ostringstream stream;
+  std::shared_ptr<spdlog::logger> previous;
+};
+
+}  // namespace
+
+TEST_CASE("stats reporter logs books whose sequence counters moved") {
+  ScopedLogCapture logs;
+  StatsReporter reporter;
+  std::unordered_map<std::string, BookStats> books{{"cex-a", BookStats{}}, {"cex-b", BookStats{}}};
+  CHECK(reporter.reportBooks("BTCUSDT", books) == 0);
+
+  books["cex-a"].sequence_gaps = 1;
+  books["cex-a"].stale = true;
+  books["cex-a"].buffered_events = 3;
+  CHECK(reporter.reportBooks("BTCUSDT", books) == 1);
+  CHECK(logs.stream.str().find("Book BTCUSDT/cex-a: 1 sequence gaps") != std::string::npos);
+  CHECK(logs.stream.str().find("stale") != std::string::npos);
+
+  // Still stale: reported again even though no counter moved.
+  CHECK(reporter.reportBooks("BTCUSDT", books) == 1);
+
+  books["cex-a"].stale = false;
+  books["cex-a"].resyncs = 1;
+  books["cex-a"].last_resync_ns = 2'000'000;
+  books["cex-a"].max_resync_ns = 2'000'000;
+  CHECK(reporter.reportBooks("BTCUSDT", books) == 1);
+  CHECK(logs.stream.str().find("1 resyncs (last 2000 us") != std::string::npos);
+  CHECK(reporter.reportBooks("BTCUSDT", books) == 0);
+  // The same exchange under another symbol is tracked separately.
+  CHECK(reporter.reportBooks("ETHUSDT", books) == 1);
+}
+
+TEST_CASE("stats reporter logs subscribers that dropped books or fell further behind") {
+  ScopedLogCapture logs;
+  StatsReporter reporter;
+  std::vector<SubscriberStats> subscribers{
+      {"ipv4:10.0.0.1:5000", "StreamBookUpdates", "BTCUSDT", StreamStats{}},
+      {"ipv4:10.0.0.2:5000", "StreamBooks", "", StreamStats{}},
+  };
+  CHECK(reporter.reportSubscribers(subscribers) == 0);
+
+  subscribers[0].stream = {.lag = 2, .max_lag = 64, .sent = 100, .dropped = 5, .resyncs = 1};
+  subscribers[1].stream.sent = 100;
+  CHECK(reporter.reportSubscribers(subscribers) == 1);
+  CHECK(logs.stream.str().find("Subscriber ipv4:10.0.0.1:5000 StreamBookUpdates BTCUSDT: lag 2 (max 64), 100 sent, "
+                               "5 dropped, 1 snapshot resyncs") != std::string::npos);
+  CHECK(reporter.reportSubscribers(subscribers) == 0);
+
+  // A reconnect from the same peer starts from zero again.
+  subscribers.erase(subscribers.begin());
+  CHECK(reporter.reportSubscribers(subscribers) == 0);
+  subscribers.push_back({"ipv4:10.0.0.1:5000", "StreamBookUpdates", "BTCUSDT", {.max_lag = 1, .sent = 1}});
+  CHECK(reporter.reportSubscribers(subscribers) == 1);
+}
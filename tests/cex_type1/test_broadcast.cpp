@@ -0,0 +1,100 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "tests/include/doctest_config.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "services/cex_type1_service/broadcast.hpp"
+
+using hermeneutic::services::cex_type1_service::FrameBroadcaster;
+using hermeneutic::services::cex_type1_service::LogCursor;
+using hermeneutic::services::cex_type1_service::PacingOptions;
+using hermeneutic::services::cex_type1_service::PayloadLog;
+
+namespace {
+PayloadLog makeLog(int lines) {
+  std::string data;
+  for (int i = 1; i <= lines; ++i) {
+    data += "{\"sequence\":" + std::to_string(i) + "}\n";
+  }
+  return PayloadLog::fromString(std::move(data));
+}
+}  // namespace
+
+TEST_CASE("log cursors replay independently from the start sequence") {
+  const auto log = PayloadLog::fromString("{\"sequence\":1}\n{\"sequence\":2}\n{\"sequence\":3}\n", 2);
+  LogCursor first(log);
+  LogCursor second(log);
+  CHECK(first.next() == 1);
+  CHECK(first.next() == 2);
+  CHECK(first.next() == 0);  // later passes start from the top
+  CHECK(first.next() == 1);
+  CHECK(second.next() == 1);
+}
+
+TEST_CASE("broadcaster hands every subscriber the same frames") {
+  const auto log = makeLog(5);
+  // Paced, so neither reader can fall a ring behind however slowly it starts.
+  FrameBroadcaster broadcaster(log, PacingOptions{.interval = std::chrono::milliseconds(1)}, false);
+  auto first = broadcaster.subscribe();
+  auto second = broadcaster.subscribe();
+  CHECK(first == second);
+  broadcaster.start();
+
+  std::uint64_t skipped = 0;
+  std::vector<FrameBroadcaster::Frame> seen_first;
+  std::vector<FrameBroadcaster::Frame> seen_second;
+  std::thread reader([&] {
+    std::uint64_t reader_skipped = 0;
+    for (int i = 0; i < 8; ++i) {
+      seen_second.push_back(broadcaster.next(second, reader_skipped));
+    }
+  });
+  for (int i = 0; i < 8; ++i) {
+    seen_first.push_back(broadcaster.next(first, skipped));
+  }
+  reader.join();
+  broadcaster.stop();
+
+  REQUIRE(seen_first.size() == 8);
+  REQUIRE(seen_second.size() == 8);
+  for (std::size_t i = 0; i < seen_first.size(); ++i) {
+    CAPTURE(i);
+    REQUIRE(static_cast<bool>(seen_first[i]));
+    // Unstamped frames are served straight out of the log.
+    CHECK(seen_first[i].stamped == nullptr);
+    CHECK(seen_first[i].payload.data() == log.line(i % log.size()).data());
+    CHECK(seen_second[i].payload.data() == seen_first[i].payload.data());
+  }
+  CHECK(skipped == 0);
+}
+
+TEST_CASE("broadcaster skips lagging subscribers ahead and stamps frames") {
+  const auto log = makeLog(3);
+  FrameBroadcaster broadcaster(log, PacingOptions{}, true, 4);
+  auto fast = broadcaster.subscribe();
+  auto slow = broadcaster.subscribe();
+  broadcaster.start();
+
+  std::uint64_t skipped = 0;
+  for (int i = 0; i < 64; ++i) {
+    REQUIRE(static_cast<bool>(broadcaster.next(fast, skipped)));
+  }
+  std::uint64_t slow_skipped = 0;
+  const auto frame = broadcaster.next(slow, slow_skipped);
+  REQUIRE(static_cast<bool>(frame));
+  REQUIRE(frame.stamped != nullptr);
+  CHECK(frame.payload.data() == frame.stamped->data());
+  CHECK(slow_skipped > 0);
+  CHECK(frame.payload.find(",\"timestamp_ns\":") != std::string_view::npos);
+  CHECK(frame.payload.back() == '}');
+
+  broadcaster.stop();
+  CHECK(!broadcaster.next(slow, slow_skipped));
+}
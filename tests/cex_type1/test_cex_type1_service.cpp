@@ -6,14 +6,17 @@
 #include <Poco/Net/StreamSocket.h>
 #include <Poco/Process.h>
 
+#include <algorithm>
 #include <chrono>
 #include <condition_variable>
 #include <csignal>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "hermeneutic/cex_type1/feed.hpp"
@@ -36,6 +39,20 @@ bool canBindLoopback() {
   }
 }
 
+bool waitForServer(Poco::UInt16 port, int attempts) {
+  for (int i = 0; i < attempts; ++i) {
+    try {
+      Poco::Net::StreamSocket probe;
+      probe.connect(Poco::Net::SocketAddress("127.0.0.1", port));
+      probe.close();
+      return true;
+    } catch (...) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    }
+  }
+  return false;
+}
+
 }  // namespace
 
 TEST_CASE("cex_type1_service/executable streams payloads") {
@@ -109,21 +126,7 @@ std::vector<std::string> args = {
   std::condition_variable cv;
   std::vector<hermeneutic::common::BookEvent> received_events;
 
-  auto waitForServer = [&](int attempts) {
-    for (int i = 0; i < attempts; ++i) {
-      try {
-        Poco::Net::StreamSocket probe;
-        probe.connect(Poco::Net::SocketAddress("127.0.0.1", port));
-        probe.close();
-        return true;
-      } catch (...) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(40));
-      }
-    }
-    return false;
-  };
-
-  if (!waitForServer(125)) {
+  if (!waitForServer(port, 125)) {
     cleanup();
     std::cerr << "cex_type1_service did not accept connections in time" << std::endl;
     CHECK(false);
@@ -135,9 +138,9 @@ std::vector<std::string> args = {
        .url = "ws://127.0.0.1:" + std::to_string(port) + "/" + exchange,
        .auth_token = token,
        .interval = 20ms},
-      [&](hermeneutic::common::BookEvent update) {
+      [&](const hermeneutic::common::BookEvent& update) {
         std::lock_guard<std::mutex> lock(mutex);
-        received_events.push_back(std::move(update));
+        received_events.push_back(update);
         cv.notify_one();
       });
 
@@ -176,3 +179,89 @@ std::vector<std::string> args = {
   CHECK(target->order.price == hermeneutic::common::Decimal::fromString("101.50"));
   CHECK(target->order.quantity == hermeneutic::common::Decimal::fromString("0.4"));
 }
+
+TEST_CASE("cex_type1_service/executable serves more clients than the default thread pool") {
+  using namespace std::chrono_literals;
+  // Poco's default pool stops at 16 threads, and each client holds one.
+  constexpr std::size_t kClients = 20;
+  if (!canBindLoopback()) {
+    return;
+  }
+
+  auto service_binary = findCexServiceBinary();
+  if (!std::filesystem::exists(service_binary)) {
+    std::cerr << "Skipping cex_type1_service test: " << service_binary << " missing" << std::endl;
+    return;
+  }
+
+  std::signal(SIGPIPE, SIG_IGN);
+
+  auto temp_file = std::filesystem::temp_directory_path() / "cex_type1_service_clients_test.ndjson";
+  {
+    std::ofstream out(temp_file);
+    out << "{\"type\":\"new_order\",\"sequence\":1,\"order_id\":101,\"side\":\"bid\",\"price\":\"90.25\",\"quantity\":\"1.5\"}" << std::endl;
+  }
+
+  Poco::UInt16 port = 0;
+  {
+    Poco::Net::ServerSocket probe(Poco::Net::SocketAddress("127.0.0.1", 0));
+    port = probe.address().port();
+  }
+
+  const std::string exchange = "svc-clients";
+  const std::string token = "svc-token";
+  std::vector<std::string> args = {
+      exchange, temp_file.string(), std::to_string(port), token, "10", "--max-clients", std::to_string(kClients + 4),
+  };
+  auto handle = Poco::Process::launch(service_binary.string(), args);
+  auto cleanup = [&]() {
+    try {
+      Poco::Process::kill(handle);
+    } catch (...) {
+    }
+    try {
+      handle.wait();
+    } catch (...) {
+    }
+    std::filesystem::remove(temp_file);
+  };
+
+  if (!waitForServer(port, 125)) {
+    cleanup();
+    std::cerr << "cex_type1_service did not accept connections in time" << std::endl;
+    CHECK(false);
+    return;
+  }
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<std::size_t> received(kClients, 0);
+  std::vector<std::unique_ptr<hermeneutic::cex_type1::ExchangeFeed>> feeds;
+  for (std::size_t i = 0; i < kClients; ++i) {
+    feeds.push_back(hermeneutic::cex_type1::makeWebSocketFeed(
+        {.exchange = exchange,
+         .url = "ws://127.0.0.1:" + std::to_string(port) + "/" + exchange,
+         .auth_token = token,
+         .interval = 20ms},
+        [&, i](const hermeneutic::common::BookEvent&) {
+          std::lock_guard<std::mutex> lock(mutex);
+          ++received[i];
+          cv.notify_one();
+        }));
+    feeds.back()->start();
+  }
+
+  // Every client stays connected at once, so each one needs its own thread.
+  bool all_served = false;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    all_served = cv.wait_for(lock, 10s, [&] {
+      return std::all_of(received.begin(), received.end(), [](std::size_t count) { return count > 0; });
+    });
+  }
+  for (auto& feed : feeds) {
+    feed->stop();
+  }
+  cleanup();
+  CHECK(all_served);
+}
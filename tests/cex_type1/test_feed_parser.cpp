@@ -0,0 +1,101 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "hermeneutic/cex_type1/feed_parser.hpp"
+
+using hermeneutic::cex_type1::FeedParser;
+using hermeneutic::common::BookEvent;
+using hermeneutic::common::BookEventKind;
+using hermeneutic::common::Side;
+
+TEST_CASE("feed parser decodes new orders regardless of field order") {
+  FeedParser parser("notbinance");
+  BookEvent event;
+  CHECK(parser.parse(
+      R"({"quantity": "2306.54", "price": "29952.16", "side": "ask", "order_id": "215", "sequence": 2, "type": "new_order", "timestamp_ms": 7})",
+      100, event));
+  CHECK(event.kind == BookEventKind::NewOrder);
+  CHECK(hermeneutic::common::ExchangeRegistry::instance().name(event.exchange_id) == "notbinance");
+  CHECK(event.sequence == 2);
+  CHECK(event.order.order_id == 215);
+  CHECK(event.order.side == Side::Ask);
+  CHECK(event.order.price.toString(2) == "29952.16");
+  CHECK(event.order.quantity.toString(2) == "2306.54");
+  CHECK(event.feed_timestamp_ns == 7'000'000);
+  CHECK(event.local_timestamp_ns == 100);
+
+  CHECK(parser.parse(R"({"type": "cancel_order", "sequence": 3, "order_id": 215, "timestamp_ns": 9})", 200,
+                     event));
+  CHECK(event.kind == BookEventKind::CancelOrder);
+  CHECK(event.order.order_id == 215);
+  CHECK(event.order.quantity == hermeneutic::common::Decimal::fromRaw(0));
+  CHECK(event.feed_timestamp_ns == 9);
+  CHECK(event.symbol_id == hermeneutic::common::kDefaultSymbol);
+}
+
+TEST_CASE("feed parser stamps its symbol id") {
+  FeedParser parser("notbinance", "parser-ETHUSDT");
+  BookEvent event;
+  CHECK(parser.parse(R"({"type": "cancel_order", "sequence": 3, "order_id": 215})", 1, event));
+  CHECK(event.symbol.empty());
+  CHECK(hermeneutic::common::SymbolRegistry::instance().name(event.symbol_id) == "parser-ETHUSDT");
+}
+
+TEST_CASE("feed parser skips messages without a book event and rejects bad decimals") {
+  FeedParser parser("ex");
+  BookEvent event;
+  CHECK(!parser.parse(R"({"type": "heartbeat"})", 1, event));
+  CHECK(!parser.parse(R"({"sequence": 1})", 1, event));
+  CHECK(!parser.parse(R"({"type": "new_order", "order_id": "x1", "side": "bid", "price": "1", "quantity": "1"})",
+                      1, event));
+  CHECK(!parser.parse(R"({"type": "cancel_order"})", 1, event));
+
+  bool threw = false;
+  try {
+    parser.parse(R"({"type": "new_order", "order_id": 1, "side": "bid", "price": "1.2.3", "quantity": "1"})", 1,
+                 event);
+  } catch (const std::exception&) {
+    threw = true;
+  }
+  CHECK(threw);
+}
+
+TEST_CASE("feed parser reads every message of the bundled ndjson feeds") {
+  for (const char* name : {"notbinance", "notcoinbase", "notkraken"}) {
+    std::ifstream input(std::filesystem::path(PROJECT_SOURCE_DIR) / "data" / (std::string(name) + ".ndjson"));
+    CHECK(input.good());
+    FeedParser parser(name);
+    BookEvent event;
+    std::size_t snapshots = 0;
+    std::size_t events = 0;
+    std::uint64_t last_sequence = 0;
+    bool increasing = true;
+    std::string line;
+    while (std::getline(input, line)) {
+      if (line.empty()) {
+        continue;
+      }
+      if (!parser.parse(line, 0, event)) {
+        continue;
+      }
+      ++events;
+      if (event.kind == BookEventKind::Snapshot) {
+        ++snapshots;
+        CHECK(!event.snapshot.bids.empty());
+        CHECK(!event.snapshot.asks.empty());
+      }
+      increasing = increasing && event.sequence > last_sequence;
+      last_sequence = event.sequence;
+    }
+    CAPTURE(name);
+    CHECK(events == 401);
+    CHECK(snapshots >= 1);
+    CHECK(increasing);
+  }
+}
@@ -0,0 +1,275 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <Poco/Net/HTTPRequestHandler.h>
+#include <Poco/Net/HTTPRequestHandlerFactory.h>
+#include <Poco/Net/HTTPServer.h>
+#include <Poco/Net/HTTPServerParams.h>
+#include <Poco/Net/HTTPServerRequest.h>
+#include <Poco/Net/HTTPServerResponse.h>
+#include <Poco/Net/ServerSocket.h>
+#include <Poco/Net/SocketAddress.h>
+#include <Poco/Net/WebSocket.h>
+#include <Poco/Timespan.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hermeneutic/cex_type1/feed_reactor.hpp"
+
+namespace {
+// Streams a fragmented snapshot (with a ping in between) followed by a few
+// orders to every client, using the request path as the exchange name.
+class StreamHandler : public Poco::Net::HTTPRequestHandler {
+ public:
+  explicit StreamHandler(std::atomic<int>& pongs) : pongs_(pongs) {}
+
+  void handleRequest(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response) override {
+    try {
+      if (request.get("Authorization", "") != "Bearer reactor-token") {
+        response.setStatus(Poco::Net::HTTPResponse::HTTP_UNAUTHORIZED);
+        response.send() << "unauthorized";
+        return;
+      }
+      Poco::Net::WebSocket ws(request, response);
+      ws.setSendTimeout(Poco::Timespan(1, 0));
+      ws.setReceiveTimeout(Poco::Timespan(1, 0));
+
+      std::string snapshot = R"({"type":"snapshot","sequence":1,"asks":[{"price":"200.00","quantity":"1"}],"bids":[)";
+      for (int i = 0; i < 5000; ++i) {
+        snapshot += (i == 0 ? "" : ",");
+        snapshot += R"({"price":")" + std::to_string(100 + i) + R"(.00","quantity":"2"})";
+      }
+      snapshot += "]}";
+      constexpr std::size_t kFragment = 16 * 1024;
+      for (std::size_t offset = 0; offset < snapshot.size(); offset += kFragment) {
+        const auto length = std::min(kFragment, snapshot.size() - offset);
+        int flags = offset == 0 ? Poco::Net::WebSocket::FRAME_OP_TEXT : Poco::Net::WebSocket::FRAME_OP_CONT;
+        if (offset + length == snapshot.size()) {
+          flags |= Poco::Net::WebSocket::FRAME_FLAG_FIN;
+        }
+        ws.sendFrame(snapshot.data() + offset, static_cast<int>(length), flags);
+        if (offset == 0) {
+          ws.sendFrame("hb", 2, Poco::Net::WebSocket::FRAME_FLAG_FIN | Poco::Net::WebSocket::FRAME_OP_PING);
+          char buffer[16];
+          int flags_in = 0;
+          const int n = ws.receiveFrame(buffer, sizeof(buffer), flags_in);
+          if ((flags_in & Poco::Net::WebSocket::FRAME_OP_BITMASK) == Poco::Net::WebSocket::FRAME_OP_PONG &&
+              std::string(buffer, static_cast<std::size_t>(n)) == "hb") {
+            pongs_.fetch_add(1);
+          }
+        }
+      }
+      for (int sequence = 2; sequence <= 4; ++sequence) {
+        const auto order = R"({"type":"new_order","sequence":)" + std::to_string(sequence) + R"(,"order_id":)" +
+                           std::to_string(sequence) + R"(,"side":"ask","price":"201.00","quantity":"1"})";
+        ws.sendFrame(order.data(), static_cast<int>(order.size()), Poco::Net::WebSocket::FRAME_TEXT);
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    } catch (const Poco::Exception&) {
+      // The client may hang up first.
+    }
+  }
+
+ private:
+  std::atomic<int>& pongs_;
+};
+
+class StreamFactory : public Poco::Net::HTTPRequestHandlerFactory {
+ public:
+  explicit StreamFactory(std::atomic<int>& pongs) : pongs_(pongs) {}
+
+  Poco::Net::HTTPRequestHandler* createRequestHandler(const Poco::Net::HTTPServerRequest&) override {
+    return new StreamHandler(pongs_);
+  }
+
+ private:
+  std::atomic<int>& pongs_;
+};
+
+// Sends one text frame above the client's max_message_bytes, then an order,
+// and counts how often the client connects.
+class OversizedHandler : public Poco::Net::HTTPRequestHandler {
+ public:
+  explicit OversizedHandler(std::atomic<int>& connections) : connections_(connections) {}
+
+  void handleRequest(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response) override {
+    try {
+      Poco::Net::WebSocket ws(request, response);
+      connections_.fetch_add(1);
+      ws.setSendTimeout(Poco::Timespan(1, 0));
+      const std::string oversized(4096, ' ');
+      ws.sendFrame(oversized.data(), static_cast<int>(oversized.size()), Poco::Net::WebSocket::FRAME_TEXT);
+      const std::string order =
+          R"({"type":"new_order","sequence":1,"order_id":1,"side":"bid","price":"100.00","quantity":"1"})";
+      ws.sendFrame(order.data(), static_cast<int>(order.size()), Poco::Net::WebSocket::FRAME_TEXT);
+      std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    } catch (const Poco::Exception&) {
+      // The client may hang up first.
+    }
+  }
+
+ private:
+  std::atomic<int>& connections_;
+};
+
+class OversizedFactory : public Poco::Net::HTTPRequestHandlerFactory {
+ public:
+  explicit OversizedFactory(std::atomic<int>& connections) : connections_(connections) {}
+
+  Poco::Net::HTTPRequestHandler* createRequestHandler(const Poco::Net::HTTPServerRequest&) override {
+    return new OversizedHandler(connections_);
+  }
+
+ private:
+  std::atomic<int>& connections_;
+};
+
+struct Received {
+  std::size_t snapshot_bids{0};
+  std::vector<std::uint64_t> orders;
+  // Ladder capacity the reused event still held when the orders arrived.
+  std::size_t order_bid_capacity{0};
+};
+
+}  // namespace
+
+TEST_CASE("feed reactor multiplexes several feeds on one loop thread") {
+  using namespace std::chrono_literals;
+  std::signal(SIGPIPE, SIG_IGN);
+
+  std::unique_ptr<Poco::Net::ServerSocket> socket;
+  try {
+    socket = std::make_unique<Poco::Net::ServerSocket>(Poco::Net::SocketAddress("127.0.0.1", 0));
+  } catch (const Poco::Exception& ex) {
+    std::cerr << "Skipping reactor test: " << ex.displayText() << std::endl;
+    return;
+  }
+  const auto port = socket->address().port();
+  Poco::Net::HTTPServerParams::Ptr params = new Poco::Net::HTTPServerParams;
+  params->setMaxThreads(4);
+  params->setMaxQueued(8);
+  std::atomic<int> pongs{0};
+  Poco::Net::HTTPServer server(new StreamFactory(pongs), *socket, params);
+  server.start();
+
+  const std::vector<std::string> exchanges = {"alpha", "beta", "gamma"};
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::map<std::string, Received> received;
+  std::set<std::thread::id> callback_threads;
+
+  hermeneutic::cex_type1::FeedReactor reactor(1);
+  std::vector<std::unique_ptr<hermeneutic::cex_type1::ExchangeFeed>> feeds;
+  for (const auto& exchange : exchanges) {
+    feeds.push_back(reactor.makeFeed(
+        {.exchange = exchange,
+         .url = "ws://127.0.0.1:" + std::to_string(port) + "/" + exchange,
+         .auth_token = "reactor-token",
+         .interval = 50ms},
+        [&](const hermeneutic::common::BookEvent& event) {
+          std::lock_guard<std::mutex> lock(mutex);
+          callback_threads.insert(std::this_thread::get_id());
+          auto& entry = received[hermeneutic::common::ExchangeRegistry::instance().name(event.exchange_id)];
+          if (event.kind == hermeneutic::common::BookEventKind::Snapshot) {
+            entry.snapshot_bids = event.snapshot.bids.size();
+          } else if (entry.orders.size() < 3) {
+            entry.orders.push_back(event.sequence);
+            entry.order_bid_capacity = event.snapshot.bids.capacity();
+          }
+          cv.notify_all();
+        }));
+  }
+  // A feed with the wrong token keeps being rejected without disturbing the rest.
+  auto rejected = reactor.makeFeed(
+      {.exchange = "rejected", .url = "ws://127.0.0.1:" + std::to_string(port) + "/rejected", .interval = 50ms},
+      [&](const hermeneutic::common::BookEvent& event) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received[hermeneutic::common::ExchangeRegistry::instance().name(event.exchange_id)].orders.push_back(
+            event.sequence);
+      });
+
+  for (auto& feed : feeds) {
+    feed->start();
+  }
+  rejected->start();
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    CHECK(cv.wait_for(lock, 5s, [&] {
+      return std::all_of(exchanges.begin(), exchanges.end(), [&](const std::string& exchange) {
+        auto it = received.find(exchange);
+        return it != received.end() && it->second.snapshot_bids > 0 && it->second.orders.size() == 3;
+      });
+    }));
+  }
+  for (auto& feed : feeds) {
+    feed->stop();
+  }
+  rejected->stop();
+  server.stop();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  CHECK(callback_threads.size() == 1);
+  CHECK(pongs.load() >= 3);
+  CHECK(received.count("rejected") == 0);
+  for (const auto& exchange : exchanges) {
+    CAPTURE(exchange);
+    CHECK(received[exchange].snapshot_bids == 5000);
+    CHECK((received[exchange].orders == std::vector<std::uint64_t>{2, 3, 4}));
+    CHECK(received[exchange].order_bid_capacity >= 5000);
+  }
+}
+
+TEST_CASE("feed reactor drops an oversized frame without reconnecting") {
+  using namespace std::chrono_literals;
+  std::signal(SIGPIPE, SIG_IGN);
+
+  std::unique_ptr<Poco::Net::ServerSocket> socket;
+  try {
+    socket = std::make_unique<Poco::Net::ServerSocket>(Poco::Net::SocketAddress("127.0.0.1", 0));
+  } catch (const Poco::Exception& ex) {
+    std::cerr << "Skipping reactor test: " << ex.displayText() << std::endl;
+    return;
+  }
+  const auto port = socket->address().port();
+  std::atomic<int> connections{0};
+  Poco::Net::HTTPServer server(new OversizedFactory(connections), *socket, new Poco::Net::HTTPServerParams);
+  server.start();
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<std::uint64_t> orders;
+  hermeneutic::cex_type1::FeedReactor reactor(1);
+  auto feed = reactor.makeFeed({.exchange = "oversized",
+                                .url = "ws://127.0.0.1:" + std::to_string(port) + "/",
+                                .auth_token = "",
+                                .interval = 50ms,
+                                .max_message_bytes = 1024},
+                               [&](const hermeneutic::common::BookEvent& event) {
+                                 std::lock_guard<std::mutex> lock(mutex);
+                                 orders.push_back(event.sequence);
+                                 cv.notify_all();
+                               });
+  feed->start();
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    CHECK(cv.wait_for(lock, 5s, [&] { return !orders.empty(); }));
+  }
+  feed->stop();
+  server.stop();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  CHECK(orders.size() == 1);
+  CHECK(connections.load() == 1);
+}
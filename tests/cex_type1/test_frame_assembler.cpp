@@ -0,0 +1,103 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <string>
+#include <string_view>
+
+#include "hermeneutic/cex_type1/feed_parser.hpp"
+#include "hermeneutic/cex_type1/frame_assembler.hpp"
+
+using hermeneutic::cex_type1::FeedParser;
+using hermeneutic::cex_type1::FrameAssembler;
+using Frame = FrameAssembler::Frame;
+
+namespace {
+// Mirrors Poco's WebSocket::receiveFrame(Poco::Buffer<char>&, int&), which
+// appends the frame payload to the buffer.
+Frame deliver(FrameAssembler& assembler, std::uint8_t opcode, bool fin, std::string_view payload) {
+  assembler.prepare().append(payload.data(), payload.size());
+  return assembler.onFrame(opcode, fin, payload.size());
+}
+
+std::string deepSnapshot(std::size_t levels) {
+  std::string json = R"({"type":"snapshot","sequence":1,"bids":[)";
+  for (std::size_t i = 0; i < levels; ++i) {
+    json += (i == 0 ? "" : ",");
+    json += R"({"price":")" + std::to_string(50000 - i) + R"(.25","quantity":"1.5"})";
+  }
+  json += R"(],"asks":[{"price":"50001.00","quantity":"2"}]})";
+  return json;
+}
+}  // namespace
+
+TEST_CASE("frame assembler joins continuation frames around interleaved pings") {
+  FrameAssembler assembler;
+  CHECK(deliver(assembler, FrameAssembler::kText, false, R"({"type":"new_order",)") == Frame::Partial);
+  CHECK(deliver(assembler, FrameAssembler::kPing, true, "hb") == Frame::Ping);
+  CHECK(assembler.control() == "hb");
+  CHECK(deliver(assembler, FrameAssembler::kContinuation, false, R"("sequence":4,)") == Frame::Partial);
+  CHECK(deliver(assembler, FrameAssembler::kContinuation, true, R"("order_id":9})") == Frame::Message);
+  CHECK(assembler.message() == R"({"type":"new_order","sequence":4,"order_id":9})");
+
+  CHECK(deliver(assembler, FrameAssembler::kText, true, R"({"type":"cancel_order"})") == Frame::Message);
+  CHECK(assembler.message() == R"({"type":"cancel_order"})");
+}
+
+TEST_CASE("frame assembler skips binary, stray and oversized messages") {
+  FrameAssembler assembler(16, 8);
+  CHECK(deliver(assembler, FrameAssembler::kContinuation, true, "stray") == Frame::Skipped);
+  CHECK(deliver(assembler, FrameAssembler::kBinary, false, "bin") == Frame::Skipped);
+  CHECK(deliver(assembler, FrameAssembler::kContinuation, true, "ary") == Frame::Skipped);
+  CHECK(deliver(assembler, FrameAssembler::kPong, true, "") == Frame::Skipped);
+
+  CHECK(deliver(assembler, FrameAssembler::kText, false, "0123456789") == Frame::Partial);
+  CHECK(deliver(assembler, FrameAssembler::kContinuation, false, "0123456789") == Frame::Oversized);
+  CHECK(deliver(assembler, FrameAssembler::kContinuation, true, "tail") == Frame::Skipped);
+
+  // An unfinished message is abandoned when a new one starts.
+  CHECK(deliver(assembler, FrameAssembler::kText, false, "lost") == Frame::Partial);
+  CHECK(deliver(assembler, FrameAssembler::kText, true, "{}") == Frame::Message);
+  CHECK(assembler.message() == "{}");
+  CHECK(deliver(assembler, FrameAssembler::kClose, true, "\x03\xe8") == Frame::Close);
+
+  // Frames too large to buffer at all are discarded by the caller.
+  CHECK(assembler.onDiscardedFrame(FrameAssembler::kText, true) == Frame::Oversized);
+  CHECK(deliver(assembler, FrameAssembler::kText, false, "{") == Frame::Partial);
+  CHECK(assembler.onDiscardedFrame(FrameAssembler::kContinuation, false) == Frame::Oversized);
+  CHECK(assembler.onDiscardedFrame(FrameAssembler::kContinuation, false) == Frame::Skipped);
+  CHECK(deliver(assembler, FrameAssembler::kContinuation, true, "}") == Frame::Skipped);
+  CHECK(assembler.onDiscardedFrame(FrameAssembler::kBinary, true) == Frame::Skipped);
+  CHECK(assembler.onDiscardedFrame(FrameAssembler::kPing, true) == Frame::Skipped);
+  CHECK(deliver(assembler, FrameAssembler::kText, true, "{}") == Frame::Message);
+}
+
+TEST_CASE("frame assembler reuses its buffer for deep fragmented snapshots") {
+  const auto snapshot = deepSnapshot(20000);
+  CHECK(snapshot.size() > FrameAssembler::kDefaultInitialCapacity * 8);
+
+  FrameAssembler assembler;
+  FeedParser parser("deep");
+  hermeneutic::common::BookEvent event;
+  std::size_t settled_capacity = 0;
+  for (int round = 0; round < 4; ++round) {
+    constexpr std::size_t kChunk = 16 * 1024;
+    Frame last = Frame::Skipped;
+    for (std::size_t offset = 0; offset < snapshot.size(); offset += kChunk) {
+      const auto chunk = std::string_view(snapshot).substr(offset, kChunk);
+      const bool fin = offset + kChunk >= snapshot.size();
+      last = deliver(assembler, offset == 0 ? FrameAssembler::kText : FrameAssembler::kContinuation, fin, chunk);
+    }
+    CHECK(last == Frame::Message);
+    CHECK(assembler.message() == snapshot);
+    CHECK(assembler.capacity() >= snapshot.size() + FeedParser::kPadding);
+    if (round == 0) {
+      settled_capacity = assembler.capacity();
+    }
+    CHECK(assembler.capacity() == settled_capacity);
+
+    const auto message = assembler.message();
+    CHECK(parser.parse(message.data(), message.size(), 0, event));
+    CHECK(event.snapshot.bids.size() == 20000);
+    CHECK(event.snapshot.asks.size() == 1);
+  }
+}
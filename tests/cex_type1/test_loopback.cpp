@@ -12,6 +12,7 @@
 #include <Poco/Net/WebSocket.h>
 #include <Poco/Timespan.h>
 
+#include <algorithm>
 #include <chrono>
 #include <condition_variable>
 #include <csignal>
@@ -19,14 +20,15 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 
 #include "hermeneutic/cex_type1/feed.hpp"
 
 namespace {
 class LoopbackHandler : public Poco::Net::HTTPRequestHandler {
  public:
-  LoopbackHandler(std::string token, std::string payload)
-      : token_(std::move(token)), payload_(std::move(payload)) {}
+  LoopbackHandler(std::string token, std::string payload, std::size_t fragment)
+      : token_(std::move(token)), payload_(std::move(payload)), fragment_(fragment) {}
 
   void handleRequest(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response) override {
     try {
@@ -39,7 +41,23 @@ class LoopbackHandler : public Poco::Net::HTTPRequestHandler {
 
       Poco::Net::WebSocket ws(request, response);
       ws.setSendTimeout(Poco::Timespan(1, 0));
-      ws.sendFrame(payload_.data(), static_cast<int>(payload_.size()), Poco::Net::WebSocket::FRAME_TEXT);
+      if (fragment_ == 0) {
+        ws.sendFrame(payload_.data(), static_cast<int>(payload_.size()), Poco::Net::WebSocket::FRAME_TEXT);
+        return;
+      }
+      // Split the message into continuation frames with a ping in between.
+      for (std::size_t offset = 0; offset < payload_.size(); offset += fragment_) {
+        const auto length = std::min(fragment_, payload_.size() - offset);
+        int flags = offset == 0 ? Poco::Net::WebSocket::FRAME_OP_TEXT : Poco::Net::WebSocket::FRAME_OP_CONT;
+        if (offset + length == payload_.size()) {
+          flags |= Poco::Net::WebSocket::FRAME_FLAG_FIN;
+        }
+        ws.sendFrame(payload_.data() + offset, static_cast<int>(length), flags);
+        if (offset == 0) {
+          ws.sendFrame("hb", 2, Poco::Net::WebSocket::FRAME_FLAG_FIN | Poco::Net::WebSocket::FRAME_OP_PING);
+        }
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
     } catch (const Poco::Exception&) {
       // Ignore transport errors triggered when the client disconnects early.
     }
@@ -48,25 +66,27 @@ class LoopbackHandler : public Poco::Net::HTTPRequestHandler {
  private:
   std::string token_;
   std::string payload_;
+  std::size_t fragment_;
 };
 
 class LoopbackFactory : public Poco::Net::HTTPRequestHandlerFactory {
  public:
-  LoopbackFactory(std::string exchange, std::string token, std::string payload)
-      : exchange_(std::move(exchange)), token_(std::move(token)), payload_(std::move(payload)) {}
+  LoopbackFactory(std::string exchange, std::string token, std::string payload, std::size_t fragment = 0)
+      : exchange_(std::move(exchange)), token_(std::move(token)), payload_(std::move(payload)), fragment_(fragment) {}
 
   Poco::Net::HTTPRequestHandler* createRequestHandler(const Poco::Net::HTTPServerRequest& request) override {
     const auto expected = "/" + exchange_;
     if (request.getURI() != expected) {
       return nullptr;
     }
-    return new LoopbackHandler(token_, payload_);
+    return new LoopbackHandler(token_, payload_, fragment_);
   }
 
  private:
   std::string exchange_;
   std::string token_;
   std::string payload_;
+  std::size_t fragment_;
 };
 
 }  // namespace
@@ -107,9 +127,9 @@ TEST_CASE("cex_type1/websocket_loopback feed emits updates") {
          .url = "ws://127.0.0.1:" + std::to_string(port) + "/" + exchange,
          .auth_token = token,
          .interval = 10ms},
-        [&](hermeneutic::common::BookEvent update) {
+        [&](const hermeneutic::common::BookEvent& update) {
           std::lock_guard<std::mutex> lock(mutex);
-          captured = std::move(update);
+          captured = update;
           received = true;
           cv.notify_one();
         });
@@ -122,7 +142,7 @@ TEST_CASE("cex_type1/websocket_loopback feed emits updates") {
     feed->stop();
     server.stop();
 
-    CHECK(captured.exchange == exchange);
+    CHECK(hermeneutic::common::ExchangeRegistry::instance().name(captured.exchange_id) == exchange);
     CHECK(captured.kind == hermeneutic::common::BookEventKind::NewOrder);
     CHECK(captured.order.side == hermeneutic::common::Side::Bid);
     CHECK(captured.order.price == hermeneutic::common::Decimal::fromString("101.25"));
@@ -135,3 +155,71 @@ TEST_CASE("cex_type1/websocket_loopback feed emits updates") {
     CHECK(false);
   }
 }
+
+TEST_CASE("cex_type1/websocket_loopback feed reassembles fragmented deep snapshots") {
+  using namespace std::chrono_literals;
+  const std::string exchange = "deep";
+  constexpr std::size_t kLevels = 20000;
+  std::string payload = R"({"type":"snapshot","sequence":1,"asks":[{"price":"60000.00","quantity":"1"}],"bids":[)";
+  for (std::size_t i = 0; i < kLevels; ++i) {
+    payload += (i == 0 ? "" : ",");
+    payload += R"({"price":")" + std::to_string(50000 - i) + R"(.00","quantity":"0.25"})";
+  }
+  payload += "]}";
+  std::signal(SIGPIPE, SIG_IGN);
+
+  try {
+    std::unique_ptr<Poco::Net::ServerSocket> socket;
+    try {
+      socket = std::make_unique<Poco::Net::ServerSocket>(Poco::Net::SocketAddress("127.0.0.1", 0));
+    } catch (const Poco::Exception& ex) {
+      std::cerr << "Skipping loopback test: " << ex.displayText() << std::endl;
+      return;
+    }
+    const auto port = socket->address().port();
+    Poco::Net::HTTPServerParams::Ptr params = new Poco::Net::HTTPServerParams;
+    params->setMaxThreads(1);
+    params->setMaxQueued(1);
+
+    auto factory = new LoopbackFactory(exchange, "", payload, 32 * 1024);
+    Poco::Net::HTTPServer server(factory, *socket, params);
+    server.start();
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool received = false;
+    hermeneutic::common::BookEvent captured;
+
+    auto feed = hermeneutic::cex_type1::makeWebSocketFeed(
+        {.exchange = exchange,
+         .url = "ws://127.0.0.1:" + std::to_string(port) + "/" + exchange,
+         .interval = 10ms},
+        [&](const hermeneutic::common::BookEvent& update) {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (!received) {
+            captured = update;
+            received = true;
+          }
+          cv.notify_one();
+        });
+
+    feed->start();
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      CHECK(cv.wait_for(lock, 5s, [&] { return received; }));
+    }
+    feed->stop();
+    server.stop();
+
+    CHECK(captured.kind == hermeneutic::common::BookEventKind::Snapshot);
+    CHECK(captured.snapshot.bids.size() == kLevels);
+    CHECK(captured.snapshot.asks.size() == 1);
+    CHECK(captured.snapshot.bids.back().price == hermeneutic::common::Decimal::fromString("30001.00"));
+  } catch (const Poco::Exception& ex) {
+    std::cerr << "Poco exception: " << ex.displayText() << std::endl;
+    CHECK(false);
+  } catch (const std::exception& ex) {
+    std::cerr << "std exception: " << ex.what() << std::endl;
+    CHECK(false);
+  }
+}
@@ -116,7 +116,7 @@ TEST_CASE("cex_type1 feed reconnects after server restart") {
        .url = "ws://127.0.0.1:" + std::to_string(port),
        .auth_token = "",
        .interval = 20ms},
-      [&](hermeneutic::common::BookEvent evt) {
+      [&](const hermeneutic::common::BookEvent& evt) {
         std::lock_guard<std::mutex> lock(mutex);
         received_sequences.push_back(evt.sequence);
         cv.notify_one();
@@ -0,0 +1,135 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "tests/include/doctest_config.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "services/cex_type1_service/replay.hpp"
+
+using hermeneutic::services::cex_type1_service::Pacer;
+using hermeneutic::services::cex_type1_service::PacingOptions;
+using hermeneutic::services::cex_type1_service::PayloadLog;
+using hermeneutic::services::cex_type1_service::pacingForRate;
+
+namespace {
+template <typename Fn>
+std::chrono::nanoseconds timed(Fn&& fn) {
+  const auto start = std::chrono::steady_clock::now();
+  fn();
+  return std::chrono::steady_clock::now() - start;
+}
+}  // namespace
+
+TEST_CASE("payload log splits lines and finds the start sequence") {
+  const auto log = PayloadLog::fromString(
+      "{\"type\":\"snapshot\",\"sequence\":1}\r\n"
+      "\n"
+      "{\"type\":\"new_order\",\"sequence\": 2,\"timestamp_ns\":1000}\n"
+      "{\"type\":\"cancel_order\",\"sequence\":3,\"timestamp_ns\":2500}",
+      2);
+  REQUIRE(log.size() == 3);
+  CHECK(log.line(0) == "{\"type\":\"snapshot\",\"sequence\":1}");
+  CHECK(log.line(2) == "{\"type\":\"cancel_order\",\"sequence\":3,\"timestamp_ns\":2500}");
+  CHECK(log.startIndex() == 1);
+  CHECK(log.hasTimestamps());
+  CHECK(log.timestampNs(0) == 0);
+  CHECK(log.timestampNs(1) == 1000);
+  CHECK(log.timestampNs(2) == 2500);
+
+  const auto from_top = PayloadLog::fromString("{\"sequence\":7}\n", 0);
+  CHECK(from_top.startIndex() == 0);
+  CHECK(!from_top.hasTimestamps());
+}
+
+TEST_CASE("payload log loads files and rejects empty ones") {
+  const auto path = std::filesystem::temp_directory_path() / "cex_replay_test.ndjson";
+  {
+    std::ofstream out(path);
+    out << "{\"sequence\":1}\n{\"sequence\":2}\n";
+  }
+  const auto log = PayloadLog::load(path.string());
+  CHECK(log.size() == 2);
+  CHECK(log.line(1) == "{\"sequence\":2}");
+  std::filesystem::remove(path);
+
+  bool threw = false;
+  try {
+    PayloadLog::fromString("\n\n");
+  } catch (const std::runtime_error&) {
+    threw = true;
+  }
+  CHECK(threw);
+  threw = false;
+  try {
+    PayloadLog::load((std::filesystem::temp_directory_path() / "cex_replay_missing.ndjson").string());
+  } catch (const std::runtime_error&) {
+    threw = true;
+  }
+  CHECK(threw);
+}
+
+TEST_CASE("pacer holds a fixed rate and releases bursts together") {
+  using namespace std::chrono_literals;
+  // 200 frames at 20k/s: 199 gaps of 50 us.
+  Pacer steady(pacingForRate(20'000));
+  const auto elapsed = timed([&] {
+    for (int i = 0; i < 200; ++i) {
+      steady.wait();
+    }
+  });
+  CHECK(elapsed >= 9'900us);
+  CHECK(elapsed < 1s);
+
+  // 30 frames at 1000/s in bursts of 10: two 10 ms gaps, none inside a burst.
+  const auto pacing = pacingForRate(1000, 10);
+  CHECK(pacing.interval == 10ms);
+  Pacer bursty(pacing);
+  const auto first_burst = timed([&] {
+    for (int i = 0; i < 10; ++i) {
+      bursty.wait();
+    }
+  });
+  CHECK(first_burst < 5ms);
+  const auto rest = timed([&] {
+    for (int i = 0; i < 20; ++i) {
+      bursty.wait();
+    }
+  });
+  CHECK(rest >= 19ms);
+
+  Pacer unpaced(PacingOptions{});
+  CHECK(timed([&] {
+          for (int i = 0; i < 1000; ++i) {
+            unpaced.wait();
+          }
+        }) < 50ms);
+}
+
+TEST_CASE("pacer follows recorded timestamps scaled by speed") {
+  using namespace std::chrono_literals;
+  Pacer pacer(PacingOptions{.speed = 2.0});
+  // 30 ms of recording at 2x takes 15 ms.
+  const auto elapsed = timed([&] {
+    for (std::int64_t ts : {1'000'000'000LL, 1'010'000'000LL, 1'020'000'000LL, 1'030'000'000LL}) {
+      pacer.wait(ts);
+    }
+  });
+  CHECK(elapsed >= 14'900us);
+  CHECK(elapsed < 1s);
+  // Wrapping back to the start of the recording rebases instead of stalling.
+  CHECK(timed([&] { pacer.wait(1'000'000'000LL); }) < 5ms);
+
+  bool threw = false;
+  try {
+    pacingForRate(0);
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  CHECK(threw);
+}
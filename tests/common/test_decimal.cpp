@@ -2,8 +2,11 @@
 #include <doctest/doctest.h>
 
 #include <cmath>
+#include <cstdint>
+#include <limits>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 
 #include "hermeneutic/common/decimal.hpp"
 
@@ -103,6 +106,38 @@ void runDoubleConversionSuite() {
   CHECK(approxEqual(from_double, 8.125));
 }
 
+template <typename DecimalType>
+void runScaledIntegerSuite() {
+  auto price = DecimalType::fromString("27123.45678912");
+  CHECK(price.toScaled(8) == 2712345678912);
+  CHECK(DecimalType::fromString("-0.5").toScaled(2) == -50);
+  checkString(DecimalType::fromScaled(2712345678912, 8), "27123.45678912", 8);
+  checkString(DecimalType::fromScaled(-125, 3), "-0.125", 3);
+  CHECK(DecimalType::fromScaled(price.toScaled(8), 8).toString(8) == price.toString(8));
+  // Every backend truncates toward zero.
+  CHECK(DecimalType::fromString("1.239").toScaled(2) == 123);
+  CHECK(DecimalType::fromString("-1.239").toScaled(2) == -123);
+  CHECK(DecimalType::fromString("0.29").toScaled(2) == 29);
+
+  const auto expect_throw = [](auto&& convert) {
+    bool threw = false;
+    try {
+      (void)convert();
+    } catch (const std::exception&) {
+      threw = true;
+    }
+    CHECK(threw);
+  };
+  expect_throw([] { return DecimalType::fromString("100000000000").toScaled(8); });
+  expect_throw([] { return DecimalType::fromString("-100000000000").toScaled(8); });
+  expect_throw([&] { return price.toScaled(DecimalType::kScaleDigits + 1); });
+  expect_throw([] { return DecimalType::fromScaled(1, -1); });
+  if constexpr (!std::is_same_v<typename DecimalType::Storage, double>) {
+    CHECK(DecimalType::fromString("92233720368.54775807").toScaled(8) == std::numeric_limits<std::int64_t>::max());
+    expect_throw([] { return DecimalType::fromString("92233720368.54775808").toScaled(8); });
+  }
+}
+
 template <typename DecimalType>
 void runInvalidParsingSuite(const char *label) {
   auto expect_invalid = [label](std::string_view text) {
@@ -131,6 +166,7 @@ void runDecimalSuites(const char *label) {
   runHelperSuite<DecimalType>();
   runMulDivSuite<DecimalType>();
   runDoubleConversionSuite<DecimalType>();
+  runScaledIntegerSuite<DecimalType>();
   runInvalidParsingSuite<DecimalType>(label);
 }
 
@@ -0,0 +1,22 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <string>
+
+#include "hermeneutic/common/exchange_registry.hpp"
+
+using hermeneutic::common::ExchangeRegistry;
+
+TEST_CASE("exchange registry hands out stable dense ids") {
+  auto& registry = ExchangeRegistry::instance();
+  const auto before = registry.size();
+  const auto alpha = registry.intern("registry-alpha");
+  const auto beta = registry.intern(std::string("registry-beta"));
+  CHECK(beta == alpha + 1);
+  CHECK(registry.intern("registry-alpha") == alpha);
+  CHECK(registry.size() == before + 2);
+  CHECK(registry.name(alpha) == "registry-alpha");
+  CHECK(registry.name(beta) == "registry-beta");
+  CHECK(registry.find("registry-beta") == beta);
+  CHECK(!registry.find("registry-gamma").has_value());
+}
@@ -0,0 +1,23 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <string>
+
+#include "hermeneutic/common/symbol_registry.hpp"
+
+using hermeneutic::common::SymbolRegistry;
+
+TEST_CASE("symbol registry hands out stable dense ids with the default symbol first") {
+  auto& registry = SymbolRegistry::instance();
+  CHECK(registry.intern("") == hermeneutic::common::kDefaultSymbol);
+  CHECK(registry.name(hermeneutic::common::kDefaultSymbol).empty());
+  const auto before = registry.size();
+  const auto btc = registry.intern("registry-BTCUSDT");
+  const auto eth = registry.intern(std::string("registry-ETHUSDT"));
+  CHECK(eth == btc + 1);
+  CHECK(registry.intern("registry-BTCUSDT") == btc);
+  CHECK(registry.size() == before + 2);
+  CHECK(registry.name(eth) == "registry-ETHUSDT");
+  CHECK(registry.find("registry-ETHUSDT") == eth);
+  CHECK(!registry.find("registry-SOLUSDT").has_value());
+}
@@ -0,0 +1,234 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+#include "tests/include/doctest_config.hpp"
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hermeneutic/journal/reader.hpp"
+#include "hermeneutic/journal/writer.hpp"
+
+using hermeneutic::common::BookEvent;
+using hermeneutic::common::BookEventKind;
+using hermeneutic::common::Decimal;
+using hermeneutic::common::ExchangeRegistry;
+using hermeneutic::common::Side;
+using hermeneutic::common::SymbolRegistry;
+using hermeneutic::journal::JournalReader;
+using hermeneutic::journal::JournalWriter;
+
+namespace {
+
+std::filesystem::path freshDirectory(const std::string& name) {
+  const auto path = std::filesystem::temp_directory_path() /
+                    ("hermeneutic_journal_" + name + "_" + std::to_string(::getpid()));
+  std::filesystem::remove_all(path);
+  return path;
+}
+
+BookEvent order(const std::string& exchange, const std::string& symbol, std::uint64_t sequence,
+                BookEventKind kind = BookEventKind::NewOrder) {
+  BookEvent event;
+  event.exchange_id = ExchangeRegistry::instance().intern(exchange);
+  event.symbol = symbol;
+  event.kind = kind;
+  event.sequence = sequence;
+  event.order.order_id = 1000 + sequence;
+  event.order.side = sequence % 2 == 0 ? Side::Bid : Side::Ask;
+  event.order.price = Decimal::fromString("100.25");
+  event.order.quantity = Decimal::fromString("0.000000000000000001");
+  event.feed_timestamp_ns = 1'700'000'000'000'000'000 + static_cast<std::int64_t>(sequence);
+  event.local_timestamp_ns = event.feed_timestamp_ns + 500;
+  return event;
+}
+
+// As a feed stamps it: ids only.
+BookEvent stamped(const std::string& exchange, const std::string& symbol, std::uint64_t sequence) {
+  BookEvent event = order(exchange, symbol, sequence);
+  event.symbol.clear();
+  event.symbol_id = SymbolRegistry::instance().intern(symbol);
+  return event;
+}
+
+BookEvent snapshot(const std::string& exchange, const std::string& symbol, std::uint64_t sequence,
+                   std::size_t depth) {
+  BookEvent event = order(exchange, symbol, sequence, BookEventKind::Snapshot);
+  for (std::size_t i = 1; i <= depth; ++i) {
+    const auto offset = static_cast<std::int64_t>(i);
+    event.snapshot.bids.push_back({Decimal::fromInteger(100 - offset), Decimal::fromInteger(offset)});
+    event.snapshot.asks.push_back({Decimal::fromInteger(100 + offset), Decimal::fromInteger(offset)});
+  }
+  return event;
+}
+
+void checkSame(const BookEvent& actual, const BookEvent& expected) {
+  CHECK(actual.kind == expected.kind);
+  CHECK(actual.exchange_id == expected.exchange_id);
+  // Read back as the interned id, like the exchange.
+  const auto& symbol = expected.symbol_id != hermeneutic::common::kUnknownSymbol
+                           ? SymbolRegistry::instance().name(expected.symbol_id)
+                           : expected.symbol;
+  CHECK(SymbolRegistry::instance().name(actual.symbol_id) == symbol);
+  CHECK(actual.sequence == expected.sequence);
+  CHECK(actual.feed_timestamp_ns == expected.feed_timestamp_ns);
+  CHECK(actual.local_timestamp_ns == expected.local_timestamp_ns);
+  if (expected.kind == BookEventKind::Snapshot) {
+    REQUIRE(actual.snapshot.bids.size() == expected.snapshot.bids.size());
+    REQUIRE(actual.snapshot.asks.size() == expected.snapshot.asks.size());
+    for (std::size_t i = 0; i < expected.snapshot.bids.size(); ++i) {
+      CHECK(actual.snapshot.bids[i].price == expected.snapshot.bids[i].price);
+      CHECK(actual.snapshot.bids[i].quantity == expected.snapshot.bids[i].quantity);
+      CHECK(actual.snapshot.asks[i].price == expected.snapshot.asks[i].price);
+    }
+  } else {
+    CHECK(actual.order.order_id == expected.order.order_id);
+    CHECK(actual.order.side == expected.order.side);
+    CHECK(actual.order.price == expected.order.price);
+    CHECK(actual.order.quantity == expected.order.quantity);
+  }
+}
+
+}  // namespace
+
+TEST_CASE("journal round-trips events across exchanges and symbols") {
+  const auto directory = freshDirectory("roundtrip");
+  std::vector<BookEvent> events{
+      snapshot("journal-a", "BTCUSDT", 1, 3),
+      order("journal-a", "BTCUSDT", 2),
+      order("journal-b", "ETHUSDT", 7),
+      order("journal-a", "BTCUSDT", 3, BookEventKind::CancelOrder),
+      snapshot("journal-b", "ETHUSDT", 8, 0),
+      stamped("journal-b", "SOLUSDT", 9),
+  };
+  {
+    JournalWriter writer({.directory = directory.string()});
+    for (const auto& event : events) {
+      writer.append(event);
+    }
+    const auto stats = writer.stats();
+    CHECK(stats.events == events.size());
+    CHECK(stats.segments == 1);
+    CHECK(!stats.failed);
+  }
+
+  JournalReader reader(directory);
+  BookEvent event;
+  for (const auto& expected : events) {
+    REQUIRE(reader.next(event));
+    checkSame(event, expected);
+  }
+  CHECK(!reader.next(event));
+  CHECK(reader.eventsRead() == events.size());
+  CHECK((reader.symbols() == std::vector<std::string>{"BTCUSDT", "ETHUSDT", "SOLUSDT"}));
+  std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("journal segments rotate and each replays on its own") {
+  const auto directory = freshDirectory("rotate");
+  constexpr std::uint64_t kEvents = 200;
+  {
+    JournalWriter writer({.directory = directory.string(), .segment_bytes = 72 * 50, .buffer_bytes = 256});
+    for (std::uint64_t i = 1; i <= kEvents; ++i) {
+      writer.append(i % 40 == 0 ? snapshot("journal-r", "BTCUSDT", i, 5) : order("journal-r", "BTCUSDT", i));
+    }
+    CHECK(writer.stats().segments > 3);
+  }
+  // A restarted writer continues after the existing segments.
+  const auto before = hermeneutic::journal::listSegments(directory);
+  {
+    JournalWriter writer({.directory = directory.string()});
+    writer.append(order("journal-r", "BTCUSDT", kEvents + 1));
+  }
+  const auto segments = hermeneutic::journal::listSegments(directory);
+  REQUIRE(segments.size() == before.size() + 1);
+  CHECK(segments.back().filename() == hermeneutic::journal::segmentFileName(static_cast<std::uint32_t>(before.size())));
+
+  JournalReader all(directory);
+  BookEvent event;
+  std::uint64_t expected = 1;
+  while (all.next(event)) {
+    CHECK(event.sequence == expected);
+    CHECK(event.kind == (expected % 40 == 0 ? BookEventKind::Snapshot : BookEventKind::NewOrder));
+    ++expected;
+  }
+  CHECK(expected == kEvents + 2);
+
+  JournalReader middle(segments[2]);
+  REQUIRE(middle.next(event));
+  CHECK(ExchangeRegistry::instance().name(event.exchange_id) == "journal-r");
+  CHECK(SymbolRegistry::instance().name(event.symbol_id) == "BTCUSDT");
+  std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("journal writer thread writes in the background and on flush") {
+  const auto directory = freshDirectory("background");
+  JournalWriter writer({.directory = directory.string(), .flush_interval = std::chrono::milliseconds(5)});
+  writer.append(order("journal-w", "BTCUSDT", 1));
+  writer.flush();
+  {
+    JournalReader reader(directory);
+    BookEvent event;
+    REQUIRE(reader.next(event));
+    CHECK(event.sequence == 1);
+    CHECK(!reader.next(event));
+  }
+
+  // No flush(): the thread picks the record up on its own interval.
+  writer.append(order("journal-w", "BTCUSDT", 2));
+  const auto segment = hermeneutic::journal::listSegments(directory).at(0);
+  const auto size = std::filesystem::file_size(segment);
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (std::filesystem::file_size(segment) == size && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  CHECK(std::filesystem::file_size(segment) == size + sizeof(hermeneutic::journal::Record));
+  CHECK(writer.stats().dropped == 0);
+  std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("journal reader stops at a torn tail and rejects foreign files") {
+  const auto directory = freshDirectory("torn");
+  {
+    JournalWriter writer({.directory = directory.string()});
+    writer.append(order("journal-t", "BTCUSDT", 1));
+    writer.append(snapshot("journal-t", "BTCUSDT", 2, 10));
+  }
+  const auto segment = hermeneutic::journal::listSegments(directory).at(0);
+  // Cut into the snapshot's level records.
+  std::filesystem::resize_file(segment, std::filesystem::file_size(segment) - 100);
+  {
+    JournalReader reader(directory);
+    BookEvent event;
+    REQUIRE(reader.next(event));
+    CHECK(event.sequence == 1);
+    CHECK(!reader.next(event));
+  }
+
+  {
+    std::ofstream out(segment, std::ios::binary | std::ios::trunc);
+    out << std::string(200, 'x');
+  }
+  bool threw = false;
+  try {
+    JournalReader reader(directory);
+  } catch (const std::runtime_error&) {
+    threw = true;
+  }
+  CHECK(threw);
+  threw = false;
+  try {
+    JournalReader reader(directory / "missing");
+  } catch (const std::runtime_error&) {
+    threw = true;
+  }
+  CHECK(threw);
+  std::filesystem::remove_all(directory);
+}
@@ -2,14 +2,19 @@
 #include <doctest/doctest.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <cstdlib>
+#include <new>
 #include <sstream>
+#include <stdexcept>
 #include <vector>
 
 #include <spdlog/sinks/ostream_sink.h>
 #include <spdlog/spdlog.h>
 
 #include "hermeneutic/common/events.hpp"
+#include "hermeneutic/common/exchange_registry.hpp"
 #include "hermeneutic/lob/order_book.hpp"
 
 using hermeneutic::common::BookEvent;
@@ -17,6 +22,24 @@ using hermeneutic::common::BookEventKind;
 using hermeneutic::common::Decimal;
 using hermeneutic::common::Side;
 
+namespace {
+std::atomic<std::size_t> g_allocations{0};
+}  // namespace
+
+// Counts heap allocations so tests can assert the steady-state apply path
+// does not allocate.
+void* operator new(std::size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+// Out of line so GCC does not flag the inlined free() as mismatched.
+[[gnu::noinline]] void operator delete(void* ptr) noexcept { std::free(ptr); }
+[[gnu::noinline]] void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
 namespace {
 
 BookEvent makeNewOrder(std::uint64_t id,
@@ -90,6 +113,38 @@ TEST_CASE("limit order book removes zero quantity levels") {
   CHECK(book.bestBid().quantity == Decimal::fromRaw(0));
 }
 
+TEST_CASE("limit order book rejects updates from another exchange") {
+  auto& registry = hermeneutic::common::ExchangeRegistry::instance();
+  auto fromExchange = [&](const std::string& name, std::uint64_t id, std::uint64_t sequence) {
+    auto event = makeNewOrder(id, Side::Bid, "100.00", "1", sequence);
+    event.exchange.clear();
+    event.exchange_id = registry.intern(name);
+    return event;
+  };
+  auto rejects = [](hermeneutic::lob::LimitOrderBook& book, const BookEvent& event) {
+    try {
+      book.apply(event);
+    } catch (const std::invalid_argument&) {
+      return true;
+    }
+    return false;
+  };
+
+  // Named up front, the book must not adopt the first id it sees.
+  hermeneutic::lob::LimitOrderBook named;
+  named.setExchange("lob-a");
+  CHECK(rejects(named, fromExchange("lob-b", 1, 1)));
+  CHECK(!rejects(named, fromExchange("lob-a", 2, 2)));
+  CHECK(rejects(named, fromExchange("lob-b", 3, 3)));
+
+  // Named by an earlier name-only event.
+  hermeneutic::lob::LimitOrderBook by_event;
+  by_event.apply(makeNewOrder(1, Side::Bid, "100.00", "1", 1));
+  CHECK(rejects(by_event, fromExchange("lob-b", 2, 2)));
+  CHECK(!rejects(by_event, fromExchange("cex-1", 3, 3)));
+  CHECK(by_event.exchange() == "cex-1");
+}
+
 TEST_CASE("limit order book exposes level iterators without limit-order details") {
   hermeneutic::lob::LimitOrderBook book;
   book.apply(makeNewOrder(1, Side::Bid, "100.00", "2", 1));
@@ -143,3 +198,369 @@ TEST_CASE("limit order book warns and rejects crossed orders") {
   CHECK(book.bestAsk().price == initial_best_ask);
   CHECK(logs.str().find("Ignoring crossed ask order 4") != std::string::npos);
 }
+
+TEST_CASE("limit order book reports level deltas for each applied event") {
+  hermeneutic::lob::LimitOrderBook book;
+  hermeneutic::lob::LevelDeltas deltas;
+
+  book.apply(makeNewOrder(1, Side::Bid, "100.00", "2", 1), deltas);
+  CHECK(deltas.size() == 1);
+  CHECK(deltas[0].side == Side::Bid);
+  CHECK(deltas[0].previous_quantity == Decimal::fromRaw(0));
+  CHECK(deltas[0].quantity.toString(0) == "2");
+
+  deltas.clear();
+  book.apply(makeNewOrder(2, Side::Bid, "100.00", "3", 2), deltas);
+  CHECK(deltas.size() == 1);
+  CHECK(deltas[0].previous_quantity.toString(0) == "2");
+  CHECK(deltas[0].quantity.toString(0) == "5");
+
+  deltas.clear();
+  book.apply(makeCancel(1, 3), deltas);
+  book.apply(makeCancel(2, 4), deltas);
+  CHECK(deltas.size() == 2);
+  CHECK(deltas[1].previous_quantity.toString(0) == "3");
+  CHECK(deltas[1].quantity == Decimal::fromRaw(0));
+
+  deltas.clear();
+  book.apply(makeCancel(2, 4), deltas);
+  CHECK(deltas.empty());
+}
+
+TEST_CASE("limit order book snapshot deltas clear old levels before adding new ones") {
+  hermeneutic::lob::LimitOrderBook book;
+  book.apply(makeNewOrder(1, Side::Bid, "99.00", "1", 1));
+
+  BookEvent snapshot;
+  snapshot.exchange = "cex-1";
+  snapshot.kind = BookEventKind::Snapshot;
+  snapshot.sequence = 2;
+  snapshot.snapshot.bids.push_back({Decimal::fromString("98.00"), Decimal::fromString("4")});
+  snapshot.snapshot.asks.push_back({Decimal::fromString("101.00"), Decimal::fromString("2")});
+
+  hermeneutic::lob::LevelDeltas deltas;
+  book.apply(snapshot, deltas);
+  CHECK(deltas.size() == 3);
+  CHECK(deltas[0].price.toString(2) == "99.00");
+  CHECK(deltas[0].quantity == Decimal::fromRaw(0));
+  CHECK(deltas[1].price.toString(2) == "98.00");
+  CHECK(deltas[1].quantity.toString(0) == "4");
+  CHECK(deltas[2].side == Side::Ask);
+}
+
+TEST_CASE("flat ladder book matches the map ladder book level for level") {
+  hermeneutic::lob::LimitOrderBook map_book;
+  hermeneutic::lob::LimitOrderBook flat_book(hermeneutic::lob::BookOptions{
+      .ladder = hermeneutic::lob::LadderKind::Flat,
+      .tick_size = Decimal::fromString("0.01"),
+      .initial_ticks = 64,
+  });
+
+  std::vector<BookEvent> events = {
+      makeNewOrder(1, Side::Bid, "100.00", "2", 1),
+      makeNewOrder(2, Side::Bid, "99.50", "3", 2),
+      makeNewOrder(3, Side::Ask, "100.25", "1", 3),
+      makeNewOrder(4, Side::Ask, "101.75", "4", 4),
+      makeNewOrder(5, Side::Bid, "100.00", "1", 5),
+      makeCancel(1, 6),
+      makeNewOrder(6, Side::Bid, "90.00", "5", 7),
+      makeCancel(3, 8),
+  };
+  for (const auto& event : events) {
+    hermeneutic::lob::LevelDeltas map_deltas;
+    hermeneutic::lob::LevelDeltas flat_deltas;
+    map_book.apply(event, map_deltas);
+    flat_book.apply(event, flat_deltas);
+    CHECK(map_deltas.size() == flat_deltas.size());
+    for (std::size_t i = 0; i < std::min(map_deltas.size(), flat_deltas.size()); ++i) {
+      CHECK(map_deltas[i].price == flat_deltas[i].price);
+      CHECK(map_deltas[i].quantity == flat_deltas[i].quantity);
+    }
+  }
+
+  const auto levels = [](const std::vector<hermeneutic::common::PriceLevel>& side) {
+    std::vector<std::string> out;
+    for (const auto& level : side) {
+      out.push_back(level.price.toString(2) + "x" + level.quantity.toString(0));
+    }
+    return out;
+  };
+  const auto expected = map_book.snapshot(10);
+  const auto actual = flat_book.snapshot(10);
+  CHECK(levels(expected.bids) == levels(actual.bids));
+  CHECK(levels(expected.asks) == levels(actual.asks));
+  CHECK(levels(actual.bids) == std::vector<std::string>({"100.00x1", "99.50x3", "90.00x5"}));
+  CHECK(flat_book.bestBid().price.toString(2) == "100.00");
+  CHECK(flat_book.bestAsk().price.toString(2) == "101.75");
+}
+
+TEST_CASE("flat ladder book recentres and grows as prices drift") {
+  hermeneutic::lob::LimitOrderBook book(hermeneutic::lob::BookOptions{
+      .ladder = hermeneutic::lob::LadderKind::Flat,
+      .tick_size = Decimal::fromString("0.5"),
+      .initial_ticks = 64,
+  });
+  book.apply(makeNewOrder(1, Side::Bid, "1000.0", "1", 1));
+  book.apply(makeNewOrder(2, Side::Ask, "1000.5", "1", 2));
+  // Far outside the initial 64-tick window on both sides.
+  book.apply(makeNewOrder(3, Side::Bid, "900.0", "2", 3));
+  book.apply(makeNewOrder(4, Side::Ask, "1200.0", "3", 4));
+
+  std::vector<std::string> bids;
+  for (auto it = book.bidLevelsBegin(); it != book.bidLevelsEnd(); ++it) {
+    bids.push_back(it->first.toString(1) + "x" + it->second.toString(0));
+  }
+  CHECK(bids == std::vector<std::string>({"1000.0x1", "900.0x2"}));
+  std::vector<std::string> asks;
+  for (auto it = book.askLevelsBegin(); it != book.askLevelsEnd(); ++it) {
+    asks.push_back(it->first.toString(1) + "x" + it->second.toString(0));
+  }
+  CHECK(asks == std::vector<std::string>({"1000.5x1", "1200.0x3"}));
+
+  book.apply(makeCancel(1, 5));
+  book.apply(makeCancel(2, 6));
+  CHECK(book.bestBid().price.toString(1) == "900.0");
+  CHECK(book.bestAsk().price.toString(1) == "1200.0");
+}
+
+TEST_CASE("flat ladder book recentres in place without allocating while prices drift") {
+  hermeneutic::lob::LimitOrderBook book(hermeneutic::lob::BookOptions{
+      .ladder = hermeneutic::lob::LadderKind::Flat,
+      .tick_size = Decimal::fromString("0.01"),
+      .initial_ticks = 256,
+      .expected_orders = 64,
+  });
+  book.apply(makeNewOrder(1, Side::Bid, "100.00", "1", 1));
+  book.apply(makeNewOrder(2, Side::Ask, "150.00", "1", 2));
+  book.apply(makeCancel(2, 3));
+
+  // Walk the bid 40 ticks at a time, up and then back down, so the two
+  // live levels keep leaving the window without outgrowing it.
+  std::vector<BookEvent> events;
+  std::uint64_t sequence = 4;
+  std::uint64_t previous = 1;
+  std::int64_t cents = 10000;
+  for (std::uint64_t i = 0; i < 60; ++i) {
+    cents += i < 30 ? 40 : -40;
+    const auto price = std::to_string(cents / 100) + "." + std::to_string(cents % 100 / 10) + "0";
+    events.push_back(makeNewOrder(10 + i, Side::Bid, price, std::to_string(i + 1), sequence++));
+    events.push_back(makeCancel(previous, sequence++));
+    previous = 10 + i;
+  }
+  const auto before = book.stats();
+  hermeneutic::lob::LevelDeltas deltas;
+  deltas.reserve(16);
+  const auto allocations = g_allocations.load();
+  bool tracked = true;
+  for (std::size_t i = 0; i < events.size(); i += 2) {
+    deltas.clear();
+    book.apply(events[i], deltas);
+    deltas.clear();
+    book.apply(events[i + 1], deltas);
+    tracked = tracked && book.bestBid().price == events[i].order.price &&
+              book.bestBid().quantity == events[i].order.quantity && book.stats().bid_levels == 1;
+  }
+  CHECK(g_allocations.load() == allocations);
+  CHECK(tracked);
+  CHECK(book.stats().memory_bytes == before.memory_bytes);
+  CHECK(book.bestBid().price.toString(2) == "100.00");
+}
+
+TEST_CASE("flat ladder book ignores prices off its tick grid") {
+  ScopedLogCapture logs;
+  hermeneutic::lob::LimitOrderBook book(hermeneutic::lob::BookOptions{
+      .ladder = hermeneutic::lob::LadderKind::Flat,
+      .tick_size = Decimal::fromString("0.05"),
+  });
+  book.apply(makeNewOrder(1, Side::Bid, "100.05", "1", 1));
+  book.apply(makeNewOrder(2, Side::Bid, "100.07", "1", 2));
+  CHECK(book.bestBid().price.toString(2) == "100.05");
+  CHECK(logs.str().find("not on the book's tick grid") != std::string::npos);
+}
+
+TEST_CASE("flat ladder book drops an outlier price beyond max_ticks") {
+  ScopedLogCapture logs;
+  hermeneutic::lob::LimitOrderBook book(hermeneutic::lob::BookOptions{
+      .ladder = hermeneutic::lob::LadderKind::Flat,
+      .tick_size = Decimal::fromString("0.01"),
+      .initial_ticks = 64,
+      .max_ticks = 1024,
+  });
+  book.apply(makeNewOrder(1, Side::Bid, "100.00", "1", 1));
+  book.apply(makeNewOrder(2, Side::Ask, "100.50", "1", 2));
+  const auto before = book.stats().memory_bytes;
+  // A fat-fingered bid a million ticks away would otherwise size the array to it.
+  book.apply(makeNewOrder(3, Side::Bid, "0.01", "5", 3));
+  CHECK(logs.str().find("max_ticks") != std::string::npos);
+  CHECK(book.stats().bid_levels == 1);
+  CHECK(book.stats().memory_bytes == before);
+  // Within the limit the ladder still grows, and the book stays consistent.
+  book.apply(makeNewOrder(4, Side::Bid, "95.00", "2", 4));
+  CHECK(book.stats().bid_levels == 2);
+  CHECK(book.bestBid().price.toString(2) == "100.00");
+  book.apply(makeCancel(1, 5));
+  CHECK(book.bestBid().price.toString(2) == "95.00");
+  book.apply(makeCancel(3, 6));
+  CHECK(book.stats().bid_levels == 1);
+}
+
+TEST_CASE("order index survives collisions, overwrites, erases and growth") {
+  hermeneutic::lob::OrderIndex index(8);
+  const auto initial_capacity = index.capacity();
+  for (std::uint64_t id = 1; id <= 1000; ++id) {
+    hermeneutic::common::MarketOrder order;
+    order.order_id = id * 4096;  // same low bits: stresses probing
+    order.quantity = Decimal::fromInteger(static_cast<std::int64_t>(id));
+    index.insert(order);
+  }
+  CHECK(index.size() == 1000);
+  CHECK(index.capacity() > initial_capacity);
+
+  for (std::uint64_t id = 1; id <= 1000; id += 2) {
+    CHECK(index.erase(id * 4096));
+  }
+  CHECK(!index.erase(4096));
+  CHECK(index.size() == 500);
+  bool intact = true;
+  for (std::uint64_t id = 1; id <= 1000; ++id) {
+    const auto* order = index.find(id * 4096);
+    if (id % 2 == 1) {
+      intact = intact && order == nullptr;
+    } else {
+      intact = intact && order != nullptr &&
+               order->quantity == Decimal::fromInteger(static_cast<std::int64_t>(id));
+    }
+  }
+  CHECK(intact);
+
+  hermeneutic::common::MarketOrder replacement;
+  replacement.order_id = 2 * 4096;
+  replacement.quantity = Decimal::fromInteger(7);
+  index.insert(replacement);
+  CHECK(index.size() == 500);
+  CHECK(index.find(2 * 4096)->quantity == Decimal::fromInteger(7));
+
+  index.clear();
+  CHECK(index.empty());
+  CHECK(index.find(2 * 4096) == nullptr);
+  CHECK(index.begin() == index.end());
+}
+
+TEST_CASE("snapshot resets resting orders and steady-state apply does not allocate") {
+  hermeneutic::lob::LimitOrderBook book(hermeneutic::lob::BookOptions{
+      .ladder = hermeneutic::lob::LadderKind::Flat,
+      .tick_size = Decimal::fromString("0.01"),
+      .expected_orders = 256,
+  });
+  book.apply(makeNewOrder(1, Side::Bid, "100.00", "2", 1));
+  book.apply(makeNewOrder(2, Side::Ask, "101.00", "2", 2));
+
+  BookEvent snapshot;
+  snapshot.exchange = "cex-1";
+  snapshot.kind = BookEventKind::Snapshot;
+  snapshot.sequence = 3;
+  snapshot.snapshot.bids.push_back({Decimal::fromString("99.00"), Decimal::fromString("4")});
+  book.apply(snapshot);
+  CHECK(book.limitOrdersBegin() == book.limitOrdersEnd());
+  book.apply(makeCancel(1, 4));
+  CHECK(book.bestBid().price.toString(2) == "99.00");
+
+  const auto before = book.stats();
+  CHECK(before.order_capacity >= 256);
+  CHECK(before.memory_bytes > 0);
+
+  std::vector<BookEvent> events;
+  for (std::uint64_t i = 0; i < 200; ++i) {
+    const auto price = std::to_string(90 + i % 8) + ".00";
+    events.push_back(makeNewOrder(100 + i, Side::Bid, price, "1", 5 + 2 * i));
+    events.push_back(makeCancel(100 + i, 6 + 2 * i));
+  }
+  hermeneutic::lob::LevelDeltas deltas;
+  deltas.reserve(16);
+  const auto allocations = g_allocations.load();
+  for (const auto& event : events) {
+    deltas.clear();
+    book.apply(event, deltas);
+  }
+  CHECK(g_allocations.load() == allocations);
+  CHECK(book.stats().memory_bytes == before.memory_bytes);
+  CHECK(book.stats().resting_orders == 0);
+}
+
+TEST_CASE("sequence gap marks the book stale until a snapshot replays buffered deltas") {
+  hermeneutic::lob::LimitOrderBook book;
+  hermeneutic::lob::LevelDeltas deltas;
+  book.apply(makeNewOrder(1, Side::Bid, "100.00", "1", 1), deltas);
+  book.apply(makeNewOrder(2, Side::Ask, "105.00", "1", 2), deltas);
+
+  // Sequence 3 is lost: both levels are withdrawn and later deltas wait.
+  deltas.clear();
+  auto gapped = makeNewOrder(4, Side::Bid, "101.00", "2", 4);
+  gapped.local_timestamp_ns = 1'000;
+  book.apply(gapped, deltas);
+  CHECK(book.stale());
+  CHECK(book.bestBid().quantity == Decimal::fromRaw(0));
+  CHECK(book.bestAsk().quantity == Decimal::fromRaw(0));
+  CHECK(book.bidLevelsBegin() == book.bidLevelsEnd());
+  CHECK(book.snapshot(10).asks.empty());
+  CHECK(deltas.size() == 2);
+  CHECK(std::all_of(deltas.begin(), deltas.end(),
+                    [](const auto& delta) { return delta.quantity == Decimal::fromRaw(0); }));
+  deltas.clear();
+  book.apply(makeCancel(2, 6), deltas);
+  book.apply(makeNewOrder(5, Side::Ask, "104.00", "3", 5), deltas);
+  CHECK(deltas.empty());
+  CHECK(book.stats().buffered_events == 3);
+  CHECK(book.stats().sequence_gaps == 1);
+
+  BookEvent snapshot;
+  snapshot.exchange = "cex-1";
+  snapshot.kind = BookEventKind::Snapshot;
+  snapshot.sequence = 4;
+  snapshot.local_timestamp_ns = 5'000;
+  snapshot.snapshot.bids.push_back({Decimal::fromString("101.00"), Decimal::fromString("2")});
+  snapshot.snapshot.asks.push_back({Decimal::fromString("105.00"), Decimal::fromString("1")});
+  book.apply(snapshot, deltas);
+
+  // Sequence 4 is covered by the snapshot; 5 and 6 are replayed in order.
+  CHECK(!book.stale());
+  CHECK(book.bestBid().price.toString(2) == "101.00");
+  CHECK(book.bestAsk().price.toString(2) == "104.00");
+  CHECK(book.bestAsk().quantity.toString(0) == "3");
+  CHECK(std::none_of(deltas.begin(), deltas.end(), [](const auto& delta) {
+    return delta.previous_quantity > Decimal::fromRaw(0) && delta.quantity == Decimal::fromRaw(0) &&
+           delta.price == Decimal::fromString("101.00");
+  }));
+  const auto stats = book.stats();
+  CHECK(stats.resyncs == 1);
+  CHECK(stats.buffered_events == 0);
+  CHECK(stats.last_resync_ns == 4'000);
+  CHECK(stats.max_resync_ns == stats.last_resync_ns);
+
+  book.apply(makeCancel(5, 7));
+  CHECK(!book.stale());
+  CHECK(book.bestAsk().price.toString(2) == "105.00");
+}
+
+TEST_CASE("snapshot that leaves a hole before the buffered deltas keeps the book stale") {
+  hermeneutic::lob::LimitOrderBook book;
+  book.apply(makeNewOrder(1, Side::Bid, "100.00", "1", 1));
+  book.apply(makeNewOrder(2, Side::Bid, "101.00", "1", 5));
+  CHECK(book.stale());
+
+  BookEvent snapshot;
+  snapshot.exchange = "cex-1";
+  snapshot.kind = BookEventKind::Snapshot;
+  snapshot.sequence = 3;
+  snapshot.snapshot.bids.push_back({Decimal::fromString("99.00"), Decimal::fromString("1")});
+  book.apply(snapshot);
+  CHECK(book.stale());
+  CHECK(book.stats().sequence_gaps == 2);
+  CHECK(book.stats().buffered_events == 1);
+
+  snapshot.sequence = 4;
+  book.apply(snapshot);
+  CHECK(!book.stale());
+  CHECK(book.bestBid().price.toString(2) == "101.00");
+  CHECK(book.stats().resyncs == 2);
+}
@@ -0,0 +1,181 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+
+#include <spdlog/spdlog.h>
+
+#include "hermeneutic/cex_type1/feed_parser.hpp"
+#include "hermeneutic/lob/order_book.hpp"
+#include "hermeneutic/order_flow/generator.hpp"
+
+using hermeneutic::common::BookEvent;
+using hermeneutic::common::BookEventKind;
+using hermeneutic::order_flow::FlowOptions;
+using hermeneutic::order_flow::OrderFlowGenerator;
+
+namespace {
+
+// Feeds `events` generated events into a fresh book, with logging muted
+// since debug builds trace every apply.
+std::size_t restingAfter(OrderFlowGenerator& generator, int events) {
+  const auto level = spdlog::get_level();
+  spdlog::set_level(spdlog::level::off);
+  hermeneutic::lob::LimitOrderBook book;
+  BookEvent event;
+  generator.snapshot(event);
+  book.apply(event);
+  for (int i = 0; i < events; ++i) {
+    generator.next(event);
+    book.apply(event);
+  }
+  spdlog::set_level(level);
+  return book.stats().resting_orders;
+}
+
+}  // namespace
+
+TEST_CASE("order flow generator is deterministic per seed") {
+  FlowOptions options;
+  options.exchange = "flow-determinism";
+  OrderFlowGenerator first(options);
+  OrderFlowGenerator second(options);
+  options.seed = 2;
+  OrderFlowGenerator other(options);
+
+  BookEvent a;
+  BookEvent b;
+  BookEvent c;
+  bool diverged = false;
+  for (int i = 0; i < 1000; ++i) {
+    first.next(a);
+    second.next(b);
+    other.next(c);
+    CHECK(a.kind == b.kind);
+    CHECK(a.sequence == b.sequence);
+    CHECK(a.order.order_id == b.order.order_id);
+    CHECK(a.order.price == b.order.price);
+    CHECK(a.order.quantity == b.order.quantity);
+    diverged = diverged || a.kind != c.kind || a.order.price != c.order.price;
+  }
+  CHECK(diverged);
+  CHECK(first.midTicks() == second.midTicks());
+}
+
+TEST_CASE("order flow generator cancels only resting orders at the requested ratio") {
+  FlowOptions options;
+  options.exchange = "flow-cancels";
+  options.cancel_ratio = 0.3;
+  OrderFlowGenerator generator(options);
+
+  std::unordered_set<std::uint64_t> resting;
+  BookEvent event;
+  int cancels = 0;
+  constexpr int kEvents = 100'000;
+  for (int i = 0; i < kEvents; ++i) {
+    generator.next(event);
+    CHECK(event.sequence == static_cast<std::uint64_t>(i + 1));
+    if (event.kind == BookEventKind::CancelOrder) {
+      ++cancels;
+      CHECK(resting.erase(event.order.order_id) == 1);
+    } else {
+      CHECK(event.kind == BookEventKind::NewOrder);
+      CHECK(resting.insert(event.order.order_id).second);
+      CHECK(event.order.quantity.toString(0) != "0");
+    }
+  }
+  CHECK(resting.size() == generator.restingOrders());
+  const auto share = static_cast<double>(cancels) / kEvents;
+  CHECK(share > 0.27);
+  CHECK(share < 0.33);
+}
+
+TEST_CASE("order flow generator caps resting orders") {
+  FlowOptions options;
+  options.exchange = "flow-cap";
+  options.cancel_ratio = 0.0;
+  options.max_resting = 50;
+  OrderFlowGenerator generator(options);
+  BookEvent event;
+  for (int i = 0; i < 1000; ++i) {
+    generator.next(event);
+    CHECK(generator.restingOrders() <= 50);
+  }
+}
+
+TEST_CASE("order flow generator crosses the book only when asked") {
+  FlowOptions options;
+  options.exchange = "flow-cross";
+  options.walk_probability = 0.0;
+
+  // Every order lands in the book, so it holds exactly what the generator
+  // believes is resting.
+  OrderFlowGenerator uncrossed(options);
+  CHECK(restingAfter(uncrossed, 20'000) == uncrossed.restingOrders());
+
+  // The book rejects crossing orders, leaving the generator ahead.
+  options.cross_probability = 0.2;
+  OrderFlowGenerator crossing(options);
+  CHECK(restingAfter(crossing, 20'000) < crossing.restingOrders());
+}
+
+TEST_CASE("order flow generator rejects invalid options") {
+  const auto rejects = [](const FlowOptions& options) {
+    try {
+      OrderFlowGenerator generator(options);
+    } catch (const std::invalid_argument&) {
+      return true;
+    }
+    return false;
+  };
+  FlowOptions options;
+  options.depth = 0;
+  CHECK(rejects(options));
+  options = {};
+  options.cancel_ratio = 1.5;
+  CHECK(rejects(options));
+  options = {};
+  options.max_quantity = 0;
+  CHECK(rejects(options));
+  CHECK(!rejects(FlowOptions{}));
+}
+
+TEST_CASE("order flow NDJSON parses back into the same events") {
+  FlowOptions options;
+  options.exchange = "flow-ndjson";
+  options.depth = 3;
+  OrderFlowGenerator generator(options);
+  hermeneutic::cex_type1::FeedParser parser("flow-ndjson");
+
+  BookEvent event;
+  BookEvent parsed;
+  std::string line;
+  generator.snapshot(event);
+  hermeneutic::order_flow::appendNdjson(event, options.price_digits, line);
+  CHECK(line.back() == '\n');
+  CHECK(parser.parse(line, 0, parsed));
+  CHECK(parsed.kind == BookEventKind::Snapshot);
+  CHECK(parsed.snapshot.bids.size() == 3);
+  CHECK(parsed.snapshot.asks.size() == 3);
+  CHECK(parsed.snapshot.bids[0].price == event.snapshot.bids[0].price);
+  CHECK(parsed.snapshot.asks[2].price.toString(2) == "100.03");
+
+  for (int i = 0; i < 200; ++i) {
+    generator.next(event);
+    line.clear();
+    hermeneutic::order_flow::appendNdjson(event, options.price_digits, line);
+    INFO(line);
+    CHECK(parser.parse(line, 0, parsed));
+    CHECK(parsed.kind == event.kind);
+    CHECK(parsed.sequence == event.sequence);
+    CHECK(parsed.order.order_id == event.order.order_id);
+    if (event.kind == BookEventKind::NewOrder) {
+      CHECK(parsed.order.side == event.order.side);
+      CHECK(parsed.order.price == event.order.price);
+      CHECK(parsed.order.quantity == event.order.quantity);
+    }
+  }
+}
@@ -52,6 +52,28 @@ std::unique_ptr<grpc::Server> startServer(hermeneutic::aggregator::AggregatorGrp
   return server;
 }
 
+// An older server: StreamBookUpdates answers UNIMPLEMENTED and StreamBooks
+// closes straight away, so the client keeps reconnecting.
+class LegacyService final : public hermeneutic::grpc::AggregatorService::Service {
+ public:
+  grpc::Status StreamBooks(grpc::ServerContext*,
+                           const hermeneutic::grpc::SubscribeRequest*,
+                           grpc::ServerWriter<hermeneutic::grpc::AggregatedBook>*) override {
+    ++book_calls;
+    return grpc::Status::OK;
+  }
+
+  grpc::Status StreamBookUpdates(grpc::ServerContext*,
+                                 const hermeneutic::grpc::SubscribeRequest*,
+                                 grpc::ServerWriter<hermeneutic::grpc::BookUpdate>*) override {
+    ++update_calls;
+    return grpc::Status(grpc::StatusCode::UNIMPLEMENTED, "no StreamBookUpdates");
+  }
+
+  std::atomic<int> book_calls{0};
+  std::atomic<int> update_calls{0};
+};
+
 }  // namespace
 
 TEST_CASE("book stream client reconnects when server restarts") {
@@ -93,7 +115,7 @@ TEST_CASE("book stream client reconnects when server restarts") {
   std::this_thread::sleep_for(std::chrono::milliseconds(100));
 
   engine.push(makeNewOrder("s1", 1, Side::Bid, "100.00", "1", 1));
-  engine.push(makeNewOrder("s2", 2, Side::Ask, "101.00", "2", 2));
+  engine.push(makeNewOrder("s2", 2, Side::Ask, "101.00", "2", 1));
 
   {
     std::unique_lock<std::mutex> lock(mutex);
@@ -115,8 +137,8 @@ TEST_CASE("book stream client reconnects when server restarts") {
   }
   std::this_thread::sleep_for(std::chrono::milliseconds(150));
 
-  engine.push(makeNewOrder("s1", 3, Side::Bid, "102.00", "1", 3));
-  engine.push(makeNewOrder("s2", 4, Side::Ask, "103.00", "1", 4));
+  engine.push(makeNewOrder("s1", 3, Side::Bid, "102.00", "1", 2));
+  engine.push(makeNewOrder("s2", 4, Side::Ask, "103.00", "1", 2));
 
   {
     std::unique_lock<std::mutex> lock(mutex);
@@ -134,3 +156,30 @@ TEST_CASE("book stream client reconnects when server restarts") {
   REQUIRE(snapshots.size() >= 2);
   CHECK(snapshots.back().best_ask.price >= snapshots.front().best_ask.price);
 }
+
+TEST_CASE("book stream client retries StreamBookUpdates after falling back") {
+  LegacyService service;
+  grpc::ServerBuilder builder;
+  builder.RegisterService(&service);
+  auto server = builder.BuildAndStart();
+  REQUIRE(server != nullptr);
+
+  hermeneutic::services::BookStreamClient client(
+      [&]() -> std::shared_ptr<grpc::Channel> { return server->InProcessChannel(grpc::ChannelArguments{}); },
+      "",
+      "BTCUSDT",
+      [](const hermeneutic::common::AggregatedBookView&) {},
+      std::chrono::milliseconds(10));
+  client.start();
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (service.update_calls.load() < 3 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  client.stop();
+  server->Shutdown(std::chrono::system_clock::now());
+  server->Wait();
+
+  // Each reconnect asks for updates first and falls back once.
+  CHECK(service.update_calls.load() >= 3);
+  CHECK(service.book_calls.load() >= 2);
+}
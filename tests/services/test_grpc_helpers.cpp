@@ -1,11 +1,16 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <doctest/doctest.h>
 
+#include <stdexcept>
+
+#include "services/common/book_mirror.hpp"
 #include "services/common/grpc_helpers.hpp"
 
 using hermeneutic::common::AggregatedBookView;
 using hermeneutic::common::Decimal;
+using hermeneutic::services::BookMirror;
 using hermeneutic::services::grpc_helpers::FromDomain;
+using hermeneutic::services::grpc_helpers::FromDomainUpdate;
 using hermeneutic::services::grpc_helpers::ToDomain;
 
 TEST_CASE("grpc helpers round-trip depth levels") {
@@ -43,3 +48,115 @@ TEST_CASE("grpc helpers round-trip depth levels") {
   CHECK(round_trip.min_feed_timestamp_ns == view.min_feed_timestamp_ns);
   CHECK(round_trip.max_local_timestamp_ns == view.max_local_timestamp_ns);
 }
+
+TEST_CASE("grpc helpers round-trip the fixed-point encoding") {
+  AggregatedBookView view;
+  view.best_bid.price = Decimal::fromString("27123.45");
+  view.best_bid.quantity = Decimal::fromString("0.00000001");
+  view.best_ask.price = Decimal::fromString("27123.5");
+  view.best_ask.quantity = Decimal::fromString("12.5");
+  for (int i = 0; i < 500; ++i) {
+    view.bid_levels.push_back({view.best_bid.price - Decimal::fromInteger(i), Decimal::fromString("1.23456789")});
+    view.ask_levels.push_back({view.best_ask.price + Decimal::fromInteger(i), Decimal::fromString("9.87654321")});
+  }
+  view.exchange_count = 3;
+  view.publish_timestamp_ns = 1700000000123456789;
+  view.last_feed_timestamp_ns = 42;
+
+  const auto strings = FromDomain(view);
+  const auto fixed = FromDomain(view, hermeneutic::grpc::BOOK_ENCODING_FIXED_POINT);
+  CHECK(fixed.has_fixed());
+  CHECK(fixed.bid_levels_size() == 0);
+  CHECK(fixed.fixed().scale() == hermeneutic::services::grpc_helpers::kFixedPointScale);
+  CHECK(fixed.fixed().bid_levels_size() == 1000);
+  CHECK(fixed.ByteSizeLong() * 2 < strings.ByteSizeLong());
+
+  const auto from_strings = ToDomain(strings);
+  const auto from_fixed = ToDomain(fixed);
+  CHECK(from_fixed.best_bid.quantity.toString(8) == "0.00000001");
+  CHECK(from_fixed.best_ask.price == from_strings.best_ask.price);
+  CHECK(from_fixed.bid_levels.size() == view.bid_levels.size());
+  CHECK(from_fixed.ask_levels.size() == view.ask_levels.size());
+  for (std::size_t i = 0; i < view.bid_levels.size(); ++i) {
+    CAPTURE(i);
+    CHECK(from_fixed.bid_levels[i].price == from_strings.bid_levels[i].price);
+    CHECK(from_fixed.bid_levels[i].quantity == from_strings.bid_levels[i].quantity);
+    CHECK(from_fixed.ask_levels[i].price == from_strings.ask_levels[i].price);
+  }
+  CHECK(from_fixed.exchange_count == 3);
+  CHECK(from_fixed.publish_timestamp_ns == view.publish_timestamp_ns);
+  CHECK(from_fixed.last_feed_timestamp_ns == 42);
+}
+
+TEST_CASE("grpc helpers reject a fixed-point scale Decimal cannot hold") {
+  AggregatedBookView view;
+  view.bid_levels.push_back({Decimal::fromString("100.00"), Decimal::fromString("1")});
+  auto message = FromDomain(view, hermeneutic::grpc::BOOK_ENCODING_FIXED_POINT);
+  message.mutable_fixed()->set_scale(19);
+  bool threw = false;
+  try {
+    (void)ToDomain(message);
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  CHECK(threw);
+
+  hermeneutic::grpc::BookUpdate update;
+  update.set_snapshot(true);
+  *update.mutable_book() = message;
+  BookMirror mirror;
+  threw = false;
+  try {
+    mirror.apply(update);
+  } catch (const std::invalid_argument&) {
+    threw = true;
+  }
+  CHECK(threw);
+  CHECK(!mirror.synced());
+}
+
+TEST_CASE("grpc helpers stream level deltas into a book mirror") {
+  auto level = [](const char* price, const char* quantity) {
+    return hermeneutic::common::PriceLevel{Decimal::fromString(price), Decimal::fromString(quantity)};
+  };
+  AggregatedBookView first;
+  first.bid_levels = {level("100", "1"), level("99", "2"), level("98", "3")};
+  first.ask_levels = {level("101", "1"), level("102", "2")};
+  first.best_bid = {first.bid_levels.front().price, first.bid_levels.front().quantity};
+  first.best_ask = {first.ask_levels.front().price, first.ask_levels.front().quantity};
+  first.exchange_count = 2;
+  AggregatedBookView second = first;
+  second.bid_levels = {level("100.5", "4"), level("100", "1"), level("98", "5")};
+  second.ask_levels = {level("102", "2"), level("103", "1")};
+  second.best_bid = {second.bid_levels.front().price, second.bid_levels.front().quantity};
+  second.best_ask = {second.ask_levels.front().price, second.ask_levels.front().quantity};
+  second.last_feed_timestamp_ns = 77;
+
+  for (auto encoding : {hermeneutic::grpc::BOOK_ENCODING_DECIMAL_STRING, hermeneutic::grpc::BOOK_ENCODING_FIXED_POINT}) {
+    CAPTURE(encoding);
+    BookMirror mirror;
+    CHECK(mirror.apply(FromDomainUpdate(nullptr, first, 1, encoding)));
+    const auto update = FromDomainUpdate(&first, second, 2, encoding);
+    CHECK(!update.snapshot());
+    CHECK(update.book().bid_levels_size() == 0);
+    // +100.5, -99, ~98 on the bid side; -101, +103 on the ask side.
+    CHECK(update.deltas_size() == 5);
+    CHECK(mirror.apply(update));
+    const auto& view = mirror.view();
+    CHECK(view.bid_levels.size() == 3);
+    CHECK(view.bid_levels[0].price == Decimal::fromString("100.5"));
+    CHECK(view.bid_levels[2].quantity == Decimal::fromString("5"));
+    CHECK(view.ask_levels.size() == 2);
+    CHECK(view.ask_levels[1].price == Decimal::fromString("103"));
+    CHECK(view.best_bid.quantity == Decimal::fromString("4"));
+    CHECK(view.last_feed_timestamp_ns == 77);
+    CHECK(view.exchange_count == 2);
+
+    // A skipped sequence number loses sync until the next snapshot.
+    CHECK(!mirror.apply(FromDomainUpdate(&second, first, 4, encoding)));
+    CHECK(!mirror.synced());
+    CHECK(!mirror.apply(FromDomainUpdate(&second, first, 3, encoding)));
+    CHECK(mirror.apply(FromDomainUpdate(nullptr, first, 5, encoding)));
+    CHECK(mirror.view().bid_levels.size() == 3);
+  }
+}